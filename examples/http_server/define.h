@@ -1,4 +1,6 @@
 #pragma once
+#include <coio/io_context_pool.h>
+#include <coio/asyncio/file.h>
 #include <coio/net/tcp.h>
 
 #if COIO_OS_LINUX
@@ -17,4 +19,6 @@ namespace http {
     using tcp_socket = coio::tcp::socket<io_context::scheduler>;
     using tcp_acceptor = coio::tcp::acceptor<io_context::scheduler>;
     using tcp_resolver = coio::tcp::resolver<io_context::scheduler>;
+    using io_context_pool = coio::io_context_pool<io_context>;
+    using random_access_file = coio::random_access_file<io_context::scheduler>;
 }
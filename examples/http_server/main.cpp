@@ -1,7 +1,7 @@
 #include <filesystem>
 #include <coio/utils/signal_wait.h>
 #include "connection.h"
-#include "io_context_pool.h"
+#include "define.h"
 #include "router.h"
 #include "../common.h"
 
@@ -18,7 +18,29 @@ auto signal_watchdog(http::io_context_pool& pool) -> coio::inline_task<> {
     pool.stop();
 }
 
-auto start_server(http::io_context_pool& pool, coio::async_scope& scope, http::router& router) -> http::io_context::task<> try {
+#if COIO_OS_LINUX
+// every worker accepts on its own SO_REUSEPORT acceptor and serves the connection itself
+auto accept_loop(http::tcp_acceptor acceptor, coio::async_scope& scope, http::router& router) -> http::io_context::task<> try {
+    const auto scheduler = acceptor.get_io_scheduler();
+    while (true) {
+        http::tcp_socket socket = co_await acceptor.async_accept();
+        auto endpoint = socket.remote_endpoint();
+        scope.spawn_on(scheduler, http::connection(std::move(socket), endpoint, router));
+    }
+}
+catch (const std::exception& e) {
+    ::debug("acceptor error: {}", e.what());
+}
+
+auto start_server(http::io_context_pool& pool, coio::async_scope& scope, http::router& router) -> void {
+    auto acceptors = pool.make_acceptors<coio::tcp>({coio::ipv6_address::any(), port});
+    ::debug("server started at http://localhost:{}", port);
+    for (std::size_t i = 0; i < acceptors.size(); ++i) {
+        scope.spawn_on(pool.get_scheduler(i), accept_loop(std::move(acceptors[i]), scope, router));
+    }
+}
+#else
+auto accept_loop(http::io_context_pool& pool, coio::async_scope& scope, http::router& router) -> http::io_context::task<> try {
     http::tcp_acceptor acceptor(co_await coio::read_scheduler());
     acceptor.open(coio::tcp::v6());
     acceptor.set_option(http::tcp_acceptor::reuse_address(true));
@@ -44,12 +66,17 @@ catch (const std::exception& e) {
     ::debug("acceptor error: {}", e.what());
 }
 
+auto start_server(http::io_context_pool& pool, coio::async_scope& scope, http::router& router) -> void {
+    scope.spawn_on(pool.pick_scheduler(), accept_loop(pool, scope, router));
+}
+#endif
+
 auto main() -> int try {
     http::router router{HTTP_SERVER_STATIC_DIR};
     http::io_context_pool pool{4};
     coio::async_scope scope;
     scope.spawn(signal_watchdog(pool));
-    scope.spawn_on(pool.pick_scheduler(), start_server(pool, scope, router));
+    start_server(pool, scope, router);
     coio::this_thread::sync_wait(scope.join());
 }
 catch (const std::exception& e) {
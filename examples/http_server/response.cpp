@@ -1,3 +1,4 @@
+#include <optional>
 #include <string>
 #include <coio/asyncio/io.h>
 #include "response.h"
@@ -41,6 +42,15 @@ namespace http {
     }
 
     auto response::write_to(tcp_socket& socket) -> io_context::task<> {
+#if COIO_OS_LINUX
+        std::optional<random_access_file> body;
+        std::size_t body_size = 0;
+        if (not file.empty()) {
+            body.emplace(socket.get_io_scheduler(), file.c_str(), random_access_file::read_only);
+            body_size = body->size();
+            headers.emplace("Content-Length", std::to_string(body_size));
+        }
+#endif
         std::string line_and_headers;
         line_and_headers.reserve(512);
 
@@ -53,6 +63,13 @@ namespace http {
         line_and_headers += "\r\n";
         co_await (coio::async_write(socket, coio::as_bytes(line_and_headers)) | as_throwing);
 
+#if COIO_OS_LINUX
+        if (body) {
+            // straight from the page cache to the socket, never through a user buffer
+            co_await (coio::async_sendfile(socket, *body, 0, body_size) | as_throwing);
+            co_return;
+        }
+#endif
         co_await (coio::async_write(socket, content) | as_throwing);
     }
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <filesystem>
 #include <string>
 #include "request.h"
 #include "define.h"
@@ -28,6 +29,9 @@ namespace http {
         status_type status = ok;
         std::multimap<std::string, std::string, detail::ci_less> headers;
         std::span<const std::byte> content;
+#if COIO_OS_LINUX
+        std::filesystem::path file; // if set, the body: sent with `async_sendfile` instead of `content`
+#endif
 
         auto write_to(tcp_socket& socket) -> io_context::task<>;
 
@@ -31,6 +31,7 @@ namespace http {
     }
 
     router::router(std::filesystem::path static_dir) : static_dir_(std::move(static_dir)), mime_types_(init_mime_types()) {
+#if not COIO_OS_LINUX
         for (const auto& entry : std::filesystem::directory_iterator(static_dir_)) {
             if (!entry.is_regular_file()) continue;
             const auto& path = entry.path();
@@ -42,6 +43,7 @@ namespace http {
                 std::istreambuf_iterator<char>{}
             );
         }
+#endif
     }
 
     auto router::route(const request& req, response& res) const -> void {
@@ -68,9 +70,8 @@ namespace http {
     auto router::serve_home(const request& req, response& res) const -> void {
         std::filesystem::path index_file_path = static_dir_ / "index.html";
         res.status = response::ok;
-        res.content = coio::as_bytes(files_.at(index_file_path));
+        set_body(index_file_path, res);
         res.headers.emplace("Content-Type", "text/html; charset=utf-8");
-        res.headers.emplace("Content-Length", std::to_string(res.content.size()));
     }
 
     auto router::serve_static(const request& req, response& res) const -> bool {
@@ -97,12 +98,20 @@ namespace http {
         }
 
         res.status = response::ok;
-        res.content = coio::as_bytes(files_.at(file_path));
+        set_body(file_path, res);
         res.headers.emplace("Content-Type", get_content_type(file_path.extension().string()));
-        res.headers.emplace("Content-Length", std::to_string(res.content.size()));
         return true;
     }
 
+    auto router::set_body(const std::filesystem::path& path, response& res) const -> void {
+#if COIO_OS_LINUX
+        res.file = path; // `write_to` sends it with `async_sendfile`, and its size as Content-Length
+#else
+        res.content = coio::as_bytes(files_.at(path));
+        res.headers.emplace("Content-Length", std::to_string(res.content.size()));
+#endif
+    }
+
     auto router::get_content_type(const std::string& extension) const -> std::string {
         auto it = mime_types_.find(extension);
         if (it != mime_types_.end()) {
@@ -20,9 +20,12 @@ namespace http {
         auto serve_home(const request& req, response& res) const -> void;
         auto serve_static(const request& req, response& res) const -> bool;
         auto get_content_type(const std::string& extension) const -> std::string;
+        auto set_body(const std::filesystem::path& path, response& res) const -> void;
 
         std::filesystem::path static_dir_;
         std::unordered_map<std::string, std::string> mime_types_;
-        std::unordered_map<std::filesystem::path, std::vector<char>> files_;
+#if not COIO_OS_LINUX
+        std::unordered_map<std::filesystem::path, std::vector<char>> files_; // no sendfile: served from memory
+#endif
     };
 }
@@ -1,4 +1,5 @@
 #include <coio/core.h>
+#include <coio/io_context_pool.h>
 #include <coio/asyncio/io.h>
 #include <coio/net/socket.h>
 #include <coio/net/tcp.h>
@@ -16,65 +17,17 @@ using io_context = coio::iocp_context;
 using tcp_socket = coio::tcp::socket<io_context::scheduler>;
 using tcp_acceptor = coio::tcp::acceptor<io_context::scheduler>;
 
-class io_context_pool {
-public:
-    explicit io_context_pool(std::size_t count) {
-        COIO_ASSERT(count > 0);
-        io_contexts_.reserve(count);
-        work_guards_.reserve(count);
-        threads_.reserve(count);
-        for (std::size_t i = 0; i < count; ++i) {
-            work_guards_.emplace_back(*io_contexts_.emplace_back(std::make_unique<io_context>()));
-        }
-
-        for (std::size_t i = 0; i < count; ++i) {
-            threads_.emplace_back([this, i] {
-                ::debug("worker started");
-                io_contexts_[i]->run();
-                ::debug("worker finished");
-            });
-        }
-    }
-
-    io_context_pool(const io_context_pool&) = delete;
-
-    io_context_pool& operator= (const io_context_pool&) = delete;
-
-    ~io_context_pool() {
-        stop();
-        for (auto& thread : threads_) {
-            if (thread.joinable()) {
-                thread.join();
-            }
-        }
-    }
-
-    auto stop() -> void {
-        for (auto& ctx : io_contexts_) {
-            ctx->request_stop();
-        }
-        work_guards_.clear();
-    }
-
-    auto pick_scheduler() noexcept -> io_context::scheduler {
-        return io_contexts_[std::exchange(next_, (next_ + 1) % io_contexts_.size())]->get_scheduler();
-    }
-
-private:
-    std::size_t next_ = 0;
-    std::vector<std::unique_ptr<io_context>> io_contexts_;
-    std::vector<std::thread> threads_;
-    std::vector<coio::work_guard<io_context>> work_guards_;
-};
+using io_context_pool = coio::io_context_pool<io_context>;
 
 auto handle_connection(tcp_socket socket) -> io_context::task<> {
     auto remote_endpoint = socket.remote_endpoint();
     ::debug("new connection from [{}]", remote_endpoint);
     try {
-        char buffer[1024];
+        // borrowed from the worker's pool, and given back to it for the next connection
+        const auto buffer = coio::get_buffer_pool(socket.get_io_scheduler()).lease(1024);
         while (true) {
-            const auto length = co_await socket.async_read_some(coio::as_writable_bytes(buffer));
-            co_await (coio::async_write(socket, coio::as_bytes(buffer, length)) | as_throwing);
+            const auto length = co_await socket.async_read_some(buffer.bytes());
+            co_await (coio::async_write(socket, coio::as_bytes(buffer.data(), length)) | as_throwing);
         }
     }
     catch (const std::system_error& e) {
@@ -82,7 +35,27 @@ auto handle_connection(tcp_socket socket) -> io_context::task<> {
     }
 }
 
-auto start_server(io_context_pool& pool, coio::async_scope& scope) -> io_context::task<> try {
+#if COIO_OS_LINUX
+// every worker accepts on its own SO_REUSEPORT acceptor and serves the connection itself
+auto accept_loop(tcp_acceptor acceptor, coio::async_scope& scope) -> io_context::task<> try {
+    ::debug("worker accepting on \"{}\"...", acceptor.local_endpoint());
+    const auto scheduler = acceptor.get_io_scheduler();
+    while (true) {
+        scope.spawn_on(scheduler, handle_connection(co_await acceptor.async_accept()));
+    }
+}
+catch (const std::system_error& e) {
+    ::debug("acceptor error: {}", e.what());
+}
+
+auto start_server(io_context_pool& pool, coio::async_scope& scope) -> void {
+    auto acceptors = pool.make_acceptors<coio::tcp>(coio::endpoint{coio::ipv4_address::any(), 8086});
+    for (std::size_t i = 0; i < acceptors.size(); ++i) {
+        scope.spawn_on(pool.get_scheduler(i), accept_loop(std::move(acceptors[i]), scope));
+    }
+}
+#else
+auto accept_loop(io_context_pool& pool, coio::async_scope& scope) -> io_context::task<> try {
     tcp_acceptor acceptor{co_await coio::read_scheduler(), coio::endpoint{coio::ipv4_address::any(), 8086}};
     ::debug("server \"{}\" start...", acceptor.local_endpoint());
     while (true) {
@@ -94,6 +67,11 @@ catch (const std::system_error& e) {
     ::debug("acceptor error: {}", e.what());
 }
 
+auto start_server(io_context_pool& pool, coio::async_scope& scope) -> void {
+    scope.spawn_on(pool.pick_scheduler(), accept_loop(pool, scope));
+}
+#endif
+
 auto signal_watchdog(io_context_pool& pool) -> coio::inline_task<> {
     const int signum = co_await coio::signal_wait(SIGINT, SIGTERM);
     ::debug("server stop with signal: ({}){}", signum, coio::strsignal(signum));
@@ -104,6 +82,6 @@ auto main() -> int {
     io_context_pool pool{4};
     coio::async_scope scope;
     scope.spawn(signal_watchdog(pool));
-    scope.spawn_on(pool.pick_scheduler(), start_server(pool, scope));
+    start_server(pool, scope);
     coio::this_thread::sync_wait(scope.join());
 }
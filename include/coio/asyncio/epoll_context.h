@@ -4,10 +4,19 @@
 #if not COIO_HAS_EPOLL
 #error "uh, where is <sys/epoll.h>?"
 #endif
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <sys/socket.h>
 #include <coio/execution_context.h>
 #include <coio/utils/async_result.h>
 #include <coio/detail/io_descriptions.h>
+#include <coio/detail/intrusive_list.h>
+#include <coio/detail/iovec_buffers.h>
+#include <coio/detail/mmsg_batch.h>
 #include <coio/detail/object_pool.h>
 #include <coio/utils/atomutex.h>
 
@@ -55,13 +64,85 @@ namespace coio {
     private:
         class epoll_node;
 
+        /// one direction of an fd: the operation waiting for it, or whether an edge arrived while none did.
+        ///
+        /// Only the reactor thread moves an operation to `running`, every transition is a single CAS:
+        ///
+        /// [idle]     <-- reactor records an edge / initiator consumes it --> [ready]
+        /// [idle]      -- initiator arms op ----------------------------------> [armed]
+        /// [armed]     -- reactor claims op ---------------------------------> [running]
+        /// [armed]     -- canceller takes op, unless pinned -----------------> [idle] (canceller publishes)
+        /// [running]   -- op completed ----------------------------------------> [idle] (reactor publishes)
+        /// [running]   -- op would block -------------------------------------> [armed]
+        /// [running]   -- canceller, unless pinned -------------------------> [running + cancelled]
+        /// [running + cancelled] -- op completed -------------------------> [idle] (reactor publishes)
+        /// [running + cancelled] -- op would block, unless pinned ----> [idle] (reactor publishes)
+        class op_slot {
+        public:
+            op_slot() = default;
+
+            op_slot(const op_slot&) = delete;
+
+            auto operator= (const op_slot&) -> op_slot& = delete;
+
+            /// initiator. \return false if an edge was recorded instead: consume it and retry the I/O
+            [[nodiscard]]
+            auto arm(epoll_node* op, bool op_pinned) noexcept -> bool;
+
+            /// reactor, on an edge. \return the armed operation, now running, or null if the edge was recorded
+            [[nodiscard]]
+            auto claim() noexcept -> epoll_node*;
+
+            /// reactor, `op` completed
+            COIO_ALWAYS_INLINE auto release() noexcept -> void {
+                state_.store(idle, std::memory_order_release);
+            }
+
+            /// reactor, `op` would block. \return false if it was cancelled meanwhile: publish it
+            [[nodiscard]]
+            auto rearm(epoll_node* op, bool op_pinned) noexcept -> bool;
+
+            /// canceller. \return the armed operation, now taken, or null. `op` restricts it to that operation
+            [[nodiscard]]
+            auto take(epoll_node* op = nullptr) noexcept -> epoll_node*;
+
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto armed() const noexcept -> bool {
+                return state_.load(std::memory_order_relaxed) > ready;
+            }
+
+            COIO_ALWAYS_INLINE auto reset() noexcept -> void {
+                state_.store(idle, std::memory_order_relaxed);
+            }
+
+        private:
+            // an operation pointer, tagged in its low bits
+            static constexpr std::uintptr_t idle = 0;
+            static constexpr std::uintptr_t ready = 1; // without an operation
+            static constexpr std::uintptr_t running = 1;
+            static constexpr std::uintptr_t cancelled = 2;
+            static constexpr std::uintptr_t pinned = 4; // the operation can't be cancelled now
+            static constexpr std::uintptr_t tags = running | cancelled | pinned;
+
+            std::atomic<std::uintptr_t> state_{idle};
+        };
+
         struct per_fd_data {
-            atomutex fd_lock;
-            std::uint32_t events{};
-            std::uint32_t ready_events{};
-            epoll_node* in_op{nullptr};
-            epoll_node* out_op{nullptr};
+            atomutex fd_lock; // guards `events` growing, the only path that calls epoll_ctl
+            std::atomic<std::uint32_t> events{};
+            op_slot in_slot;
+            op_slot out_slot;
             per_fd_data* next_free{nullptr};
+            std::int8_t zerocopy{}; // SO_ZEROCOPY: 0 not tried yet, 1 enabled, -1 unavailable or not worth it
+            std::uint32_t zerocopy_sent{};     // MSG_ZEROCOPY sends issued, the kernel numbers them the same way
+            std::uint32_t zerocopy_released{}; // leading sends whose buffers the kernel has let go of
+            // regular files, which epoll can't wait on, run their operations on the file threads instead;
+            // the rest is guarded by the context's `file_mtx_`
+            bool offloaded{};
+            std::uint32_t file_queue_depth{}; // operations of the file handed to the threads at once, at most
+            std::uint32_t file_running{};     // handed to the threads now
+            bool file_draining{};             // `close` waits for `file_running` to drop to zero
+            detail::intrusive_list<node> file_backlog{&node::next_}; // waiting for one of those to complete
         };
 
         class epoll_node : public node {
@@ -79,13 +160,19 @@ namespace coio {
             [[nodiscard]]
             auto register_event(int event_type) noexcept -> register_result;
 
+            /// add `event_type` to the interest set of the descriptor. \return false on failure, with errno set
+            [[nodiscard]]
+            auto add_interest(int event_type) noexcept -> bool;
+
         private:
             virtual auto perform() noexcept -> bool = 0;
 
         protected:
             int fd;
             per_fd_data* data;
+            bool pinned = false; // the kernel still references the operation's buffer: it can't be cancelled now
         };
+        static_assert(alignof(epoll_node) >= 8, "op_slot keeps its tags in the low bits of the pointer");
 
     public:
         class scheduler : public scheduler_base {
@@ -166,6 +253,14 @@ namespace coio {
 
                 auto resize(std::size_t new_size) -> void;
 
+                /**
+                 * \brief limit how many operations of this regular file the file threads run at once; the others
+                 * wait, in order, for one of those to complete.
+                 * \param depth the limit, at least 1; the context's `options::file_queue_depth` until set.
+                 * \throw std::system_error if the object doesn't hold a regular file.
+                 */
+                auto set_queue_depth(std::size_t depth) -> void;
+
             private:
                 template<typename Tag, typename... Args>
                 [[nodiscard]]
@@ -188,6 +283,30 @@ namespace coio {
                     return async_initiate<detail::send_tag>(buffer);
                 }
 
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_receive(std::span<const std::span<std::byte>> buffers) noexcept {
+                    return async_initiate<detail::read_some_vectored_tag>(detail::iovec_buffers{buffers, not stream_oriented_}, stream_oriented_);
+                }
+
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_send(std::span<const std::span<const std::byte>> buffers) noexcept {
+                    return async_initiate<detail::send_vectored_tag>(detail::iovec_buffers{buffers, not stream_oriented_});
+                }
+
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_send_zc(std::span<const std::byte> buffer) noexcept {
+                    return async_initiate<detail::send_zc_tag>(buffer);
+                }
+
+                /**
+                 * \brief send up to `count` bytes of `file` starting at `offset` without copying them through user memory (`sendfile`).
+                 * \note the file's own position is neither used nor changed.
+                 */
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_sendfile(int file, std::size_t offset, std::size_t count) noexcept {
+                    return async_initiate<detail::sendfile_tag>(file, offset, count);
+                }
+
                 [[nodiscard]]
                 COIO_ALWAYS_INLINE auto async_receive_from(std::span<std::byte> buffer) noexcept {
                     return async_initiate<detail::receive_from_tag>(buffer);
@@ -198,6 +317,18 @@ namespace coio {
                     return async_initiate<detail::send_to_tag>(buffer, dest);
                 }
 
+                /// receive up to `mmsg_batch::max_count` datagrams into the leading `slots` (`recvmmsg`)
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_receive_many(std::span<datagram_receive_slot> slots) noexcept {
+                    return async_initiate<detail::receive_many_tag>(slots);
+                }
+
+                /// send up to `mmsg_batch::max_count` datagrams from the leading `slots` (`sendmmsg`)
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_send_many(std::span<const datagram_send_slot> slots) noexcept {
+                    return async_initiate<detail::send_many_tag>(slots);
+                }
+
                 [[nodiscard]]
                 COIO_ALWAYS_INLINE auto async_accept() noexcept {
                     return async_initiate<detail::accept_tag>();
@@ -218,6 +349,16 @@ namespace coio {
                     return async_initiate<detail::write_some_tag>(buffer);
                 }
 
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_read_some(std::span<const std::span<std::byte>> buffers) noexcept {
+                    return async_initiate<detail::read_some_vectored_tag>(detail::iovec_buffers{buffers}, true);
+                }
+
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_write_some(std::span<const std::span<const std::byte>> buffers) noexcept {
+                    return async_initiate<detail::write_some_vectored_tag>(detail::iovec_buffers{buffers});
+                }
+
                 [[nodiscard]]
                 COIO_ALWAYS_INLINE auto async_read_some_at(std::size_t offset, std::span<std::byte> buffer) noexcept {
                     return async_initiate<detail::read_some_at_tag>(offset, buffer);
@@ -228,6 +369,32 @@ namespace coio {
                     return async_initiate<detail::write_some_at_tag>(offset, buffer);
                 }
 
+                /**
+                 * \brief flush the file's data and metadata to the storage device (`fsync`, on a file thread).
+                 */
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_sync_all() noexcept {
+                    return async_initiate<detail::sync_tag>(false);
+                }
+
+                /**
+                 * \brief flush the file's data, and only the metadata needed to read it back, to the storage device
+                 * (`fdatasync`, on a file thread).
+                 */
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_sync_data() noexcept {
+                    return async_initiate<detail::sync_tag>(true);
+                }
+
+                /**
+                 * \brief allocate disk space for `length` bytes of the file from `offset` (`fallocate`, on a file thread).
+                 * \param mode the `FALLOC_FL_*` flags, e.g. `FALLOC_FL_KEEP_SIZE` to leave the file size alone.
+                 */
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_allocate(std::size_t offset, std::size_t length, int mode = 0) noexcept {
+                    return async_initiate<detail::allocate_tag>(offset, length, mode);
+                }
+
             private:
                 epoll_context* ctx_;
                 int fd_ = -1;
@@ -308,9 +475,19 @@ namespace coio {
         template<typename T = void, typename Alloc = std::allocator<std::byte>>
         using task = coio::task<T, Alloc, scheduler>;
 
+        struct options {
+            /// the most threads running blocking file operations, started as the operations need them.
+            std::size_t file_threads = 4;
+
+            /// the most operations of one regular file handed to the file threads at once, see `io_object::set_queue_depth`.
+            std::size_t file_queue_depth = 4;
+        };
+
     public:
         explicit epoll_context(std::pmr::memory_resource& memory_resource = *std::pmr::get_default_resource());
 
+        explicit epoll_context(const options& opts, std::pmr::memory_resource& memory_resource = *std::pmr::get_default_resource());
+
         ~epoll_context();
 
     private:
@@ -327,12 +504,46 @@ namespace coio {
 
         auto cancel_op(int event, epoll_node* op) -> void;
 
+        // consumer-only; false if the timer couldn't be armed, the caller then falls back to an `epoll_wait` timeout
+        auto arm_timer(std::chrono::steady_clock::time_point deadline) noexcept -> bool;
+
+        // false if there is no file thread to run `op`, and none could be started
+        [[nodiscard]]
+        auto submit_file_op(epoll_node& op) noexcept -> bool;
+
+        // `op` completes as stopped unless a file thread already runs it
+        auto cancel_file_op(epoll_node* op) -> void;
+
+        auto cancel_file_ops(per_fd_data* data) -> void;
+
+        auto set_file_queue_depth(per_fd_data* data, std::uint32_t depth) -> void;
+
+        // hand the next operation waiting on `data` to the threads, if its queue depth allows it; under `file_mtx_`
+        auto admit_file_backlog(per_fd_data* data) noexcept -> bool;
+
+        auto run_file_thread() noexcept -> void;
+
     private:
         // entries are recycled, never freed while the context lives, so straggling
         // references (fetched event batches, stop callbacks) cannot dangle
         detail::object_pool<per_fd_data, &per_fd_data::next_free, std::pmr::polymorphic_allocator<>> data_pool_;
         detail::reactor_interrupter interrupter_;
         int epoll_fd_;
+        // wakes the consumer at the earliest timer with nanosecond precision, `epoll_wait` only counts milliseconds;
+        // -1 if unavailable
+        int timer_fd_ = -1;
+        std::chrono::steady_clock::time_point timer_armed_ = std::chrono::steady_clock::time_point::max(); // consumer-only
+        // blocking file I/O
+        std::size_t file_thread_limit_;
+        std::uint32_t file_queue_depth_;
+        std::mutex file_mtx_;
+        std::condition_variable file_cv_;
+        std::condition_variable file_drained_cv_; // a closing file's last running operation completed
+        detail::intrusive_list<node> file_queue_{&node::next_}; // admitted, waiting for a thread
+        std::size_t file_queued_ = 0;
+        std::size_t file_idle_ = 0;
+        bool file_stopping_ = false;
+        std::vector<std::thread> file_threads_;
     };
 
     namespace detail {
@@ -344,6 +555,13 @@ namespace coio {
                 epoll_node(context, fd, data) {}
 
         protected:
+            /// hand the operation of a regular file to the file threads, which run `perform` to completion
+            auto offload() noexcept -> start_result {
+                if (this->context_.submit_file_op(*this)) return start_result::pending;
+                result.set_error(std::make_error_code(std::errc::resource_unavailable_try_again));
+                return start_result::completed;
+            }
+
             async_result<typename Tag::value_signature, execution::set_error_t(std::error_code)> result;
         };
 
@@ -413,6 +631,50 @@ namespace coio {
         };
 
 
+        /// async_read_some (scatter), async_receive (scatter)
+        template<>
+        class epoll_state_base_for<read_some_vectored_tag> : public epoll_node_for<read_some_vectored_tag> {
+        public:
+            epoll_state_base_for(int fd, epoll_context& context, epoll_context::per_fd_data* data, const iovec_buffers& buffers, bool eof_on_zero) noexcept :
+                epoll_node_for(fd, context, data),
+                buffers_(buffers),
+                eof_on_zero_(eof_on_zero) {}
+
+        protected:
+            auto do_start() noexcept -> start_result;
+
+            auto do_cancel() -> void;
+
+        private:
+            auto perform() noexcept -> bool override;
+
+        private:
+            iovec_buffers buffers_;
+            bool eof_on_zero_; // false for datagrams, where an empty one is a valid message
+        };
+
+
+        /// async_write_some (gather)
+        template<>
+        class epoll_state_base_for<write_some_vectored_tag> : public epoll_node_for<write_some_vectored_tag> {
+        public:
+            epoll_state_base_for(int fd, epoll_context& context, epoll_context::per_fd_data* data, const iovec_buffers& buffers) noexcept :
+                epoll_node_for(fd, context, data),
+                buffers_(buffers) {}
+
+        protected:
+            auto do_start() noexcept -> start_result;
+
+            auto do_cancel() -> void;
+
+        private:
+            auto perform() noexcept -> bool override;
+
+        private:
+            iovec_buffers buffers_;
+        };
+
+
         /// async_receive
         template<>
         class epoll_state_base_for<receive_tag> : public epoll_node_for<receive_tag> {
@@ -456,6 +718,85 @@ namespace coio {
         };
 
 
+        /// async_send (gather)
+        template<>
+        class epoll_state_base_for<send_vectored_tag> : public epoll_node_for<send_vectored_tag> {
+        public:
+            epoll_state_base_for(int fd, epoll_context& context, epoll_context::per_fd_data* data, const iovec_buffers& buffers) noexcept :
+                epoll_node_for(fd, context, data),
+                buffers_(buffers) {}
+
+        protected:
+            auto do_start() noexcept -> start_result;
+
+            auto do_cancel() -> void;
+
+        private:
+            auto perform() noexcept -> bool override;
+
+            auto send() noexcept -> ::ssize_t;
+
+        private:
+            iovec_buffers buffers_;
+        };
+
+
+        /// async_send_zc
+        template<>
+        class epoll_state_base_for<send_zc_tag> : public epoll_node_for<send_zc_tag> {
+        public:
+            epoll_state_base_for(int fd, epoll_context& context, epoll_context::per_fd_data* data, std::span<const std::byte> buffer) noexcept :
+                epoll_node_for(fd, context, data),
+                buffer_(buffer) {}
+
+        protected:
+            auto do_start() noexcept -> start_result;
+
+            auto do_cancel() -> void;
+
+        private:
+            auto perform() noexcept -> bool override;
+
+            auto send() noexcept -> ::ssize_t;
+
+            auto released() noexcept -> bool;
+
+        private:
+            std::span<const std::byte> buffer_;
+            std::size_t sent_ = 0;
+            std::uint32_t id_ = 0;
+        };
+
+
+        /// async_sendfile
+        template<>
+        class epoll_state_base_for<sendfile_tag> : public epoll_node_for<sendfile_tag> {
+        public:
+            epoll_state_base_for(int fd, epoll_context& context, epoll_context::per_fd_data* data, int file, std::size_t offset, std::size_t count) noexcept :
+                epoll_node_for(fd, context, data),
+                file_(file),
+                offset_(offset),
+                count_(count) {}
+
+        protected:
+            auto do_start() noexcept -> start_result;
+
+            auto do_cancel() -> void;
+
+        private:
+            auto perform() noexcept -> bool override;
+
+            auto send() noexcept -> ::ssize_t;
+
+            auto set_result(::ssize_t n) noexcept -> void;
+
+        private:
+            int file_;
+            std::size_t offset_;
+            std::size_t count_;
+        };
+
+
         /// async_receive_from
         template<>
         class epoll_state_base_for<receive_from_tag> : public epoll_node_for<receive_from_tag> {
@@ -502,6 +843,146 @@ namespace coio {
         };
 
 
+        /// async_receive_many
+        template<>
+        class epoll_state_base_for<receive_many_tag> : public epoll_node_for<receive_many_tag> {
+        public:
+            epoll_state_base_for(int fd, epoll_context& context, epoll_context::per_fd_data* data, std::span<datagram_receive_slot> slots) noexcept :
+                epoll_node_for(fd, context, data),
+                slots_(slots),
+                batch_(slots) {}
+
+        protected:
+            auto do_start() noexcept -> start_result;
+
+            auto do_cancel() -> void;
+
+        private:
+            auto perform() noexcept -> bool override;
+
+            auto receive() noexcept -> int;
+
+        private:
+            std::span<datagram_receive_slot> slots_;
+            mmsg_batch batch_;
+        };
+
+
+        /// async_send_many
+        template<>
+        class epoll_state_base_for<send_many_tag> : public epoll_node_for<send_many_tag> {
+        public:
+            epoll_state_base_for(int fd, epoll_context& context, epoll_context::per_fd_data* data, std::span<const datagram_send_slot> slots) noexcept :
+                epoll_node_for(fd, context, data),
+                batch_(slots) {}
+
+        protected:
+            auto do_start() noexcept -> start_result;
+
+            auto do_cancel() -> void;
+
+        private:
+            auto perform() noexcept -> bool override;
+
+            auto send() noexcept -> int;
+
+        private:
+            mmsg_batch batch_;
+        };
+
+
+        /// async_read_some_at
+        template<>
+        class epoll_state_base_for<read_some_at_tag> : public epoll_node_for<read_some_at_tag> {
+        public:
+            epoll_state_base_for(int fd, epoll_context& context, epoll_context::per_fd_data* data, std::size_t offset, std::span<std::byte> buffer) noexcept :
+                epoll_node_for(fd, context, data),
+                offset_(offset),
+                buffer_(buffer) {}
+
+        protected:
+            auto do_start() noexcept -> start_result;
+
+            auto do_cancel() -> void;
+
+        private:
+            auto perform() noexcept -> bool override;
+
+        private:
+            std::size_t offset_;
+            std::span<std::byte> buffer_;
+        };
+
+
+        /// async_write_some_at
+        template<>
+        class epoll_state_base_for<write_some_at_tag> : public epoll_node_for<write_some_at_tag> {
+        public:
+            epoll_state_base_for(int fd, epoll_context& context, epoll_context::per_fd_data* data, std::size_t offset, std::span<const std::byte> buffer) noexcept :
+                epoll_node_for(fd, context, data),
+                offset_(offset),
+                buffer_(buffer) {}
+
+        protected:
+            auto do_start() noexcept -> start_result;
+
+            auto do_cancel() -> void;
+
+        private:
+            auto perform() noexcept -> bool override;
+
+        private:
+            std::size_t offset_;
+            std::span<const std::byte> buffer_;
+        };
+
+
+        /// async_sync_all, async_sync_data
+        template<>
+        class epoll_state_base_for<sync_tag> : public epoll_node_for<sync_tag> {
+        public:
+            epoll_state_base_for(int fd, epoll_context& context, epoll_context::per_fd_data* data, bool data_only) noexcept :
+                epoll_node_for(fd, context, data),
+                data_only_(data_only) {}
+
+        protected:
+            auto do_start() noexcept -> start_result;
+
+            auto do_cancel() -> void;
+
+        private:
+            auto perform() noexcept -> bool override;
+
+        private:
+            bool data_only_;
+        };
+
+
+        /// async_allocate
+        template<>
+        class epoll_state_base_for<allocate_tag> : public epoll_node_for<allocate_tag> {
+        public:
+            epoll_state_base_for(int fd, epoll_context& context, epoll_context::per_fd_data* data, std::size_t offset, std::size_t length, int mode) noexcept :
+                epoll_node_for(fd, context, data),
+                offset_(offset),
+                length_(length),
+                mode_(mode) {}
+
+        protected:
+            auto do_start() noexcept -> start_result;
+
+            auto do_cancel() -> void;
+
+        private:
+            auto perform() noexcept -> bool override;
+
+        private:
+            std::size_t offset_;
+            std::size_t length_;
+            int mode_;
+        };
+
+
         /// async_accept
         template<>
         class epoll_state_base_for<accept_tag> : public epoll_node_for<accept_tag> {
@@ -2,6 +2,7 @@
 #include <filesystem>
 #include <utility>
 #include <coio/core.h>
+#include <coio/utils/aligned_buffer.h>
 #include <coio/utils/async_result.h>
 #include <coio/detail/error.h>
 #include <coio/detail/io_descriptions.h>
@@ -32,7 +33,8 @@ namespace coio {
             create = 16,             ///< Create file if it doesn't exist
             exclusive = 32,          ///< Ensure creation of a new file (fails if file exists)
             truncate = 64,           ///< Truncate existing file to zero length
-            sync_all_on_write = 128  ///< Synchronize all writes to disk immediately
+            sync_all_on_write = 128, ///< Synchronize all writes to disk immediately
+            direct = 256             ///< Bypass the page cache; buffers, offsets and sizes must be aligned, see `direct_io_alignment`
         };
 
         COIO_ALWAYS_INLINE constexpr auto operator| (open_mode lhs, open_mode rhs) noexcept -> open_mode {
@@ -65,6 +67,23 @@ namespace coio {
          */
         auto open_file(zstring_view path, open_mode mode, bool random_access) -> file_native_handle_type;
 
+#if COIO_OS_LINUX
+        /**
+         * \brief Get the flags `open_file` passes to `open(2)` for a mode.
+         * \param mode The mode in which to open the file.
+         * \return The `O_*` flags.
+         */
+        auto native_open_flags(open_mode mode) noexcept -> int;
+#endif
+
+        /**
+         * \brief Get the alignment direct I/O on a file requires.
+         * \param handle The native file handle.
+         * \return The alignment of buffer addresses, file offsets and transfer sizes, a power of two.
+         * \throw std::system_error on failure.
+         */
+        auto file_direct_io_alignment(file_native_handle_type handle) -> std::size_t;
+
         /**
          * \brief Get the size of a file.
          * \param handle The native file handle.
@@ -131,6 +150,20 @@ namespace coio {
                 impl_.close();
             }
 
+            /**
+             * \brief Asynchronously close the file.
+             *
+             * The file lets go of its handle when the returned sender is started, and the handle is closed
+             * by the operation, which ignores stop requests. The file must stay in place until then; a sender
+             * destroyed without being started leaves the file open. Only available on schedulers closing files
+             * asynchronously (e.g. `uring_context::scheduler`).
+             * \return a sender of `void`.
+             */
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto async_close() requires requires (implementation_type& impl) { impl.async_close(); } {
+                return impl_.async_close();
+            }
+
             /**
              * \brief Cancel all asynchronous operations associated with the file.
              *
@@ -141,6 +174,44 @@ namespace coio {
                 impl_.cancel();
             }
 
+            /**
+             * \brief Install the file into the scheduler's registered file table.
+             *
+             * Subsequent asynchronous operations refer to the file by its table slot, which skips
+             * the kernel's per-operation file lookup. Only available on schedulers with a
+             * registered file table (e.g. `uring_context::scheduler`).
+             * \throw std::system_error on failure.
+             */
+            COIO_ALWAYS_INLINE auto register_file() -> void requires requires (implementation_type& impl) { impl.register_file(); } {
+                impl_.register_file();
+            }
+
+            /**
+             * \brief Limit how many asynchronous operations of the file run at once.
+             *
+             * The others wait, in the order they were started, for one of those to complete; a depth of 1 thus
+             * runs them one after another. Only available on schedulers running file operations on a thread
+             * pool (e.g. `epoll_context::scheduler`).
+             * \param depth The limit, at least 1.
+             * \throw std::system_error if the file isn't open.
+             */
+            COIO_ALWAYS_INLINE auto set_queue_depth(std::size_t depth) -> void requires requires (implementation_type& impl) { impl.set_queue_depth(depth); } {
+                impl_.set_queue_depth(depth);
+            }
+
+            /**
+             * \brief Get the alignment direct I/O on the file requires.
+             *
+             * With `open_mode::direct`, the address and size of every buffer, and every file offset, must be a
+             * multiple of it; `aligned_buffer` allocates such buffers.
+             * \return The alignment, a power of two.
+             * \throw std::system_error on failure.
+             */
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto direct_io_alignment() const -> std::size_t {
+                return detail::file_direct_io_alignment(native_handle());
+            }
+
             /**
              * \brief Get the native file handle.
              * \return The native file handle.
@@ -204,6 +275,17 @@ namespace coio {
                 return this->impl_.async_read_some(buffer);
             }
 
+            /**
+             * \brief asynchronously read some data, scattering it over several buffers (`readv`).
+             * \param buffers the buffers to read into, in order; only the first 16 non-empty ones take part in one operation.
+             * \return a sender of `std::size_t`.
+             */
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto async_read_some(std::span<const std::span<std::byte>> buffers)
+                requires requires { this->impl_.async_read_some(buffers); } {
+                return this->impl_.async_read_some(buffers);
+            }
+
             /**
              * \brief Write some data to the file.
              *
@@ -226,6 +308,17 @@ namespace coio {
             COIO_ALWAYS_INLINE auto async_write_some(std::span<const std::byte> buffer) {
                 return this->impl_.async_write_some(buffer);
             }
+
+            /**
+             * \brief asynchronously write some data, gathering it from several buffers (`writev`).
+             * \param buffers the buffers to write from, in order; only the first 16 non-empty ones take part in one operation.
+             * \return a sender of `std::size_t`.
+             */
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto async_write_some(std::span<const std::span<const std::byte>> buffers)
+                requires requires { this->impl_.async_write_some(buffers); } {
+                return this->impl_.async_write_some(buffers);
+            }
         };
 
         template<io_scheduler IoScheduler>
@@ -344,6 +437,7 @@ namespace coio {
          *   - exclusive: Ensure creation of a new file
          *   - truncate: Truncate existing file to zero length
          *   - sync_all_on_write: Synchronize all writes to disk
+         *   - direct: Bypass the page cache
          * \throw std::system_error if the file is already open or on failure.
          */
         COIO_ALWAYS_INLINE auto open(zstring_view path, detail::open_mode mode) -> void {
@@ -351,6 +445,24 @@ namespace coio {
             this->impl_ = this->get_io_scheduler().make_io_object(detail::open_file(path, mode, false));
         }
 
+        /**
+         * \brief Asynchronously open the file at the specified path, without blocking the scheduler's thread.
+         *
+         * Only available on schedulers opening files asynchronously (e.g. `uring_context::scheduler`).
+         * \param path The path of the file to open; it must stay valid until the returned sender completes.
+         * \param mode The mode in which to open the file, as for `open`.
+         * \return a sender of `void`.
+         * \throw std::system_error if the file is already open.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_open(zstring_view path, detail::open_mode mode)
+            requires requires (IoScheduler scheduler) { scheduler.async_open(path, mode, false); } {
+            if (this->is_open()) throw std::system_error{error::already_open, "async_open"};
+            return this->get_io_scheduler().async_open(path, mode, false) | then([this](detail::file_native_handle_type handle) {
+                this->impl_ = this->get_io_scheduler().make_io_object(handle);
+            });
+        }
+
         /**
          * \brief Resize the file to a specified size.
          * \param new_size The new size of the file in bytes.
@@ -360,6 +472,21 @@ namespace coio {
             this->impl_.resize(new_size);
         }
 
+        /**
+         * \brief Asynchronously allocate disk space for a range of the file (`fallocate`).
+         *
+         * The file grows if the range runs past its end. Only available on schedulers allocating
+         * asynchronously (`uring_context::scheduler`, `epoll_context::scheduler`).
+         * \param offset The start of the range.
+         * \param length The length of the range.
+         * \return a sender of `void`.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_allocate(std::size_t offset, std::size_t length)
+            requires requires { this->impl_.async_allocate(offset, length); } {
+            return this->impl_.async_allocate(offset, length);
+        }
+
         /**
          * \brief Get the current size of the file.
          * \return The size of the file in bytes.
@@ -405,6 +532,31 @@ namespace coio {
         COIO_ALWAYS_INLINE auto sync_data() -> void {
             detail::file_sync_data(this->native_handle());
         }
+
+        /**
+         * \brief Asynchronously synchronize the file data and metadata with the storage device.
+         *
+         * Unlike `sync_all`, the scheduler's thread goes on running other work meanwhile. Only available on
+         * schedulers synchronizing asynchronously (`uring_context::scheduler`, `epoll_context::scheduler`).
+         * \return a sender of `void`.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_sync_all() requires requires { this->impl_.async_sync_all(); } {
+            return this->impl_.async_sync_all();
+        }
+
+        /**
+         * \brief Asynchronously synchronize the file data with the storage device.
+         *
+         * Unlike `sync_data`, the scheduler's thread goes on running other work meanwhile. Metadata changes
+         * may not be synchronized. Only available on schedulers synchronizing asynchronously
+         * (`uring_context::scheduler`, `epoll_context::scheduler`).
+         * \return a sender of `void`.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_sync_data() requires requires { this->impl_.async_sync_data(); } {
+            return this->impl_.async_sync_data();
+        }
     };
 
     /**
@@ -461,6 +613,7 @@ namespace coio {
          *   - exclusive: Ensure creation of a new file
          *   - truncate: Truncate existing file to zero length
          *   - sync_all_on_write: Synchronize all writes to disk
+         *   - direct: Bypass the page cache
          * \throw std::system_error if the file is already open or on failure.
          */
         COIO_ALWAYS_INLINE auto open(zstring_view path, detail::open_mode mode) -> void {
@@ -468,6 +621,24 @@ namespace coio {
             this->impl_ = this->get_io_scheduler().make_io_object(detail::open_file(path, mode, true));
         }
 
+        /**
+         * \brief Asynchronously open the file at the specified path, without blocking the scheduler's thread.
+         *
+         * Only available on schedulers opening files asynchronously (e.g. `uring_context::scheduler`).
+         * \param path The path of the file to open; it must stay valid until the returned sender completes.
+         * \param mode The mode in which to open the file, as for `open`.
+         * \return a sender of `void`.
+         * \throw std::system_error if the file is already open.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_open(zstring_view path, detail::open_mode mode)
+            requires requires (IoScheduler scheduler) { scheduler.async_open(path, mode, true); } {
+            if (this->is_open()) throw std::system_error{error::already_open, "async_open"};
+            return this->get_io_scheduler().async_open(path, mode, true) | then([this](detail::file_native_handle_type handle) {
+                this->impl_ = this->get_io_scheduler().make_io_object(handle);
+            });
+        }
+
         /**
          * \brief Resize the file to a specified size.
          * \param new_size The new size of the file in bytes.
@@ -477,6 +648,21 @@ namespace coio {
             this->impl_.resize(new_size);
         }
 
+        /**
+         * \brief Asynchronously allocate disk space for a range of the file (`fallocate`).
+         *
+         * The file grows if the range runs past its end. Only available on schedulers allocating
+         * asynchronously (`uring_context::scheduler`, `epoll_context::scheduler`).
+         * \param offset The start of the range.
+         * \param length The length of the range.
+         * \return a sender of `void`.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_allocate(std::size_t offset, std::size_t length)
+            requires requires { this->impl_.async_allocate(offset, length); } {
+            return this->impl_.async_allocate(offset, length);
+        }
+
         /**
          * \brief Get the current size of the file.
          * \return The size of the file in bytes.
@@ -508,5 +694,30 @@ namespace coio {
         COIO_ALWAYS_INLINE auto sync_data() -> void {
             detail::file_sync_data(this->native_handle());
         }
+
+        /**
+         * \brief Asynchronously synchronize the file data and metadata with the storage device.
+         *
+         * Unlike `sync_all`, the scheduler's thread goes on running other work meanwhile. Only available on
+         * schedulers synchronizing asynchronously (`uring_context::scheduler`, `epoll_context::scheduler`).
+         * \return a sender of `void`.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_sync_all() requires requires { this->impl_.async_sync_all(); } {
+            return this->impl_.async_sync_all();
+        }
+
+        /**
+         * \brief Asynchronously synchronize the file data with the storage device.
+         *
+         * Unlike `sync_data`, the scheduler's thread goes on running other work meanwhile. Metadata changes
+         * may not be synchronized. Only available on schedulers synchronizing asynchronously
+         * (`uring_context::scheduler`, `epoll_context::scheduler`).
+         * \return a sender of `void`.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_sync_data() requires requires { this->impl_.async_sync_data(); } {
+            return this->impl_.async_sync_data();
+        }
     };
 }
@@ -1,11 +1,15 @@
 ﻿// ReSharper disable CppRedundantTypenameKeyword
 #pragma once
 #include <algorithm>
+#include <array>
+#include <functional>
 #include <span>
 #include <stop_token>  // IWYU pragma: keep
 #include <string_view>
 #include <coio/utils/async_result.h>
+#include <coio/utils/delimiter_matcher.h>
 #include <coio/core.h>
+#include <coio/detail/byte_search.h>
 #include <coio/detail/error.h> //  IWYU pragma: keep
 
 namespace coio {
@@ -45,6 +49,21 @@ namespace coio {
         { t.async_write_some(buffer) } -> execution::sender;
     };
 
+    template<typename T>
+    concept async_scatter_input_stream_device = async_input_stream_device<T> and requires (T t, std::span<const std::span<std::byte>> buffers) {
+        { t.async_read_some(buffers) } -> execution::sender;
+    };
+
+    template<typename T>
+    concept async_gather_output_stream_device = async_output_stream_device<T> and requires (T t, std::span<const std::span<const std::byte>> buffers) {
+        { t.async_write_some(buffers) } -> execution::sender;
+    };
+
+    template<typename T, typename FileHandle>
+    concept async_sendfile_device = requires (T t, FileHandle file, std::size_t offset, std::size_t count) {
+        { t.async_sendfile_some(file, offset, count) } -> execution::sender;
+    };
+
     template<typename T>
     concept async_input_random_access_device = requires (T t, std::size_t offset, std::span<std::byte> buffer) {
         { t.async_read_some_at(offset, buffer) } -> execution::sender;
@@ -72,7 +91,44 @@ namespace coio {
         t.consume(n);
     };
 
+    template<typename T>
+    concept segmented_dynamic_buffer = requires (T t, const T& ct, std::size_t n) {
+        { ct.size() } -> std::integral;
+        { ct.capacity() } -> std::integral;
+        { ct.max_size() } -> std::integral;
+        { ct.data() } -> std::convertible_to<std::span<const std::span<const std::byte>>>;
+        { t.prepare(n) } -> std::convertible_to<std::span<const std::span<std::byte>>>;
+        t.commit(n);
+        t.consume(n);
+    };
+
     namespace detail {
+        template<typename T>
+        concept any_dynamic_buffer = dynamic_buffer<T> or segmented_dynamic_buffer<T>;
+
+        // sync devices have no scatter reads: a segmented buffer is read into one block at a time
+        COIO_ALWAYS_INLINE auto read_some_into(input_stream_device auto& device, std::span<std::byte> buffer) {
+            return device.read_some(buffer);
+        }
+
+        COIO_ALWAYS_INLINE auto read_some_into(input_stream_device auto& device, std::span<const std::span<std::byte>> buffers) {
+            return device.read_some(buffers.front());
+        }
+
+        COIO_ALWAYS_INLINE auto async_read_some_into(async_input_stream_device auto& device, std::span<std::byte> buffer) {
+            return device.async_read_some(buffer);
+        }
+
+        template<async_input_stream_device Device>
+        COIO_ALWAYS_INLINE auto async_read_some_into(Device& device, std::span<const std::span<std::byte>> buffers) {
+            if constexpr (async_scatter_input_stream_device<Device>) {
+                return device.async_read_some(buffers);
+            }
+            else {
+                return device.async_read_some(buffers.front());
+            }
+        }
+
         struct read_t {
             COIO_STATIC_CALL_OP auto operator() (
                 input_stream_device auto& device,
@@ -186,72 +242,137 @@ namespace coio {
             }
         };
 
+        COIO_ALWAYS_INLINE constexpr auto delimiter_empty(char) noexcept -> bool {
+            return false;
+        }
+
+        COIO_ALWAYS_INLINE constexpr auto delimiter_empty(std::string_view delim) noexcept -> bool {
+            return delim.empty();
+        }
+
+        COIO_ALWAYS_INLINE auto delimiter_empty(const delimiter_matcher& delim) noexcept -> bool {
+            return delim.empty();
+        }
+
+        // Search the readable data for the delimiter, resuming where the previous search of the same buffer
+        // stopped; return the count up to and including the delimiter, or 0 if it isn't there yet.
+        COIO_ALWAYS_INLINE auto search_delimiter(std::span<const std::byte> data, char delim, std::size_t& search_pos) noexcept -> std::size_t {
+            const auto begin = reinterpret_cast<const char*>(data.data());
+            const auto end = begin + data.size();
+            if (const char* found = find_byte(begin + search_pos, end, delim); found != end) {
+                return static_cast<std::size_t>(found - begin + 1);
+            }
+            search_pos = data.size();
+            return 0;
+        }
+
+        COIO_ALWAYS_INLINE auto search_delimiter(std::span<const std::byte> data, std::string_view delim, std::size_t& search_pos) noexcept -> std::size_t {
+            if (delim.size() == 1) return search_delimiter(data, delim.front(), search_pos);
+            const auto begin = reinterpret_cast<const char*>(data.data());
+            const auto end = begin + data.size();
+            // Back up for partial matches at boundary
+            const std::size_t start = search_pos > delim.size() - 1 ? search_pos - delim.size() + 1 : 0;
+            if (const char* found = find_substring(begin + start, end, delim); found != end) {
+                return static_cast<std::size_t>(found - begin) + delim.size();
+            }
+            search_pos = data.size();
+            return 0;
+        }
+
+        COIO_ALWAYS_INLINE auto search_delimiter(std::span<const std::byte> data, const delimiter_matcher& delim, std::size_t& search_pos) noexcept -> std::size_t {
+            const std::size_t start = search_pos > delim.max_length() - 1 ? search_pos - delim.max_length() + 1 : 0;
+            if (auto found = delim.find(data, start)) return found->position + found->size;
+            search_pos = data.size();
+            return 0;
+        }
+
+        // the same over the blocks of a segmented buffer, where a delimiter may run from one block into the next
+        inline auto search_delimiter(std::span<const std::span<const std::byte>> data, char delim, std::size_t& search_pos) noexcept -> std::size_t {
+            std::size_t base = 0;
+            for (const auto segment : data) {
+                if (base + segment.size() > search_pos) {
+                    std::size_t from = search_pos > base ? search_pos - base : 0;
+                    if (const std::size_t pos = search_delimiter(segment, delim, from)) return base + pos;
+                }
+                base += segment.size();
+            }
+            search_pos = base;
+            return 0;
+        }
+
+        inline auto search_delimiter(std::span<const std::span<const std::byte>> data, std::string_view delim, std::size_t& search_pos) noexcept -> std::size_t {
+            if (delim.size() == 1) return search_delimiter(data, delim.front(), search_pos);
+            const std::size_t start = search_pos > delim.size() - 1 ? search_pos - delim.size() + 1 : 0;
+            std::size_t base = 0;
+            for (std::size_t i = 0; i < data.size(); base += data[i].size(), ++i) {
+                const auto segment = data[i];
+                if (base + segment.size() <= start) continue;
+                const std::size_t from = start > base ? start - base : 0;
+                const auto begin = reinterpret_cast<const char*>(segment.data());
+                const auto end = begin + segment.size();
+                if (const char* found = find_substring(begin + from, end, delim); found != end) {
+                    return base + static_cast<std::size_t>(found - begin) + delim.size();
+                }
+                // those running into the next blocks start in the last `delim.size() - 1` bytes
+                const std::size_t tail = segment.size() > delim.size() - 1 ? segment.size() - delim.size() + 1 : 0;
+                for (std::size_t p = std::max(from, tail); p < segment.size(); ++p) {
+                    if (starts_with_across(data, i, p, delim)) return base + p + delim.size();
+                }
+            }
+            search_pos = base;
+            return 0;
+        }
+
+        inline auto search_delimiter(std::span<const std::span<const std::byte>> data, const delimiter_matcher& delim, std::size_t& search_pos) noexcept -> std::size_t {
+            const std::size_t start = search_pos > delim.max_length() - 1 ? search_pos - delim.max_length() + 1 : 0;
+            if (auto found = delim.find(data, start)) return found->position + found->size;
+            search_pos = 0;
+            for (const auto segment : data) search_pos += segment.size();
+            return 0;
+        }
+
         struct read_until_t {
             // Read until char delimiter
             COIO_STATIC_CALL_OP auto operator() (
                 input_stream_device auto& device,
-                dynamic_buffer auto& buffer,
+                any_dynamic_buffer auto& buffer,
                 char delim
             ) COIO_STATIC_CALL_OP_CONST -> std::size_t {
-                std::size_t search_pos = 0;
-                for (;;) {
-                    auto data = buffer.data();
-                    auto begin = reinterpret_cast<const char*>(data.data());
-                    auto end = begin + data.size();
-
-                    for (auto it = begin + search_pos; it != end; ++it) {
-                        if (*it == delim) {
-                            return static_cast<std::size_t>(it - begin + 1);
-                        }
-                    }
-
-                    search_pos = data.size();
-
-                    if (buffer.size() == buffer.max_size()) [[unlikely]] {
-                        throw std::system_error{error::not_found, "read_until"};
-                    }
-
-                    const std::size_t bytes_to_read = std::min(
-                        std::max<std::size_t>(512, buffer.capacity() - buffer.size()),
-                        std::min<std::size_t>(65536, buffer.max_size() - buffer.size())
-                    );
-
-                    auto prep = buffer.prepare(bytes_to_read);
-                    std::size_t n = device.read_some(prep);
-                    buffer.commit(n);
-                }
+                return read_until_t::search_and_read(device, buffer, delim);
             }
 
             // Read until string delimiter
             COIO_STATIC_CALL_OP auto operator() (
                 input_stream_device auto& device,
-                dynamic_buffer auto& buffer,
+                any_dynamic_buffer auto& buffer,
                 std::string_view delim
             ) COIO_STATIC_CALL_OP_CONST -> std::size_t {
                 if (delim.empty()) return 0;
-                if (delim.size() == 1) {
-                    return read_until_t{}(device, buffer, delim[0]);
-                }
+                return read_until_t::search_and_read(device, buffer, delim);
+            }
 
+            // Read until any of a set of delimiters
+            COIO_STATIC_CALL_OP auto operator() (
+                input_stream_device auto& device,
+                any_dynamic_buffer auto& buffer,
+                const delimiter_matcher& delim
+            ) COIO_STATIC_CALL_OP_CONST -> std::size_t {
+                if (delim.empty()) return 0;
+                return read_until_t::search_and_read(device, buffer, delim);
+            }
+
+        private:
+            static auto search_and_read(
+                input_stream_device auto& device,
+                any_dynamic_buffer auto& buffer,
+                const auto& delim
+            ) -> std::size_t {
                 std::size_t search_pos = 0;
                 for (;;) {
-                    auto data = buffer.data();
-                    auto begin = reinterpret_cast<const char*>(data.data());
-                    auto size = data.size();
-
-                    // Back up for partial matches at boundary
-                    std::size_t start = search_pos > delim.size() - 1 ? search_pos - delim.size() + 1 : 0;
-
-                    if (size >= delim.size()) {
-                        for (std::size_t i = start; i <= size - delim.size(); ++i) {
-                            if (std::memcmp(begin + i, delim.data(), delim.size()) == 0) {
-                                return i + delim.size();
-                            }
-                        }
+                    if (const std::size_t pos = search_delimiter(buffer.data(), delim, search_pos)) {
+                        return pos;
                     }
 
-                    search_pos = size;
-
                     if (buffer.size() == buffer.max_size()) [[unlikely]] {
                         throw std::system_error{error::not_found, "read_until"};
                     }
@@ -262,12 +383,67 @@ namespace coio {
                     );
 
                     auto prep = buffer.prepare(bytes_to_read);
-                    std::size_t n = device.read_some(prep);
+                    std::size_t n = read_some_into(device, prep);
                     buffer.commit(n);
                 }
             }
         };
 
+        // walks a buffer sequence during a scatter/gather transfer, the leading buffer may be partially transferred
+        template<typename Byte>
+        class buffer_sequence_cursor {
+        public:
+            // how many buffers one operation is handed at most
+            static constexpr std::size_t window_size = 16;
+
+            explicit buffer_sequence_cursor(std::span<const std::span<Byte>> buffers) noexcept : rest_(buffers) {
+                next();
+            }
+
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto empty() const noexcept -> bool {
+                return head_.empty();
+            }
+
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto front() const noexcept -> std::span<Byte> {
+                return head_;
+            }
+
+            // the leading buffers, the first one without its transferred part
+            [[nodiscard]]
+            auto window() noexcept -> std::span<const std::span<Byte>> {
+                const std::size_t n = std::min(rest_.size(), window_size - 1);
+                window_[0] = head_;
+                std::ranges::copy(rest_.first(n), window_.begin() + 1);
+                return std::span{window_}.first(n + 1);
+            }
+
+            auto consume(std::size_t n) noexcept -> void {
+                while (not head_.empty() and n >= head_.size()) {
+                    n -= head_.size();
+                    next();
+                }
+                COIO_ASSERT(n <= head_.size());
+                head_ = head_.subspan(n);
+            }
+
+        private:
+            // skips empty buffers, so `head_` is only empty at the end of the sequence
+            auto next() noexcept -> void {
+                head_ = {};
+                while (head_.empty() and not rest_.empty()) {
+                    head_ = rest_.front();
+                    rest_ = rest_.subspan(1);
+                }
+            }
+
+        private:
+            std::span<Byte> head_;
+            std::span<const std::span<Byte>> rest_;
+            std::array<std::span<Byte>, window_size> window_{};
+        };
+
         template<typename Rcvr>
         struct transfer_bytes_state_base {
             using operation_state_concept = execution::operation_state_tag;
@@ -404,10 +580,35 @@ namespace coio {
                }};
             }
 
+            // devices without scatter reads are read into one buffer at a time
             [[nodiscard]]
             COIO_ALWAYS_INLINE COIO_STATIC_CALL_OP auto operator() (
                 async_input_stream_device auto& device,
-                dynamic_buffer auto& dyn_buffer,
+                std::span<const std::span<std::byte>> buffers
+            ) COIO_STATIC_CALL_OP_CONST {
+               return transfer_bytes_sender{io_sender_factory{
+                   [](auto* device, buffer_sequence_cursor<std::byte>& remaining) noexcept {
+                       if constexpr (async_scatter_input_stream_device<std::remove_pointer_t<decltype(device)>>) {
+                           return device->async_read_some(remaining.window());
+                       }
+                       else {
+                           return device->async_read_some(remaining.front());
+                       }
+                   },
+                   [](std::size_t bytes_transferred, auto, buffer_sequence_cursor<std::byte>& remaining) noexcept {
+                       remaining.consume(bytes_transferred);
+                       return not remaining.empty();
+                   },
+                   std::addressof(device),
+                   buffer_sequence_cursor<std::byte>{buffers}
+               }};
+            }
+
+            // a segmented buffer is read as a buffer sequence
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE COIO_STATIC_CALL_OP auto operator() (
+                async_input_stream_device auto& device,
+                any_dynamic_buffer auto& dyn_buffer,
                 std::size_t total
             ) COIO_STATIC_CALL_OP_CONST {
                 return let_value(
@@ -440,10 +641,35 @@ namespace coio {
                 }};
             }
 
+            // devices without gather writes are written from one buffer at a time
             [[nodiscard]]
             COIO_ALWAYS_INLINE COIO_STATIC_CALL_OP auto operator() (
                 async_output_stream_device auto& device,
-                dynamic_buffer auto& dyn_buffer
+                std::span<const std::span<const std::byte>> buffers
+            ) COIO_STATIC_CALL_OP_CONST {
+                return transfer_bytes_sender{io_sender_factory{
+                    [](auto* device, buffer_sequence_cursor<const std::byte>& remaining) noexcept {
+                        if constexpr (async_gather_output_stream_device<std::remove_pointer_t<decltype(device)>>) {
+                            return device->async_write_some(remaining.window());
+                        }
+                        else {
+                            return device->async_write_some(remaining.front());
+                        }
+                    },
+                    [](std::size_t bytes_transferred, auto, buffer_sequence_cursor<const std::byte>& remaining) noexcept {
+                        remaining.consume(bytes_transferred);
+                        return not remaining.empty();
+                    },
+                    std::addressof(device),
+                    buffer_sequence_cursor<const std::byte>{buffers}
+                }};
+            }
+
+            // a segmented buffer is written as a buffer sequence
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE COIO_STATIC_CALL_OP auto operator() (
+                async_output_stream_device auto& device,
+                any_dynamic_buffer auto& dyn_buffer
             ) COIO_STATIC_CALL_OP_CONST {
                 return let_value(
                     async_write_t{}(device, dyn_buffer.data()),
@@ -456,6 +682,45 @@ namespace coio {
         };
 
 
+        struct async_sendfile_t {
+            template<typename Device, typename FileHandle> requires async_sendfile_device<Device&, FileHandle>
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE COIO_STATIC_CALL_OP auto operator() (
+                Device& device,
+                FileHandle file,
+                std::size_t offset,
+                std::size_t count
+            ) COIO_STATIC_CALL_OP_CONST {
+                return transfer_bytes_sender{io_sender_factory{
+                    [](auto* device, FileHandle file, std::size_t offset, std::size_t remaining) noexcept {
+                        return device->async_sendfile_some(file, offset, remaining);
+                    },
+                    [](std::size_t bytes_transferred, auto, FileHandle, std::size_t& offset, std::size_t& remaining) noexcept {
+                        offset += bytes_transferred;
+                        remaining -= bytes_transferred;
+                        return remaining > 0;
+                    },
+                    std::addressof(device),
+                    file,
+                    offset,
+                    count
+                }};
+            }
+
+            template<typename Device, typename File> requires requires (const File& file) {
+                requires async_sendfile_device<Device&, decltype(file.native_handle())>;
+            }
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE COIO_STATIC_CALL_OP auto operator() (
+                Device& device,
+                const File& file,
+                std::size_t offset,
+                std::size_t count
+            ) COIO_STATIC_CALL_OP_CONST {
+                return async_sendfile_t{}(device, file.native_handle(), offset, count);
+            }
+        };
+
         struct async_read_at_t {
             [[nodiscard]]
             COIO_ALWAYS_INLINE COIO_STATIC_CALL_OP auto operator() (
@@ -573,7 +838,7 @@ namespace coio {
         struct read_until_state : read_until_state_base<Rcvr> {
             using base = read_until_state_base<Rcvr>;
             using receiver = typename base::receiver;
-            using read_sender_t = decltype(std::declval<Device&>().async_read_some(std::declval<std::span<std::byte>>()));
+            using read_sender_t = decltype(async_read_some_into(std::declval<Device&>(), std::declval<Buffer&>().prepare(0)));
 
             read_until_state(Rcvr rcvr, Device* device, Buffer* buffer, Delim delim) noexcept
                 : base(&on_read_impl, std::move(rcvr)), device(device), buffer(buffer), delim(std::move(delim)) {}
@@ -583,11 +848,9 @@ namespace coio {
             auto operator= (const read_until_state&) -> read_until_state& = delete;
 
             COIO_ALWAYS_INLINE auto start() & noexcept -> void {
-                if constexpr (std::same_as<Delim, std::string_view>) {
-                    if (delim.empty()) {
-                        execution::set_value(std::move(this->rcvr), std::error_code{}, std::size_t{0});
-                        return;
-                    }
+                if (delimiter_empty(delim)) {
+                    execution::set_value(std::move(this->rcvr), std::error_code{}, std::size_t{0});
+                    return;
                 }
                 search_and_read();
             }
@@ -605,33 +868,8 @@ namespace coio {
                 do_read();
             }
 
-            auto search() noexcept -> std::size_t {
-                auto data = buffer->data();
-                auto begin = reinterpret_cast<const char*>(data.data());
-                auto size = data.size();
-
-                if constexpr (std::same_as<Delim, char>) {
-                    auto end = begin + size;
-                    for (auto it = begin + search_pos; it != end; ++it) {
-                        if (*it == delim) {
-                            return static_cast<std::size_t>(it - begin + 1);
-                        }
-                    }
-                    search_pos = size;
-                    return 0;
-                }
-                else {
-                    std::size_t start = search_pos > delim.size() - 1 ? search_pos - delim.size() + 1 : 0;
-                    if (size >= delim.size()) {
-                        for (std::size_t i = start; i <= size - delim.size(); ++i) {
-                            if (std::memcmp(begin + i, delim.data(), delim.size()) == 0) {
-                                return i + delim.size();
-                            }
-                        }
-                    }
-                    search_pos = size;
-                    return 0;
-                }
+            COIO_ALWAYS_INLINE auto search() noexcept -> std::size_t {
+                return search_delimiter(buffer->data(), delim, search_pos);
             }
 
             COIO_ALWAYS_INLINE auto do_read() noexcept -> void {
@@ -640,7 +878,7 @@ namespace coio {
                     std::min<std::size_t>(65536, buffer->max_size() - buffer->size())
                 );
                 auto prep = buffer->prepare(bytes_to_read);
-                read_state.emplace(elide{execution::connect, device->async_read_some(prep), receiver{this}});
+                read_state.emplace(elide{execution::connect, async_read_some_into(*device, prep), receiver{this}});
                 execution::start(*read_state);
             }
 
@@ -687,7 +925,7 @@ namespace coio {
             [[nodiscard]]
             COIO_ALWAYS_INLINE COIO_STATIC_CALL_OP auto operator() (
                 async_input_stream_device auto& device,
-                dynamic_buffer auto& buffer,
+                any_dynamic_buffer auto& buffer,
                 char delim
             ) COIO_STATIC_CALL_OP_CONST {
                 return read_until_sender{std::addressof(device), std::addressof(buffer), delim};
@@ -697,11 +935,21 @@ namespace coio {
             [[nodiscard]]
             COIO_ALWAYS_INLINE COIO_STATIC_CALL_OP auto operator() (
                 async_input_stream_device auto& device,
-                dynamic_buffer auto& buffer,
+                any_dynamic_buffer auto& buffer,
                 std::string_view delim
             ) COIO_STATIC_CALL_OP_CONST {
                 return read_until_sender{std::addressof(device), std::addressof(buffer), delim};
             }
+
+            // Read until any of a set of delimiters
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE COIO_STATIC_CALL_OP auto operator() (
+                async_input_stream_device auto& device,
+                any_dynamic_buffer auto& buffer,
+                const delimiter_matcher& delim
+            ) COIO_STATIC_CALL_OP_CONST {
+                return read_until_sender{std::addressof(device), std::addressof(buffer), std::cref(delim)};
+            }
         };
 
         struct as_bytes_t {
@@ -735,6 +983,7 @@ namespace coio {
     inline constexpr detail::write_at_t             write_at{};
     inline constexpr detail::async_read_at_t        async_read_at{};
     inline constexpr detail::async_write_at_t       async_write_at{};
+    inline constexpr detail::async_sendfile_t       async_sendfile{};
     inline constexpr detail::read_until_t           read_until{};
     inline constexpr detail::async_read_until_t     async_read_until{};
     inline constexpr detail::as_bytes_t             as_bytes{};
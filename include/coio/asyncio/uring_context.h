@@ -5,14 +5,27 @@
 #if not COIO_HAS_IO_URING
 #error "uh, where is <liburing.h>?"
 #endif
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <optional>
 #include <variant>
+#include <vector>
+#include <fcntl.h>
 #include <liburing.h>
 #include <netinet/in.h>
+#include <sys/stat.h>
 #include <coio/execution_context.h>
 #include <coio/utils/async_result.h>
 #include <coio/detail/io_descriptions.h>
+#include <coio/detail/iovec_buffers.h>
+#include <coio/detail/mmsg_batch.h>
+#include <coio/utils/zstring_view.h>
 
 namespace coio {
+    class uring_context;
+
     namespace detail {
         template<typename Tag>
         class uring_node_for;
@@ -21,6 +34,100 @@ namespace coio {
         class uring_state_base_for;
 
         enum class seek_whence;
+
+        enum class open_mode;
+
+        /**
+         * \brief a buffer leased from the provided-buffer ring of a `uring_context`.
+         * \note the buffer is given back to the ring when the lease is destroyed or reset,
+         * so a lease must not outlive the context it was leased from.
+         */
+        class uring_buffer_lease {
+            template<typename Tag>
+            friend class uring_state_base_for;
+        public:
+            uring_buffer_lease() = default;
+
+            uring_buffer_lease(const uring_buffer_lease&) = delete;
+
+            uring_buffer_lease(uring_buffer_lease&& other) noexcept :
+                context_(std::exchange(other.context_, nullptr)),
+                id_(other.id_),
+                data_(std::exchange(other.data_, {})) {}
+
+            ~uring_buffer_lease() {
+                reset();
+            }
+
+            auto operator= (uring_buffer_lease other) noexcept -> uring_buffer_lease& {
+                swap(other);
+                return *this;
+            }
+
+            auto swap(uring_buffer_lease& other) noexcept -> void {
+                std::ranges::swap(context_, other.context_);
+                std::ranges::swap(id_, other.id_);
+                std::ranges::swap(data_, other.data_);
+            }
+
+            friend auto swap(uring_buffer_lease& lhs, uring_buffer_lease& rhs) noexcept -> void {
+                lhs.swap(rhs);
+            }
+
+            /**
+             * \brief get the received bytes.
+             */
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto data() const noexcept -> std::span<std::byte> {
+                return data_;
+            }
+
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto size() const noexcept -> std::size_t {
+                return data_.size();
+            }
+
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto empty() const noexcept -> bool {
+                return data_.empty();
+            }
+
+            /**
+             * \brief give the buffer back to the ring early.
+             */
+            auto reset() noexcept -> void;
+
+        private:
+            uring_buffer_lease(uring_context& context, std::uint16_t id, std::span<std::byte> data) noexcept :
+                context_(&context), id_(id), data_(data) {}
+
+        private:
+            uring_context* context_ = nullptr;
+            std::uint16_t id_ = 0;
+            std::span<std::byte> data_;
+        };
+
+        struct receive_buffered_tag {
+            using value_signature = execution::set_value_t(uring_buffer_lease);
+        };
+
+        struct open_tag {
+            using value_signature = execution::set_value_t(int);
+        };
+
+        struct close_tag {
+            using value_signature = execution::set_value_t();
+        };
+
+        struct stat_tag {
+            using value_signature = execution::set_value_t(struct ::statx);
+        };
+
+        /// takes the next completion of a multishot request otherwise completing like `Tag`
+        template<typename Tag>
+        struct multishot_tag {
+            using value_signature = typename Tag::value_signature;
+        };
     }
 
     class uring_context : public detail::loop_base<uring_context> {
@@ -28,30 +135,121 @@ namespace coio {
         friend class detail::uring_node_for;
         template<typename Tag>
         friend class detail::uring_state_base_for;
+        friend detail::uring_buffer_lease;
         friend loop_base;
 
     private:
+        /// why a node waits in the overflow queue of a full ring
+        enum class overflow_state : std::uint8_t {
+            none,
+            start,     // its request still has to be submitted
+            cancel,    // its cancellation still has to be submitted
+            cancelled, // cancelled before its request was submitted
+        };
+
         struct uring_node : node {
             friend uring_context;
         public:
             uring_node(uring_context& context, int fd) noexcept : node(context), fd(fd) {}
 
         private:
-            virtual auto complete(int cqe_res) noexcept -> void = 0;
+            virtual auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void = 0;
+
+            /// fills in the request of this node, for submissions that don't know its concrete type
+            virtual auto prepare_request(::io_uring_sqe* sqe) noexcept -> void = 0;
 
         protected:
             auto do_cancel() -> void;
 
+            /// leaves the overflow queue; must be called before a node whose cancellation may have been deferred is destroyed
+            auto withdraw() noexcept -> void;
+
+            COIO_ALWAYS_INLINE auto use_fixed_file(::io_uring_sqe* sqe) const noexcept -> void {
+                if (file_index < 0) return;
+                sqe->fd = file_index;
+                sqe->flags |= IOSQE_FIXED_FILE;
+            }
+
             int fd;
+            int file_index = -1; // slot in the context's registered file table, if any
+            bool multishot = false; // multishot nodes publish the operations they complete by themselves
+
+        private:
+            overflow_state overflow_ = overflow_state::none; // guarded by the context's `uring_mtx_`
+            uring_node* overflow_prev_ = nullptr;
+            uring_node* overflow_next_ = nullptr;
+            bool remote_cancel_ = false; // handed over to the issuer thread, guarded by the context's `remote_mtx_`
+            uring_node* remote_next_ = nullptr;
+        };
+
+        /**
+         * a request kept armed across completions; completions arriving while nobody waits for them are queued,
+         * and once too many are queued the request is cancelled and re-armed by the next waiter.
+         */
+        struct multishot_node : uring_node {
+            friend uring_context;
+        public:
+            multishot_node(uring_context& context, int fd, int file_index, std::uint8_t opcode);
+
+            auto attach(uring_node& waiter) noexcept -> detail::start_result;
+
+            auto detach(uring_node& waiter) noexcept -> bool;
+
+            auto orphan() noexcept -> void;
+
+        private:
+            struct completion {
+                int res;
+                std::uint32_t flags;
+            };
+
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
+
+            auto prepare_request(::io_uring_sqe* sqe) noexcept -> void override;
+
+            auto arm() noexcept -> void;
+
+            auto throttle() noexcept -> void;
+
+            /// re-arms a receive parked by an exhausted buffer ring, called once a buffer comes back
+            auto replenish() noexcept -> void;
+
+            auto discard(completion c) noexcept -> void;
+
+        private:
+            atomutex mtx_;
+            std::pmr::deque<completion> backlog_;
+            uring_node* waiter_ = nullptr;
+            multishot_node* starved_next_ = nullptr; // guarded by the context's `buf_ring_mtx_`
+            std::uint64_t recycled_ = 0; // the context's `buffers_recycled_` when the request was armed
+            std::uint8_t opcode_;
+            bool armed_ = false;
+            bool throttled_ = false;
+            bool starved_ = false; // waiting for a buffer to come back to the ring
+            bool orphaned_ = false;
         };
 
+    public:
+        template<typename Tag, typename... Args>
+        class multishot_stream;
+
+        /// a stream of accepted connections, see `scheduler::io_object::make_accept_stream`
+        using accept_stream = multishot_stream<detail::accept_tag>;
+
+        /// a stream of received buffers, see `scheduler::io_object::make_receive_stream`
+        using receive_stream = multishot_stream<detail::receive_buffered_tag, bool>;
+
     public:
         class scheduler : public scheduler_base {
             friend uring_context;
+        private:
+            struct close_sender;
+
         public:
             using scheduler_concept = detail::io_scheduler_tag;
 
             class io_object {
+                friend close_sender;
             public:
                 io_object(uring_context& ctx, int fd);
 
@@ -60,6 +258,7 @@ namespace coio {
                 io_object(io_object&& other) noexcept :
                     ctx_(other.ctx_),
                     fd_(std::exchange(other.fd_, -1)),
+                    file_index_(std::exchange(other.file_index_, -1)),
                     stream_oriented_(std::exchange(other.stream_oriented_, false)) {}
 
                 ~io_object();
@@ -72,6 +271,7 @@ namespace coio {
                 auto swap(io_object& other) noexcept -> void {
                     std::ranges::swap(ctx_, other.ctx_);
                     std::ranges::swap(fd_, other.fd_);
+                    std::ranges::swap(file_index_, other.file_index_);
                     std::ranges::swap(stream_oriented_, other.stream_oriented_);
                 }
 
@@ -94,6 +294,21 @@ namespace coio {
 
                 auto cancel() -> void;
 
+                /**
+                 * \brief install the descriptor into the context's registered file table, so that
+                 * asynchronous operations skip the kernel's per-operation file lookup.
+                 * \throw std::system_error on failure, if no table is registered (see `uring_context::register_file_table`)
+                 * or if the table is full.
+                 * \note the slot is given back when the object is closed, unless the kernel fails to clear it;
+                 * such a slot stays out of use, as it still refers to the file.
+                 */
+                auto register_file() -> void;
+
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto is_file_registered() const noexcept -> bool {
+                    return file_index_ != -1;
+                }
+
                 [[nodiscard]]
                 auto receive(std::span<std::byte> buffer) -> std::size_t;
 
@@ -124,12 +339,18 @@ namespace coio {
                 auto resize(std::size_t new_size) -> void;
 
             private:
+                /**
+                 * give up the descriptor, and its registered file slot, without closing it;
+                 * the locks it takes are spinlocks, and the freed slot has room reserved in the free list
+                 */
+                auto release() noexcept -> int;
+
                 template<typename Tag, typename... Args>
                 [[nodiscard]]
                 COIO_ALWAYS_INLINE auto async_initiate(Args... args) noexcept {
                     COIO_ASSERT(ctx_ != nullptr);
                     return stop_when(
-                        io_sender<Tag, Args...>{fd_, ctx_, {std::move(args)...}},
+                        io_sender<Tag, Args...>{fd_, file_index_, ctx_, {std::move(args)...}},
                         ctx_->stop_source_.get_token()
                     );
                 }
@@ -140,11 +361,47 @@ namespace coio {
                     return async_initiate<detail::receive_tag>(buffer, stream_oriented_);
                 }
 
+                /**
+                 * \brief receive into a buffer picked by the kernel from the context's provided-buffer ring.
+                 * \return a sender of `buffer_lease`; it completes with `std::errc::no_buffer_space` when
+                 * every buffer of the ring is leased and with `std::errc::operation_not_supported` when no ring
+                 * is registered (see `uring_context::register_buffer_ring`).
+                 */
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_receive_buffered() noexcept {
+                    return async_initiate<detail::receive_buffered_tag>(stream_oriented_);
+                }
+
                 [[nodiscard]]
                 COIO_ALWAYS_INLINE auto async_send(std::span<const std::byte> buffer) noexcept {
                     return async_initiate<detail::send_tag>(buffer);
                 }
 
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_receive(std::span<const std::span<std::byte>> buffers) noexcept {
+                    return async_initiate<detail::read_some_vectored_tag>(detail::iovec_buffers{buffers, not stream_oriented_}, stream_oriented_);
+                }
+
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_send(std::span<const std::span<const std::byte>> buffers) noexcept {
+                    return async_initiate<detail::send_vectored_tag>(detail::iovec_buffers{buffers, not stream_oriented_});
+                }
+
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_send_zc(std::span<const std::byte> buffer) noexcept {
+                    return async_initiate<detail::send_zc_tag>(buffer);
+                }
+
+                /**
+                 * \brief send up to `count` bytes of `file` starting at `offset` without copying them through user memory;
+                 * the data is spliced through a pipe owned by the context (`IORING_OP_SPLICE`).
+                 * \note the file's own position is neither used nor changed.
+                 */
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_sendfile(int file, std::size_t offset, std::size_t count) noexcept {
+                    return async_initiate<detail::sendfile_tag>(file, offset, count);
+                }
+
                 [[nodiscard]]
                 COIO_ALWAYS_INLINE auto async_receive_from(std::span<std::byte> buffer) noexcept {
                     return async_initiate<detail::receive_from_tag>(buffer);
@@ -155,11 +412,41 @@ namespace coio {
                     return async_initiate<detail::send_to_tag>(buffer, dest);
                 }
 
+                /// receive up to `mmsg_batch::max_count` datagrams into the leading `slots` (`recvmmsg`)
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_receive_many(std::span<datagram_receive_slot> slots) noexcept {
+                    return async_initiate<detail::receive_many_tag>(slots);
+                }
+
+                /// send up to `mmsg_batch::max_count` datagrams from the leading `slots` (`sendmmsg`)
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_send_many(std::span<const datagram_send_slot> slots) noexcept {
+                    return async_initiate<detail::send_many_tag>(slots);
+                }
+
                 [[nodiscard]]
                 COIO_ALWAYS_INLINE auto async_accept() noexcept {
                     return async_initiate<detail::accept_tag>();
                 }
 
+                /**
+                 * \brief arm a multishot accept on this listening socket.
+                 * \return a stream whose `next` yields every accepted connection.
+                 * \throw std::system_error on failure.
+                 */
+                [[nodiscard]]
+                auto make_accept_stream() -> accept_stream;
+
+                /**
+                 * \brief arm a multishot receive on this socket; one request stays armed for the lifetime of the stream.
+                 * \return a stream whose `next` yields a `buffer_lease` per completion, as `async_receive_buffered` does.
+                 * \throw std::system_error on failure, or if no provided-buffer ring is registered.
+                 * \note multishot receive requires Linux 6.0, older kernels fail the first `next`.
+                 * \note the stream survives the buffer ring running dry: the receive is re-armed once a lease is released.
+                 */
+                [[nodiscard]]
+                auto make_receive_stream() -> receive_stream;
+
                 [[nodiscard]]
                 COIO_ALWAYS_INLINE auto async_connect(const endpoint& peer) noexcept {
                     return async_initiate<detail::connect_tag>(peer);
@@ -175,6 +462,16 @@ namespace coio {
                     return async_initiate<detail::write_some_tag>(buffer);
                 }
 
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_read_some(std::span<const std::span<std::byte>> buffers) noexcept {
+                    return async_initiate<detail::read_some_vectored_tag>(detail::iovec_buffers{buffers}, true);
+                }
+
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_write_some(std::span<const std::span<const std::byte>> buffers) noexcept {
+                    return async_initiate<detail::write_some_vectored_tag>(detail::iovec_buffers{buffers});
+                }
+
                 [[nodiscard]]
                 COIO_ALWAYS_INLINE auto async_read_some_at(std::size_t offset, std::span<std::byte> buffer) noexcept {
                     return async_initiate<detail::read_some_at_tag>(offset, buffer);
@@ -185,9 +482,60 @@ namespace coio {
                     return async_initiate<detail::write_some_at_tag>(offset, buffer);
                 }
 
+                /**
+                 * \brief flush the file's data and metadata to the storage device (`IORING_OP_FSYNC`).
+                 */
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_sync_all() noexcept {
+                    return async_initiate<detail::sync_tag>(false);
+                }
+
+                /**
+                 * \brief flush the file's data, and only the metadata needed to read it back, to the storage device
+                 * (`IORING_OP_FSYNC` with `IORING_FSYNC_DATASYNC`).
+                 */
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_sync_data() noexcept {
+                    return async_initiate<detail::sync_tag>(true);
+                }
+
+                /**
+                 * \brief allocate disk space for `length` bytes of the file from `offset` (`IORING_OP_FALLOCATE`).
+                 * \param mode the `FALLOC_FL_*` flags, e.g. `FALLOC_FL_KEEP_SIZE` to leave the file size alone.
+                 */
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_allocate(std::size_t offset, std::size_t length, int mode = 0) noexcept {
+                    return async_initiate<detail::allocate_tag>(offset, length, mode);
+                }
+
+                /**
+                 * \brief get the status of the file (`IORING_OP_STATX`).
+                 * \param mask the `STATX_*` fields wanted.
+                 * \return a sender of `struct statx`.
+                 */
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_stat(unsigned mask = STATX_BASIC_STATS) noexcept {
+                    COIO_ASSERT(ctx_ != nullptr);
+                    // statx names its file by descriptor, never by registered slot
+                    return stop_when(io_sender<detail::stat_tag, unsigned>{fd_, -1, ctx_, {mask}}, ctx_->stop_source_.get_token());
+                }
+
+                /**
+                 * \brief close the descriptor without blocking the context (`IORING_OP_CLOSE`).
+                 * \note the object lets go of the descriptor when the returned sender is started, so it must stay
+                 * in place until then; a sender destroyed unstarted leaves the object open.
+                 * \note the operation ignores stop requests: once the kernel is asked to close, the descriptor is gone.
+                 */
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto async_close() noexcept -> close_sender {
+                    COIO_ASSERT(ctx_ != nullptr);
+                    return close_sender{this};
+                }
+
             private:
                 uring_context* ctx_;
                 int fd_ = -1;
+                int file_index_ = -1;
                 bool stream_oriented_ = false;
             };
 
@@ -204,10 +552,13 @@ namespace coio {
                 struct state_base : detail::uring_state_base_for<Tag> {
                     using base = detail::uring_state_base_for<Tag>;
 
-                    state_base(Rcvr rcvr, int fd, uring_context& context, Args... args) noexcept :
-                        base(fd, context, std::move(args)...), rcvr_(std::move(rcvr)) {}
+                    state_base(Rcvr rcvr, int fd, int file_index, uring_context& context, Args... args) noexcept :
+                        base(fd, context, std::move(args)...), rcvr_(std::move(rcvr)) {
+                        this->file_index = file_index;
+                    }
 
                     COIO_ALWAYS_INLINE auto do_finish() noexcept -> void {
+                        this->withdraw();
                         this->result.forward_to(std::move(this->rcvr_));
                     }
 
@@ -225,6 +576,7 @@ namespace coio {
                             return state<Rcvr>{
                                 std::move(rcvr),
                                 std::exchange(fd, -1),
+                                std::exchange(file_index, -1),
                                 *std::exchange(context, nullptr),
                                 std::move(args_)...
                             };
@@ -243,23 +595,222 @@ namespace coio {
                 }
 
                 int fd;
+                int file_index;
                 uring_context* context;
                 std::tuple<Args...> args;
             };
 
+        private:
+            struct close_sender {
+                using sender_concept = execution::sender_tag;
+                using completion_signatures = execution::completion_signatures<
+                    execution::set_value_t(),
+                    execution::set_error_t(std::error_code),
+                    execution::set_stopped_t()
+                >;
+
+                struct unstoppable_env {
+                    COIO_ALWAYS_INLINE auto query(get_stop_token_t) const noexcept -> never_stop_token {
+                        return {};
+                    }
+                };
+
+                // hides the receiver's stop token, so that `operation_state` installs no stop callback
+                template<typename Rcvr>
+                struct receiver {
+                    using receiver_concept = execution::receiver_tag;
+
+                    COIO_ALWAYS_INLINE auto set_value() && noexcept -> void {
+                        execution::set_value(std::move(rcvr));
+                    }
+
+                    COIO_ALWAYS_INLINE auto set_error(std::error_code ec) && noexcept -> void {
+                        execution::set_error(std::move(rcvr), ec);
+                    }
+
+                    COIO_ALWAYS_INLINE auto set_stopped() && noexcept -> void {
+                        execution::set_stopped(std::move(rcvr));
+                    }
+
+                    COIO_ALWAYS_INLINE auto get_env() const noexcept {
+                        return detail::join_env_t{unstoppable_env{}, execution::get_env(rcvr)};
+                    }
+
+                    Rcvr rcvr;
+                };
+
+                template<typename Rcvr>
+                struct state_base : detail::uring_state_base_for<detail::close_tag> {
+                    using base = detail::uring_state_base_for<detail::close_tag>;
+
+                    state_base(Rcvr rcvr, io_object& object) noexcept :
+                        base(-1, *object.ctx_), rcvr_{std::move(rcvr)}, object_(&object) {}
+
+                    COIO_ALWAYS_INLINE auto do_start() noexcept -> start_result {
+                        // the registered slot, if any, is given back as well: closing goes by descriptor
+                        this->fd = object_->release();
+                        return base::do_start();
+                    }
+
+                    COIO_ALWAYS_INLINE auto do_finish() noexcept -> void {
+                        this->withdraw();
+                        this->result.forward_to(std::move(this->rcvr_));
+                    }
+
+                    receiver<Rcvr> rcvr_;
+                    io_object* object_;
+                };
+
+                template<typename Rcvr>
+                using state = operation_state<state_base<Rcvr>>;
+
+                template<execution::receiver Rcvr>
+                COIO_ALWAYS_INLINE auto connect(Rcvr rcvr) && noexcept {
+                    COIO_ASSERT(object != nullptr);
+                    return state<Rcvr>{std::move(rcvr), *std::exchange(object, nullptr)};
+                }
+
+                template<similar_to<close_sender>, typename...>
+                static consteval auto get_completion_signatures() noexcept -> completion_signatures {
+                    return {};
+                }
+
+                COIO_ALWAYS_INLINE auto get_env() const noexcept -> env {
+                    return env{*object->ctx_};
+                }
+
+                io_object* object;
+            };
+
         public:
             using scheduler_base::scheduler_base;
 
             [[nodiscard]]
             auto make_io_object(int fd) const -> io_object ;
+
+            /**
+             * \brief open a file without blocking the context (`IORING_OP_OPENAT`).
+             * \param path the path of the file, relative to the working directory if not absolute; it must stay valid
+             * until the returned sender completes.
+             * \param mode the mode in which to open the file.
+             * \param random_access whether to advise the kernel that the file is read at random.
+             * \return a sender of the descriptor, to pass to `make_io_object`.
+             */
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto async_open(zstring_view path, detail::open_mode mode, bool random_access = false) const noexcept {
+                COIO_ASSERT(ctx_ != nullptr);
+                return stop_when(
+                    io_sender<detail::open_tag, zstring_view, detail::open_mode, bool>{AT_FDCWD, -1, ctx_, {path, mode, random_access}},
+                    ctx_->stop_source_.get_token()
+                );
+            }
+        };
+
+        /**
+         * \brief a stream of completions of a single multishot request.
+         * \note
+         * 1) completions arriving while no `next` is pending are queued; when too many are queued
+         * the request is cancelled and re-armed by the next `next`.\n
+         * 2) while armed the stream counts as outstanding work of the context.\n
+         * 3) at most one `next` may be pending at any time, and it must complete before the stream is destroyed.
+         */
+        template<typename Tag, typename... Args>
+        class multishot_stream {
+            friend scheduler::io_object;
+        public:
+            multishot_stream(const multishot_stream&) = delete;
+
+            multishot_stream(multishot_stream&& other) noexcept :
+                ctx_(std::exchange(other.ctx_, nullptr)),
+                fd_(std::exchange(other.fd_, -1)),
+                state_(std::exchange(other.state_, nullptr)),
+                args_(std::move(other.args_)) {}
+
+            ~multishot_stream() {
+                if (state_) state_->orphan();
+            }
+
+            auto operator= (multishot_stream other) noexcept -> multishot_stream& {
+                std::ranges::swap(ctx_, other.ctx_);
+                std::ranges::swap(fd_, other.fd_);
+                std::ranges::swap(state_, other.state_);
+                std::ranges::swap(args_, other.args_);
+                return *this;
+            }
+
+            /**
+             * \brief wait for the next completion.
+             * \return a sender completing as the single-shot operation would.
+             */
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto next() noexcept {
+                COIO_ASSERT(ctx_ != nullptr);
+                return std::apply(
+                    [this](const Args&... args) {
+                        return stop_when(
+                            scheduler::io_sender<detail::multishot_tag<Tag>, multishot_node*, Args...>{fd_, -1, ctx_, {state_, args...}},
+                            ctx_->stop_source_.get_token()
+                        );
+                    },
+                    args_
+                );
+            }
+
+        private:
+            multishot_stream(uring_context& ctx, int fd, multishot_node* state, Args... args) noexcept :
+                ctx_(&ctx), fd_(fd), state_(state), args_(std::move(args)...) {}
+
+        private:
+            uring_context* ctx_;
+            int fd_;
+            multishot_node* state_;
+            std::tuple<Args...> args_;
         };
 
         template<typename T = void, typename Alloc = std::allocator<std::byte>>
         using task = coio::task<T, Alloc, scheduler>;
 
+        using buffer_lease = detail::uring_buffer_lease;
+
+        /**
+         * \brief construction parameters of a `uring_context`.
+         */
+        struct options {
+            /// the number of submission queue entries.
+            std::size_t entries = 4096;
+
+            /// the number of completion queue entries, 0 for the kernel's default (twice `entries`).
+            std::size_t cq_entries = 0;
+
+            /// let a kernel thread poll the submission queue (`IORING_SETUP_SQPOLL`), so submitting needs no syscall while it is awake.
+            bool sq_poll = false;
+
+            /// pin the submission queue polling thread to this CPU (`IORING_SETUP_SQ_AFF`).
+            std::optional<unsigned> sq_poll_cpu;
+
+            /// how long the submission queue polling thread spins before it goes to sleep.
+            std::chrono::milliseconds sq_poll_idle{1000};
+
+            /**
+             * promise that I/O operations are only started on the thread that constructed and runs the context
+             * (`IORING_SETUP_SINGLE_ISSUER`); the context then submits without locking.
+             * Other threads may still schedule work and timers onto the context, and their stop requests are
+             * handed over to that thread.
+             */
+            bool single_issuer = false;
+
+            /// run completion work only when the context waits for completions (`IORING_SETUP_DEFER_TASKRUN`), implies `single_issuer`.
+            bool defer_taskrun = false;
+
+            /// don't interrupt the running thread to process completion work (`IORING_SETUP_COOP_TASKRUN`).
+            bool coop_taskrun = false;
+        };
+
     public:
         explicit uring_context(std::size_t entries, std::pmr::memory_resource& memory_resource = *std::pmr::get_default_resource());
 
+        explicit uring_context(const options& opts, std::pmr::memory_resource& memory_resource = *std::pmr::get_default_resource());
+
         uring_context();
 
         uring_context(const uring_context&) = delete;
@@ -273,7 +824,41 @@ namespace coio {
             return &uring_;
         }
 
+        /**
+         * \brief register a provided-buffer ring used by `async_receive_buffered`.
+         * \param buffer_size the size of each buffer.
+         * \param buffer_count the number of buffers, a power of two not greater than 32768.
+         * \throw std::system_error on failure, or if a ring is already registered.
+         * \note buffers are only leased while a receive has data to deliver, so the memory held
+         * scales with the number of active connections rather than the number of open ones.
+         */
+        auto register_buffer_ring(std::size_t buffer_size, std::size_t buffer_count) -> void;
+
+        /**
+         * \brief register a sparse file table, see `scheduler::io_object::register_file`.
+         * \param size the number of slots.
+         * \throw std::system_error on failure, or if a table is already registered.
+         */
+        auto register_file_table(std::size_t size) -> void;
+
+        /**
+         * \brief register buffers with the kernel; reads and writes whose buffer lies within one of them
+         * are submitted as fixed-buffer operations, which skip the per-operation page pinning.
+         * \param buffers the buffers to register, they must stay valid until the context is destroyed.
+         * \throw std::system_error on failure, or if buffers are already registered.
+         * \note operations started before the registration completes use the buffers unregistered;
+         * register them before starting I/O on other threads to get the fixed-buffer path throughout.
+         */
+        auto register_buffers(std::span<const std::span<std::byte>> buffers) -> void;
+
     private:
+        /// the pipe `async_sendfile` splices file data through
+        struct splice_pipe {
+            int read_end = -1;
+            int write_end = -1;
+            std::size_t capacity = 0;
+        };
+
         auto do_one(bool infinite) -> bool;
 
         auto interrupt() -> void;
@@ -284,11 +869,93 @@ namespace coio {
 
         auto post_submit_sqes() noexcept -> void;
 
+        auto defer(uring_node& op, overflow_state state) noexcept -> void;
+
+        auto unlink(uring_node& op) noexcept -> void;
+
+        auto drain_overflow() noexcept -> uring_node*;
+
+        auto recycle_buffer(std::uint16_t id) noexcept -> void;
+
+        /// park `stream` until a buffer is recycled. \return false if one was recycled since it was armed
+        auto starve(multishot_node& stream) noexcept -> bool;
+
+        /// \return false if a recycled buffer already took `stream` off the parked list
+        auto unstarve(multishot_node& stream) noexcept -> bool;
+
+        auto acquire_splice_pipe(splice_pipe& pipe) noexcept -> int;
+
+        auto release_splice_pipe(splice_pipe& pipe, bool reusable) noexcept -> void;
+
+        auto arm_wakeup() noexcept -> bool;
+
+        /// \return true if only another thread may submit to the ring (`options::single_issuer`)
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto foreign_issuer() const noexcept -> bool {
+            return uring_mtx_.single_issuer and std::this_thread::get_id() != issuer_id_;
+        }
+
+        /// submit what other threads handed over to the issuer thread
+        auto take_remote_requests() -> void;
+
+        auto drain_wakeup() noexcept -> void;
+
+        [[nodiscard]]
+        auto find_registered_buffer(std::span<const std::byte> buffer) const noexcept -> int;
+
     private:
-        atomutex uring_mtx_;
+        /// a lock which is a no-op when the context was created with `options::single_issuer`
+        class submit_mutex {
+        public:
+            COIO_ALWAYS_INLINE auto lock() noexcept -> void {
+                if (not single_issuer) mtx_.lock();
+            }
+
+            COIO_ALWAYS_INLINE auto unlock() noexcept -> void {
+                if (not single_issuer) mtx_.unlock();
+            }
+
+            bool single_issuer = false;
+
+        private:
+            atomutex mtx_;
+        };
+
+        struct registered_buffer {
+            const std::byte* begin;
+            const std::byte* end;
+            int index;
+        };
+
+        submit_mutex uring_mtx_;
+        std::thread::id issuer_id_; // single-issuer only: the thread which constructed the context
+        int wakeup_fd_ = -1; // single-issuer only: other threads wake the consumer through it instead of submitting
+        bool wakeup_armed_ = false;
+        atomutex remote_mtx_;
+        detail::intrusive_list<uring_node> remote_cancels_{&uring_node::remote_next_}; // guarded by `remote_mtx_`
+        std::pmr::vector<int> remote_fd_cancels_; // guarded by `remote_mtx_`
+        bool replenish_pending_ = false; // a foreign thread recycled a buffer for a starved stream, guarded by `buf_ring_mtx_`
         std::atomic<bool> pulling_cqes_{false};
         std::size_t pending_sqes_ = 0;
+        bool send_zc_supported_ = false;
+        uring_node* overflow_head_ = nullptr; // submissions waiting for room in a full ring, guarded by `uring_mtx_`
+        uring_node* overflow_tail_ = nullptr;
+        std::pmr::vector<int> deferred_fd_cancels_;
         ::io_uring uring_{};
+        atomutex buf_ring_mtx_;
+        ::io_uring_buf_ring* buf_ring_ = nullptr;
+        std::byte* buf_ring_storage_ = nullptr;
+        std::size_t buf_ring_buffer_size_ = 0;
+        std::uint16_t buf_ring_entries_ = 0;
+        std::uint64_t buffers_recycled_ = 0; // guarded by `buf_ring_mtx_`
+        detail::intrusive_list<multishot_node> starved_streams_{&multishot_node::starved_next_}; // guarded by `buf_ring_mtx_`
+        atomutex files_mtx_;
+        bool file_table_registered_ = false;
+        std::pmr::vector<int> free_file_slots_;
+        std::pmr::vector<registered_buffer> registered_buffers_; // sorted by `begin`, written once before `buffers_registered_` is set
+        std::atomic<bool> buffers_registered_{false};
+        atomutex splice_pipes_mtx_;
+        std::pmr::vector<splice_pipe> splice_pipes_; // idle, and empty
     };
 
     namespace detail {
@@ -313,11 +980,13 @@ namespace coio {
 
                 std::scoped_lock _{context_.uring_mtx_};
                 auto sqe = context_.allocate_sqe();
-                if (sqe == nullptr) {
-                    result.set_error(std::make_error_code(std::errc::no_buffer_space));
-                    return start_result::completed;
+                if (sqe == nullptr) [[unlikely]] {
+                    // the ring is full: `do_one` submits it once the kernel has caught up
+                    context_.defer(*this, uring_context::overflow_state::start);
+                    return start_result::pending;
                 }
                 derived->prepare(sqe);
+                this->use_fixed_file(sqe);
                 ::io_uring_sqe_set_data(sqe, static_cast<uring_node*>(this));
                 // TODO: To suppress TSAN false positives, we need to add more TSAN annotations! see https://github.com/axboe/liburing/issues/1514
                 COIO_TSAN_RELEASE(static_cast<uring_node*>(this));
@@ -326,7 +995,11 @@ namespace coio {
             }
 
         private:
-            auto complete(int cqe_res) noexcept -> void override {
+            auto prepare_request(::io_uring_sqe* sqe) noexcept -> void override {
+                static_cast<uring_state_base_for<Tag>*>(this)->prepare(sqe);
+            }
+
+            auto complete(int cqe_res, std::uint32_t) noexcept -> void override {
                 if (cqe_res < 0) {
                     const std::error_code ec{-cqe_res, std::system_category()};
                     if (ec == std::errc::operation_canceled) {
@@ -375,7 +1048,7 @@ namespace coio {
             auto prepare(::io_uring_sqe* sqe) noexcept -> void;
 
         private:
-            auto complete(int cqe_res) noexcept -> void override;
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
 
         private:
             std::span<std::byte> buffer_;
@@ -397,6 +1070,43 @@ namespace coio {
         };
 
 
+        /// async_read_some (scatter), async_receive (scatter)
+        template<>
+        class uring_state_base_for<read_some_vectored_tag> : public uring_node_for<read_some_vectored_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context, const iovec_buffers& buffers, bool eof_on_zero) noexcept :
+                uring_node_for(fd, context),
+                buffers_(buffers),
+                eof_on_zero_(eof_on_zero) {}
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+            auto try_complete() noexcept -> bool;
+
+        private:
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
+
+        private:
+            iovec_buffers buffers_;
+            bool eof_on_zero_; // false for datagrams, where an empty one is a valid message
+        };
+
+
+        /// async_write_some (gather)
+        template<>
+        class uring_state_base_for<write_some_vectored_tag> : public uring_node_for<write_some_vectored_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context, const iovec_buffers& buffers) noexcept :
+                uring_node_for(fd, context),
+                buffers_(buffers) {}
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+        private:
+            iovec_buffers buffers_;
+        };
+
+
         /// async_read_some_at
         template<>
         class uring_state_base_for<read_some_at_tag> : public uring_node_for<read_some_at_tag> {
@@ -409,7 +1119,7 @@ namespace coio {
             auto prepare(::io_uring_sqe* sqe) noexcept -> void;
 
         private:
-            auto complete(int cqe_res) noexcept -> void override;
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
 
         private:
             std::size_t offset_;
@@ -448,7 +1158,7 @@ namespace coio {
             auto try_complete() noexcept -> bool;
 
         private:
-            auto complete(int cqe_res) noexcept -> void override;
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
 
         private:
             std::span<std::byte> buffer_;
@@ -456,6 +1166,26 @@ namespace coio {
         };
 
 
+        /// async_receive_buffered
+        template<>
+        class uring_state_base_for<receive_buffered_tag> : public uring_node_for<receive_buffered_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context, bool stream_oriented) noexcept :
+                uring_node_for(fd, context),
+                stream_oriented_(stream_oriented) {}
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+            auto try_complete() noexcept -> bool;
+
+        private:
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
+
+        private:
+            bool stream_oriented_;
+        };
+
+
         /// async_send
         template<>
         class uring_state_base_for<send_tag> : public uring_node_for<send_tag> {
@@ -471,6 +1201,79 @@ namespace coio {
         };
 
 
+        /// async_send (gather)
+        template<>
+        class uring_state_base_for<send_vectored_tag> : public uring_node_for<send_vectored_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context, const iovec_buffers& buffers) noexcept;
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+            auto try_complete() noexcept -> bool;
+
+        private:
+            // `msg_` stores a pointer into `buffers_`: the object must stay at its construction address
+            iovec_buffers buffers_;
+            ::msghdr msg_;
+        };
+
+
+        /// async_send_zc
+        template<>
+        class uring_state_base_for<send_zc_tag> : public uring_node_for<send_zc_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context, std::span<const std::byte> buffer) noexcept :
+                uring_node_for(fd, context),
+                buffer_(buffer) {
+                multishot = true; // up to two completions, `complete` publishes after the last one
+            }
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+        private:
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
+
+        private:
+            std::span<const std::byte> buffer_;
+        };
+
+
+        /// async_sendfile
+        template<>
+        class uring_state_base_for<sendfile_tag> : public uring_node_for<sendfile_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context, int file, std::size_t offset, std::size_t count) noexcept :
+                uring_node_for(fd, context),
+                file_(file),
+                offset_(offset),
+                count_(count) {
+                multishot = true; // a splice into the pipe and out of it per round, `complete` publishes after the last one
+            }
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+            auto try_complete() noexcept -> bool;
+
+        protected:
+            auto do_cancel() -> void;
+
+        private:
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
+
+            auto resubmit() noexcept -> bool;
+
+        private:
+            int file_;
+            std::size_t offset_;
+            std::size_t count_;
+            uring_context::splice_pipe pipe_;
+            std::size_t in_pipe_ = 0; // spliced into the pipe, not yet out to the socket
+            std::size_t sent_ = 0;
+            int socket_index_ = -1;   // `file_index`, which only applies to the splices into the socket
+            std::atomic<bool> cancelled_{false};
+        };
+
+
         /// async_receive_from
         template<>
         class uring_state_base_for<receive_from_tag> : public uring_node_for<receive_from_tag> {
@@ -480,7 +1283,7 @@ namespace coio {
             auto prepare(::io_uring_sqe* sqe) noexcept -> void;
 
         private:
-            auto complete(int cqe_res) noexcept -> void override;
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
 
         private:
             // `msg_` stores pointers into `peer_`/`buffer_`: the object must stay at its construction address
@@ -506,6 +1309,70 @@ namespace coio {
         };
 
 
+        /// async_receive_many
+        // io_uring has no recvmmsg opcode: the ring waits for readiness (`IORING_OP_POLL_ADD`), the batch is received on completion
+        template<>
+        class uring_state_base_for<receive_many_tag> : public uring_node_for<receive_many_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context, std::span<datagram_receive_slot> slots) noexcept :
+                uring_node_for(fd, context),
+                slots_(slots),
+                batch_(slots) {
+                multishot = true; // a spurious wakeup polls again, `complete` publishes once the batch is received
+            }
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+            auto try_complete() noexcept -> bool;
+
+        protected:
+            auto do_cancel() -> void;
+
+        private:
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
+
+            auto receive() noexcept -> bool;
+
+            auto resubmit() noexcept -> bool;
+
+        private:
+            std::span<datagram_receive_slot> slots_;
+            mmsg_batch batch_;
+            std::atomic<bool> cancelled_{false};
+        };
+
+
+        /// async_send_many
+        // io_uring has no sendmmsg opcode: the ring waits for writability (`IORING_OP_POLL_ADD`), the batch is sent on completion
+        template<>
+        class uring_state_base_for<send_many_tag> : public uring_node_for<send_many_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context, std::span<const datagram_send_slot> slots) noexcept :
+                uring_node_for(fd, context),
+                batch_(slots) {
+                multishot = true; // a spurious wakeup polls again, `complete` publishes once the batch is sent
+            }
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+            auto try_complete() noexcept -> bool;
+
+        protected:
+            auto do_cancel() -> void;
+
+        private:
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
+
+            auto send() noexcept -> bool;
+
+            auto resubmit() noexcept -> bool;
+
+        private:
+            mmsg_batch batch_;
+            std::atomic<bool> cancelled_{false};
+        };
+
+
         /// async_accept
         template<>
         class uring_state_base_for<accept_tag> : public uring_node_for<accept_tag> {
@@ -516,6 +1383,116 @@ namespace coio {
         };
 
 
+        /// multishot_stream::next
+        template<typename Tag>
+        class uring_state_base_for<multishot_tag<Tag>> : public uring_state_base_for<Tag> {
+        public:
+            template<typename... Args>
+            uring_state_base_for(int fd, uring_context& context, uring_context::multishot_node* stream, Args... args) noexcept :
+                uring_state_base_for<Tag>(fd, context, std::move(args)...),
+                stream_(stream) {}
+
+            auto do_start() noexcept -> start_result {
+                return stream_->attach(*this);
+            }
+
+            auto do_cancel() noexcept -> void {
+                if (stream_->detach(*this)) {
+                    this->result.set_stopped();
+                    this->publish();
+                }
+            }
+
+        private:
+            uring_context::multishot_node* stream_;
+        };
+
+
+        /// async_sync_all, async_sync_data
+        template<>
+        class uring_state_base_for<sync_tag> : public uring_node_for<sync_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context, bool data_only) noexcept :
+                uring_node_for(fd, context),
+                data_only_(data_only) {}
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+        private:
+            bool data_only_;
+        };
+
+
+        /// async_allocate
+        template<>
+        class uring_state_base_for<allocate_tag> : public uring_node_for<allocate_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context, std::size_t offset, std::size_t length, int mode) noexcept :
+                uring_node_for(fd, context),
+                offset_(offset),
+                length_(length),
+                mode_(mode) {}
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+        private:
+            std::size_t offset_;
+            std::size_t length_;
+            int mode_;
+        };
+
+
+        /// async_stat
+        template<>
+        class uring_state_base_for<stat_tag> : public uring_node_for<stat_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context, unsigned mask) noexcept :
+                uring_node_for(fd, context),
+                mask_(mask) {}
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+        private:
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
+
+        private:
+            unsigned mask_;
+            struct ::statx stx_{}; // written by the kernel
+        };
+
+
+        /// scheduler::async_open
+        template<>
+        class uring_state_base_for<open_tag> : public uring_node_for<open_tag> {
+        public:
+            uring_state_base_for(int dir_fd, uring_context& context, zstring_view path, open_mode mode, bool random_access) noexcept :
+                uring_node_for(dir_fd, context),
+                path_(path),
+                mode_(mode),
+                random_access_(random_access) {}
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+
+        private:
+            auto complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void override;
+
+        private:
+            zstring_view path_;
+            open_mode mode_;
+            bool random_access_;
+        };
+
+
+        /// async_close
+        template<>
+        class uring_state_base_for<close_tag> : public uring_node_for<close_tag> {
+        public:
+            uring_state_base_for(int fd, uring_context& context) noexcept : uring_node_for(fd, context) {}
+
+            auto prepare(::io_uring_sqe* sqe) noexcept -> void;
+        };
+
+
         /// async_connect
         template<>
         class uring_state_base_for<connect_tag> : public uring_node_for<connect_tag> {
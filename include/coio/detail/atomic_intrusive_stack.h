@@ -39,6 +39,23 @@ namespace coio::detail {
             return stack_status::not_empty;
         }
 
+        /// push the chain `first` ... `last`, already linked through `next`, at once; return the list status before pushing
+        auto push_chain(reference first, reference last) noexcept -> stack_status {
+            auto old_top = head_.load(std::memory_order_acquire);
+            do {
+                last.*next_ = old_top == this ? nullptr : static_cast<pointer>(old_top);
+            }
+            while (not head_.compare_exchange_weak(
+                old_top,
+                &first,
+                std::memory_order_acq_rel
+            ));
+
+            if (old_top == this) return stack_status::empty_and_never_pushed;
+            if (old_top == nullptr) return stack_status::empty_but_pushed;
+            return stack_status::not_empty;
+        }
+
         [[nodiscard]]
         auto pop_all() noexcept -> pointer {
             auto head = head_.exchange(nullptr, std::memory_order_acq_rel);
@@ -0,0 +1,47 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <coio/detail/config.h>
+
+namespace coio::detail {
+    // vectorized searches over `[first, last)`; each returns `last` if nothing is found.
+    // SSE2 or AVX2 kernels are picked at runtime on x86, other targets fall back to `memchr`.
+
+    [[nodiscard]]
+    COIO_ALWAYS_INLINE auto find_byte(const char* first, const char* last, char c) noexcept -> const char* {
+        // every libc we run on already vectorizes `memchr`
+        if (first == last) return last;
+        const auto found = static_cast<const char*>(std::memchr(first, static_cast<unsigned char>(c), static_cast<std::size_t>(last - first)));
+        return found == nullptr ? last : found;
+    }
+
+    /// the first occurrence of `needle`, at least two bytes long
+    [[nodiscard]]
+    auto find_substring(const char* first, const char* last, std::string_view needle) noexcept -> const char*;
+
+    /// the first byte equal to any of `set`; at most four bytes are matched with SIMD, larger sets byte by byte
+    [[nodiscard]]
+    auto find_any_byte(const char* first, const char* last, std::string_view set) noexcept -> const char*;
+
+    /// whether the bytes from `offset` into `segments[index]` on, running into the next segments, start with `needle`
+    [[nodiscard]]
+    inline auto starts_with_across(
+        std::span<const std::span<const std::byte>> segments,
+        std::size_t index,
+        std::size_t offset,
+        std::string_view needle
+    ) noexcept -> bool {
+        for (; index < segments.size(); ++index, offset = 0) {
+            const auto segment = segments[index].subspan(offset);
+            const std::size_t n = std::min(segment.size(), needle.size());
+            if (n == 0) continue;
+            if (std::memcmp(segment.data(), needle.data(), n) != 0) return false;
+            needle.remove_prefix(n);
+            if (needle.empty()) return true;
+        }
+        return false;
+    }
+}
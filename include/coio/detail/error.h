@@ -22,7 +22,28 @@ namespace coio::error {
     [[nodiscard]]
     auto gai_category() noexcept -> const std::error_category&; // for `getaddrinfo`
 
+    enum class dns_errc : int {
+        host_not_found = 1, ///< the name doesn't exist (NXDOMAIN)
+        no_data,            ///< the name exists but has no address of the requested family
+        server_failure,     ///< the name server couldn't answer (SERVFAIL and the like)
+        refused,            ///< the name server refused to answer
+        timed_out,          ///< no name server answered in time
+        no_name_servers,    ///< there is no name server to ask
+        invalid_name,       ///< the name isn't a valid domain name
+        malformed_response, ///< the answer couldn't be decoded
+    };
+
+    [[nodiscard]]
+    auto dns_category() noexcept -> const std::error_category&; // for `basic_dns_resolver`
+
+    [[nodiscard]]
+    COIO_ALWAYS_INLINE auto make_error_code(dns_errc e) noexcept -> std::error_code {
+        return {static_cast<int>(e), dns_category()};
+    }
 }
 
 template<>
 struct std::is_error_code_enum<coio::error::misc_errc> : std::true_type {};
+
+template<>
+struct std::is_error_code_enum<coio::error::dns_errc> : std::true_type {};
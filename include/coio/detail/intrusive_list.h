@@ -78,6 +78,20 @@ namespace coio::detail {
             return object;
         }
 
+        /// unlink `object`, a linear search. \return false if it isn't in the list
+        auto erase(reference object) noexcept -> bool {
+            pointer previous = nullptr;
+            for (pointer current = head_; current != nullptr; previous = std::exchange(current, current->*next_)) {
+                if (current != &object) continue;
+                if (previous) previous->*next_ = object.*next_;
+                else head_ = object.*next_;
+                if (tail_ == &object) tail_ = previous;
+                object.*next_ = nullptr;
+                return true;
+            }
+            return false;
+        }
+
         [[nodiscard]]
         auto release() noexcept -> pointer {
             tail_ = nullptr;
@@ -11,6 +11,14 @@ namespace coio::detail {
         using value_signature = execution::set_value_t(std::size_t);
     };
 
+    struct read_some_vectored_tag {
+        using value_signature = execution::set_value_t(std::size_t);
+    };
+
+    struct write_some_vectored_tag {
+        using value_signature = execution::set_value_t(std::size_t);
+    };
+
     struct read_some_at_tag {
         using value_signature = execution::set_value_t(std::size_t);
     };
@@ -27,6 +35,18 @@ namespace coio::detail {
         using value_signature = execution::set_value_t(std::size_t);
     };
 
+    struct send_vectored_tag {
+        using value_signature = execution::set_value_t(std::size_t);
+    };
+
+    struct send_zc_tag {
+        using value_signature = execution::set_value_t(std::size_t);
+    };
+
+    struct sendfile_tag {
+        using value_signature = execution::set_value_t(std::size_t);
+    };
+
     struct receive_from_tag {
         using value_signature = execution::set_value_t(endpoint, std::size_t);
     };
@@ -35,6 +55,14 @@ namespace coio::detail {
         using value_signature = execution::set_value_t(std::size_t);
     };
 
+    struct receive_many_tag {
+        using value_signature = execution::set_value_t(std::size_t);
+    };
+
+    struct send_many_tag {
+        using value_signature = execution::set_value_t(std::size_t);
+    };
+
     struct accept_tag {
         using value_signature = execution::set_value_t(socket_native_handle_type);
     };
@@ -42,4 +70,12 @@ namespace coio::detail {
     struct connect_tag {
         using value_signature = execution::set_value_t();
     };
+
+    struct sync_tag {
+        using value_signature = execution::set_value_t();
+    };
+
+    struct allocate_tag {
+        using value_signature = execution::set_value_t();
+    };
 }
@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <span>
+#include <sys/uio.h>
+#include <coio/detail/config.h>
+
+namespace coio::detail {
+    /// the leading buffers of a scatter/gather operation, laid out the way readv/writev/sendmsg take them
+    class iovec_buffers {
+    public:
+        /// buffers beyond this are left for the next operation, as a short read/write
+        static constexpr std::size_t max_count = 16;
+
+        /// \param message the buffers make up one datagram, which can't be split over operations: more than
+        /// `max_count` non-empty ones make it `overflowed()` instead
+        template<typename Byte>
+        explicit iovec_buffers(std::span<const std::span<Byte>> buffers, bool message = false) noexcept {
+            for (const auto buffer : buffers) {
+                if (buffer.empty()) continue;
+                if (count_ == max_count) {
+                    overflowed_ = message;
+                    break;
+                }
+                iov_[count_++] = {const_cast<void*>(static_cast<const void*>(buffer.data())), buffer.size()};
+                total_ += buffer.size();
+            }
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto data() noexcept -> ::iovec* {
+            return iov_.data();
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto count() const noexcept -> std::size_t {
+            return count_;
+        }
+
+        /// the number of bytes the buffers hold
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto total() const noexcept -> std::size_t {
+            return total_;
+        }
+
+        /// a message that doesn't fit, the operation fails with `std::errc::message_size` rather than truncate it
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto overflowed() const noexcept -> bool {
+            return overflowed_;
+        }
+
+    private:
+        std::array<::iovec, max_count> iov_{};
+        std::size_t count_ = 0;
+        std::size_t total_ = 0;
+        bool overflowed_ = false;
+    };
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <span>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <coio/detail/config.h>
+#include <coio/net/basic.h>
+
+namespace coio::detail {
+    /// the leading slots of a batched datagram operation, laid out the way recvmmsg/sendmmsg take them
+    class mmsg_batch {
+    public:
+        /// slots beyond this are left for the next operation, as a short batch
+        static constexpr std::size_t max_count = 32;
+
+        // the headers store pointers into the object: it must stay at its construction address
+        explicit mmsg_batch(std::span<datagram_receive_slot> slots) noexcept;
+
+        explicit mmsg_batch(std::span<const datagram_send_slot> slots) noexcept;
+
+        mmsg_batch(const mmsg_batch&) = delete;
+
+        auto operator= (const mmsg_batch&) -> mmsg_batch& = delete;
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto data() noexcept -> ::mmsghdr* {
+            return msgs_.data();
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto count() const noexcept -> unsigned {
+            return count_;
+        }
+
+        /// store the sender, size and truncation of the first `n` received datagrams into `slots`
+        auto finish_receive(std::span<datagram_receive_slot> slots, std::size_t n) noexcept -> void;
+
+    private:
+        std::array<::mmsghdr, max_count> msgs_{};
+        std::array<::iovec, max_count> iov_{};
+        std::array<::sockaddr_in6, max_count> peers_{}; // large enough for either family
+        unsigned count_ = 0;
+    };
+}
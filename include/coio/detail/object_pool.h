@@ -1,25 +1,115 @@
 #pragma once
+#include <array>
 #include <concepts>
-#include <functional>
+#include <cstddef>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <type_traits>
 #include <utility>
+#include <vector>
+#include <coio/detail/atomic_intrusive_stack.h>
 #include <coio/detail/config.h>
 #include <coio/utils/atomutex.h>
 #include <coio/utils/new_object.h>
 #include <coio/detail/suppress_push.h> // IWYU pragma: keep
 
 namespace coio::detail {
+    // a small number for each live thread; once a thread exits, the next thread to start gets its number.
+    // Thread-local destructors that run after the number was given back see `none`.
+    class thread_index {
+    public:
+        static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE static auto current() noexcept -> std::size_t {
+            if (current_ == unassigned) [[unlikely]] assign();
+            return current_;
+        }
+
+    private:
+        static constexpr std::size_t unassigned = none - 1;
+
+        struct registry {
+            atomutex lock;
+            std::vector<std::size_t> released;
+            std::size_t next = 0;
+        };
+
+        thread_index() noexcept {
+            auto& r = get_registry();
+            std::scoped_lock _{r.lock};
+            try {
+                r.released.reserve(r.next + 1); // so that giving it back can't fail
+            }
+            catch (...) {
+                current_ = none;
+                return;
+            }
+            if (r.released.empty()) value_ = r.next++;
+            else {
+                value_ = r.released.back();
+                r.released.pop_back();
+            }
+            current_ = value_;
+        }
+
+        thread_index(const thread_index&) = delete;
+
+        ~thread_index() {
+            // the number may go to another thread from now on
+            current_ = none;
+            if (value_ == none) return;
+            auto& r = get_registry();
+            std::scoped_lock _{r.lock};
+            r.released.push_back(value_);
+        }
+
+        auto operator= (const thread_index&) -> thread_index& = delete;
+
+        static auto assign() noexcept -> void {
+            thread_local const thread_index index;
+        }
+
+        static auto get_registry() noexcept -> registry& {
+            static registry instance;
+            return instance;
+        }
+
+    private:
+        static inline thread_local constinit std::size_t current_ = unassigned; // trivially destructible: valid to the thread's end
+        std::size_t value_ = none;
+    };
+
+    COIO_MSVC_SUPPRESS_PUSH()
+    COIO_MSVC_IGNORE(4324) // ignore C4324: structure was padded due to alignment specifier
+    // objects recycled rather than freed: an object stays allocated, and its memory valid, until the pool is destroyed.
+    // Each thread keeps a magazine of free objects, which `acquire` and `release` use without any atomic operation.
+    // Once a thread has released `2 * magazine_size` objects into its magazine, it hands `magazine_size` of them over to
+    // a lock-free stack shared by every thread; a thread whose magazine runs dry takes that whole stack at once.
+    // Threads without a magazine take the shared stack into a spare chain under a lock and acquire from it one by one.
     template<typename T, auto NextAccessor, typename Allocator = std::allocator<T>>
     class object_pool {
         static_assert(std::is_object_v<T> && !std::is_array_v<T>);
         static_assert(std::same_as<std::remove_cv_t<T>, T>);
-        static_assert(std::is_nothrow_invocable_r_v<T*, decltype(NextAccessor), T*>);
+        static_assert(std::same_as<decltype(NextAccessor), T* T::*>, "`NextAccessor` shall be the pointer to a `T*` member of `T`.");
     public:
         using value_type = T;
         using allocator_type = std::allocator_traits<Allocator>::template rebind_alloc<T>;
 
+        /// how many released objects a thread hands over to the others at once
+        static constexpr std::size_t magazine_size = 32;
+
+        /// the threads with a magazine of their own; the others use the shared stack directly
+        static constexpr std::size_t max_magazines = 64;
+
+    private:
+        struct alignas(64) magazine {
+            T* released = nullptr; // released by this thread, most recent first
+            std::size_t released_count = 0;
+            T* loaded = nullptr;   // taken from the shared stack
+        };
+
     public:
         object_pool() = default;
 
@@ -29,9 +119,13 @@ namespace coio::detail {
 
         /// \note: All calls to `acquire` or `release` shall happen before this destructor!
         ~object_pool() {
-            while (free_list_ != nullptr) {
-                T* entry = std::exchange(free_list_, std::invoke(NextAccessor, free_list_));
-                coio::delete_object(alloc_, entry);
+            delete_chain(shared_.pop_all());
+            delete_chain(spare_);
+            for (magazine*& m : magazines_) {
+                if (m == nullptr) continue;
+                delete_chain(m->released);
+                delete_chain(m->loaded);
+                coio::delete_object(alloc_, std::exchange(m, nullptr));
             }
         }
 
@@ -39,18 +133,37 @@ namespace coio::detail {
 
         [[nodiscard]]
         COIO_ALWAYS_INLINE auto acquire() -> T* {
-            {
-                std::scoped_lock _{lock_};
-                if (free_list_ != nullptr) {
-                    return std::exchange(free_list_, std::invoke(NextAccessor, free_list_));
-                }
+            magazine* m = local_magazine(true);
+            if (m == nullptr) [[unlikely]] return acquire_shared();
+            if (m->released != nullptr) {
+                --m->released_count;
+                return pop(m->released);
             }
-            return coio::new_object<T>(alloc_);
+            if (m->loaded == nullptr) {
+                m->loaded = shared_.pop_all();
+                if (m->loaded == nullptr) m->loaded = take_spare();
+                if (m->loaded == nullptr) return coio::new_object<T>(alloc_);
+            }
+            return pop(m->loaded);
         }
 
         COIO_ALWAYS_INLINE auto release(T& obj) noexcept -> void {
-            std::scoped_lock _{lock_};
-            std::invoke(NextAccessor, std::addressof(obj)) = std::exchange(free_list_, std::addressof(obj));
+            magazine* m = local_magazine(false);
+            if (m == nullptr) [[unlikely]] {
+                static_cast<void>(shared_.push(obj));
+                return;
+            }
+            obj.*NextAccessor = std::exchange(m->released, std::addressof(obj));
+            if (++m->released_count == 2 * magazine_size) {
+                // keep the most recently released half, still warm in cache
+                T* last_kept = m->released;
+                for (std::size_t i = 1; i < magazine_size; ++i) last_kept = last_kept->*NextAccessor;
+                T* first = std::exchange(last_kept->*NextAccessor, nullptr);
+                T* last = first;
+                for (std::size_t i = 1; i < magazine_size; ++i) last = last->*NextAccessor;
+                static_cast<void>(shared_.push_chain(*first, *last));
+                m->released_count = magazine_size;
+            }
         }
 
         [[nodiscard]]
@@ -58,11 +171,48 @@ namespace coio::detail {
             return alloc_;
         }
 
+    private:
+        COIO_ALWAYS_INLINE static auto pop(T*& chain) noexcept -> T* {
+            return std::exchange(chain, std::exchange(chain->*NextAccessor, nullptr));
+        }
+
+        // the calling thread's magazine, created if `create`; null if it has none
+        COIO_ALWAYS_INLINE auto local_magazine(bool create) -> magazine* {
+            const std::size_t index = thread_index::current();
+            if (index >= max_magazines) [[unlikely]] return nullptr;
+            magazine*& m = magazines_[index]; // only ever touched by the thread holding `index`
+            if (m == nullptr and create) m = coio::new_object<magazine>(alloc_);
+            return m;
+        }
+
+        // for threads without a magazine: one object off the spare chain, refilled with the whole shared stack
+        auto acquire_shared() -> T* {
+            {
+                std::scoped_lock _{spare_lock_};
+                if (spare_ == nullptr) spare_ = shared_.pop_all();
+                if (spare_ != nullptr) return pop(spare_);
+            }
+            return coio::new_object<T>(alloc_);
+        }
+
+        // the spare chain, so that a dry magazine doesn't allocate while free objects sit there
+        auto take_spare() noexcept -> T* {
+            std::scoped_lock _{spare_lock_};
+            return std::exchange(spare_, nullptr);
+        }
+
+        auto delete_chain(T* chain) noexcept -> void {
+            while (chain != nullptr) coio::delete_object(alloc_, pop(chain));
+        }
+
     private:
         COIO_NO_UNIQUE_ADDRESS allocator_type alloc_;
-        atomutex lock_;
-        T* free_list_{nullptr};
+        atomic_intrusive_stack<T> shared_{NextAccessor};
+        atomutex spare_lock_;
+        T* spare_ = nullptr; // taken from `shared_` by the threads without a magazine
+        std::array<magazine*, max_magazines> magazines_{};
     };
+    COIO_MSVC_SUPPRESS_POP()
 }
 
 #include <coio/detail/suppress_pop.h> // IWYU pragma: keep
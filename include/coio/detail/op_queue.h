@@ -11,6 +11,7 @@
 #include <utility>
 #include <coio/detail/config.h>
 #include <coio/detail/intrusive_list.h>
+#include <coio/detail/timer_wheel.h>
 #include <coio/utils/atomutex.h>
 #include <coio/detail/suppress_push.h> // IWYU pragma: keep
 
@@ -111,15 +112,39 @@ namespace coio::detail {
         Op* sibling = nullptr;
     };
 
+    template<typename Op, auto Proj, auto WheelLinksAccessor>
+    struct timer_wheel_for {
+        using type = timer_wheel<Op, Proj, WheelLinksAccessor>;
+    };
+
+    template<typename Op, auto Proj>
+    struct timer_wheel_for<Op, Proj, nullptr> {
+        struct type {};
+    };
+
     // intrusive pairing heap: no allocation, every operation is noexcept;
-    // `add` is O(1), `remove`/`take_ready_timers` pop in amortized O(log n)
-    template<typename Op, std::regular_invocable<const Op&> auto Proj, auto LinksAccessor>
+    // `add` is O(1), `remove`/`take_ready_timers` pop in amortized O(log n).
+    // Given `WheelLinksAccessor`, `set_tick` can also enable a `timer_wheel` in front of the heap:
+    // timers due after the current tick wait there with O(1) `add`/`remove`, and move to the heap once their tick begins.
+    // Timers are ordered by `Proj`, the latest they may fire; `take_ready_timers` pops them from the front for as long as
+    // `ReadyProj`, the earliest they may fire, has passed, so one wakeup also takes the timers that tolerate firing early.
+    template<
+        typename Op,
+        std::regular_invocable<const Op&> auto Proj,
+        auto LinksAccessor,
+        auto WheelLinksAccessor = nullptr,
+        std::regular_invocable<const Op&> auto ReadyProj = Proj
+    >
         requires std::three_way_comparable_with<
             std::chrono::steady_clock::time_point, std::invoke_result_t<decltype(Proj), const Op&>
+        > and std::three_way_comparable_with<
+            std::chrono::steady_clock::time_point, std::invoke_result_t<decltype(ReadyProj), const Op&>
         > and std::is_nothrow_invocable_r_v<timer_heap_links<Op>&, decltype(LinksAccessor), Op&>
     class timer_queue {
     private:
         using reference = Op&;
+        static constexpr bool has_wheel = not std::is_null_pointer_v<decltype(WheelLinksAccessor)>;
+        using wheel_type = typename timer_wheel_for<Op, Proj, WheelLinksAccessor>::type;
 
     public:
         timer_queue() = default;
@@ -132,13 +157,20 @@ namespace coio::detail {
 
         COIO_ALWAYS_INLINE auto add(reference op) noexcept -> bool {
             std::scoped_lock _{mtx_};
-            links(op) = {};
-            root_ = root_ == nullptr ? &op : meld(root_, &op);
-            return root_ == &op;
+            if constexpr (has_wheel) {
+                if (wheel_.enabled()) {
+                    const auto before = earliest_locked();
+                    if (wheel_.insert(op)) return not before or *wheel_.next_due() < *before;
+                }
+            }
+            return push(op);
         }
 
         COIO_ALWAYS_INLINE auto remove(reference op) noexcept -> bool {
             std::scoped_lock _{mtx_};
+            if constexpr (has_wheel) {
+                if (wheel_.remove(op)) return true;
+            }
             if (&op == root_) {
                 static_cast<void>(pop_root());
                 return true;
@@ -156,7 +188,10 @@ namespace coio::detail {
         COIO_ALWAYS_INLINE auto take_ready_timers(intrusive_list<BaseOp>& list) noexcept -> void {
             std::scoped_lock _{mtx_};
             const auto now = std::chrono::steady_clock::now();
-            while (root_ != nullptr and now >= std::invoke(Proj, *root_)) {
+            if constexpr (has_wheel) {
+                wheel_.advance(now, [this](reference op) noexcept { static_cast<void>(push(op)); });
+            }
+            while (root_ != nullptr and now >= std::invoke(ReadyProj, *root_)) {
                 list.push_back(*pop_root());
             }
         }
@@ -164,11 +199,37 @@ namespace coio::detail {
         [[nodiscard]]
         COIO_ALWAYS_INLINE auto earliest() noexcept -> std::optional<std::chrono::steady_clock::time_point> {
             std::scoped_lock _{mtx_};
-            if (root_ == nullptr) return {};
-            return std::invoke(Proj, *root_);
+            return earliest_locked();
+        }
+
+        /**
+         * \brief keep timers due after the current tick of `tick` in the timing wheel, zero to keep every timer in the heap.
+         * \note the timers already waiting are moved over; `earliest` may then report the start of a tick rather than
+         * a deadline, which only wakes the consumer early.
+         */
+        auto set_tick(std::chrono::steady_clock::duration tick) noexcept -> void requires has_wheel {
+            std::scoped_lock _{mtx_};
+            wheel_.reset(tick, std::chrono::steady_clock::now(), [this](reference op) noexcept { static_cast<void>(push(op)); });
         }
 
     private:
+        // pre: `mtx_` is held
+        COIO_ALWAYS_INLINE auto push(reference op) noexcept -> bool {
+            links(op) = {};
+            root_ = root_ == nullptr ? &op : meld(root_, &op);
+            return root_ == &op;
+        }
+
+        // pre: `mtx_` is held
+        COIO_ALWAYS_INLINE auto earliest_locked() const noexcept -> std::optional<std::chrono::steady_clock::time_point> {
+            std::optional<std::chrono::steady_clock::time_point> result;
+            if (root_ != nullptr) result = std::invoke(Proj, *root_);
+            if constexpr (has_wheel) {
+                if (const auto due = wheel_.next_due(); due and (not result or *due < *result)) result = due;
+            }
+            return result;
+        }
+
         COIO_ALWAYS_INLINE static auto links(reference op) noexcept -> timer_heap_links<Op>& {
             return std::invoke(LinksAccessor, op);
         }
@@ -234,6 +295,7 @@ namespace coio::detail {
 
     private:
         Op* root_ = nullptr;
+        [[no_unique_address]] wheel_type wheel_;
         atomutex mtx_;
     };
 }
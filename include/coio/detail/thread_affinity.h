@@ -0,0 +1,13 @@
+#pragma once
+#include <thread>
+#include <vector>
+#include <coio/detail/config.h>
+
+namespace coio::detail {
+    /// the CPUs the calling process may run on, in ascending order.
+    [[nodiscard]]
+    auto allowed_cpus() -> std::vector<unsigned>;
+
+    /// pin `thread` to `cpu`. \throw std::system_error on failure
+    auto pin_thread(std::thread::native_handle_type thread, unsigned cpu) -> void;
+}
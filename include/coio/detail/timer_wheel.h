@@ -0,0 +1,204 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <coio/detail/config.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio::detail {
+    template<typename Op>
+    struct timer_wheel_links {
+        static constexpr std::uint16_t no_slot = 0xffff;
+
+        // neighbours in the slot's list; `slot` is `level * 64 + index`, `no_slot` when the node isn't in the wheel
+        Op* prev = nullptr;
+        Op* next = nullptr;
+        std::uint16_t slot = no_slot;
+    };
+
+    // hierarchical timing wheel: 4 levels of 64 slots, each level 64 times coarser than the one below;
+    // `insert`/`remove` are O(1), a timer is moved down a level at most 3 times before it's handed back.
+    // A timer is handed back when the tick its deadline falls in begins, so the caller keeps it
+    // (e.g. in a heap) for the sub-tick remainder. Not synchronized.
+    template<typename Op, std::regular_invocable<const Op&> auto Proj, auto LinksAccessor>
+        requires std::same_as<std::remove_cvref_t<std::invoke_result_t<decltype(Proj), const Op&>>, std::chrono::steady_clock::time_point>
+            and std::is_nothrow_invocable_r_v<timer_wheel_links<Op>&, decltype(LinksAccessor), Op&>
+    class timer_wheel {
+    private:
+        using time_point = std::chrono::steady_clock::time_point;
+        using duration = std::chrono::steady_clock::duration;
+
+        static constexpr unsigned level_bits = 6;
+        static constexpr unsigned slots_per_level = 1u << level_bits;
+        static constexpr unsigned levels = 4;
+        // timers further out are parked in the last slot reachable, and placed again when it comes due
+        static constexpr std::uint64_t span = std::uint64_t{1} << level_bits * levels;
+
+    public:
+        timer_wheel() = default;
+
+        timer_wheel(const timer_wheel&) = delete;
+
+        ~timer_wheel() = default;
+
+        auto operator= (const timer_wheel&) -> timer_wheel& = delete;
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto enabled() const noexcept -> bool {
+            return tick_ != duration::zero();
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto size() const noexcept -> std::size_t {
+            return size_;
+        }
+
+        /// start counting ticks of `tick` from `now`; every timer in the wheel is placed again, or handed to `overflow`
+        /// if it's due within the first tick. A zero `tick` disables the wheel and hands every timer to `overflow`.
+        template<std::invocable<Op&> Overflow>
+        auto reset(duration tick, time_point now, Overflow&& overflow) noexcept -> void {
+            Op* all = nullptr;
+            for (unsigned slot = 0; slot < levels * slots_per_level; ++slot) {
+                for (Op* op = std::exchange(heads_[slot], nullptr); op != nullptr;) {
+                    Op* next = links(*op).next;
+                    links(*op).next = all;
+                    all = op;
+                    op = next;
+                }
+            }
+            std::ranges::fill(occupied_, 0);
+            size_ = 0;
+            tick_ = tick;
+            origin_ = now;
+            current_ = 0;
+            while (all != nullptr) {
+                Op& op = *all;
+                all = links(op).next;
+                links(op) = {};
+                if (not enabled() or not insert(op)) std::invoke(overflow, op);
+            }
+        }
+
+        /// \return false if `op` is due within the current tick (or the wheel is disabled), and wasn't added.
+        COIO_ALWAYS_INLINE auto insert(Op& op) noexcept -> bool {
+            if (not enabled()) return false;
+            const std::int64_t tick = tick_of(std::invoke(Proj, op));
+            if (tick <= static_cast<std::int64_t>(current_)) return false;
+            const std::uint64_t target = std::min(static_cast<std::uint64_t>(tick), current_ + span - 1);
+            const unsigned level = (std::bit_width(target - current_) - 1) / level_bits;
+            const unsigned index = target >> level * level_bits & (slots_per_level - 1);
+            const auto slot = static_cast<std::uint16_t>(level * slots_per_level + index);
+
+            auto& l = links(op);
+            l.prev = nullptr;
+            l.next = heads_[slot];
+            l.slot = slot;
+            if (l.next) links(*l.next).prev = &op;
+            heads_[slot] = &op;
+            occupied_[level] |= std::uint64_t{1} << index;
+            ++size_;
+            return true;
+        }
+
+        /// \return false if `op` isn't in the wheel.
+        COIO_ALWAYS_INLINE auto remove(Op& op) noexcept -> bool {
+            auto& l = links(op);
+            if (l.slot == timer_wheel_links<Op>::no_slot) return false;
+            if (l.prev) links(*l.prev).next = l.next;
+            else heads_[l.slot] = l.next;
+            if (l.next) links(*l.next).prev = l.prev;
+            if (heads_[l.slot] == nullptr) {
+                occupied_[l.slot / slots_per_level] &= ~(std::uint64_t{1} << l.slot % slots_per_level);
+            }
+            l = {};
+            --size_;
+            return true;
+        }
+
+        /// move the wheel up to `now`, handing every timer whose tick has begun to `due`.
+        template<std::invocable<Op&> Due>
+        auto advance(time_point now, Due&& due) noexcept -> void {
+            if (not enabled()) return;
+            const std::int64_t target = tick_of(now);
+            if (target <= static_cast<std::int64_t>(current_)) return;
+            // jump from one occupied slot to the next instead of walking every tick
+            while (const auto next = next_event()) {
+                if (static_cast<std::int64_t>(*next) > target) break;
+                current_ = *next;
+                // coarser levels first: what they hand down may be due in a finer slot of this very tick
+                for (unsigned level = levels; level-- > 0;) {
+                    const unsigned shift = level * level_bits;
+                    if (current_ & ((std::uint64_t{1} << shift) - 1)) continue;
+                    flush(level, current_ >> shift & (slots_per_level - 1), due);
+                }
+            }
+            current_ = static_cast<std::uint64_t>(target);
+        }
+
+        /// \return when the next slot comes due, `std::nullopt` if the wheel is empty.
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto next_due() const noexcept -> std::optional<time_point> {
+            const auto next = next_event();
+            if (not next) return {};
+            return origin_ + tick_ * static_cast<duration::rep>(*next);
+        }
+
+    private:
+        COIO_ALWAYS_INLINE static auto links(Op& op) noexcept -> timer_wheel_links<Op>& {
+            return std::invoke(LinksAccessor, op);
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto tick_of(time_point tp) const noexcept -> std::int64_t {
+            return (tp - origin_) / tick_;
+        }
+
+        // the first tick after `current_` at which an occupied slot is flushed
+        [[nodiscard]]
+        auto next_event() const noexcept -> std::optional<std::uint64_t> {
+            if (size_ == 0) return {};
+            std::optional<std::uint64_t> result;
+            for (unsigned level = 0; level < levels; ++level) {
+                if (occupied_[level] == 0) continue;
+                const unsigned shift = level * level_bits;
+                const std::uint64_t base = current_ >> shift;
+                // the slots in turn after the one `current_` is in; that one itself comes due again last
+                const auto rotated = std::rotr(occupied_[level], static_cast<int>((base + 1) & (slots_per_level - 1)));
+                const std::uint64_t tick = (base + 1 + std::countr_zero(rotated)) << shift;
+                if (not result or tick < *result) result = tick;
+            }
+            return result;
+        }
+
+        template<typename Due>
+        auto flush(unsigned level, std::uint64_t index, Due& due) noexcept -> void {
+            const auto slot = level * slots_per_level + index;
+            Op* op = std::exchange(heads_[slot], nullptr);
+            occupied_[level] &= ~(std::uint64_t{1} << index);
+            while (op != nullptr) {
+                Op& current = *op;
+                op = links(current).next;
+                links(current) = {};
+                --size_;
+                if (not insert(current)) std::invoke(due, current);
+            }
+        }
+
+    private:
+        Op* heads_[levels * slots_per_level]{};
+        std::uint64_t occupied_[levels]{};
+        std::size_t size_ = 0;
+        duration tick_{};
+        time_point origin_{};
+        std::uint64_t current_ = 0; // every tick up to this one has been flushed
+    };
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
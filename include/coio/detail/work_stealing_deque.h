@@ -0,0 +1,90 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <coio/detail/config.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio::detail {
+    COIO_MSVC_SUPPRESS_PUSH()
+    COIO_MSVC_IGNORE(4324) // ignore C4324: structure was padded due to alignment specifier
+    // Bounded Chase-Lev deque: the owner pushes and pops at the bottom (LIFO), thieves steal from the top (FIFO).
+    // Every index access is sequentially consistent instead of relying on standalone fences, which TSAN can't model.
+    template<typename T, std::size_t Capacity> requires (std::has_single_bit(Capacity))
+    class work_stealing_deque {
+    public:
+        work_stealing_deque() = default;
+
+        work_stealing_deque(const work_stealing_deque&) = delete;
+
+        ~work_stealing_deque() = default;
+
+        auto operator= (const work_stealing_deque&) -> work_stealing_deque& = delete;
+
+        /// owner only. \return false if the deque is full
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto push(T* item) noexcept -> bool {
+            const auto bottom = bottom_.load(std::memory_order_relaxed);
+            const auto top = top_.load(std::memory_order_acquire);
+            if (bottom - top >= static_cast<std::int64_t>(Capacity)) return false;
+            slot(bottom).store(item, std::memory_order_release);
+            bottom_.store(bottom + 1, std::memory_order_seq_cst);
+            return true;
+        }
+
+        /// owner only
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto pop() noexcept -> T* {
+            const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+            bottom_.store(bottom, std::memory_order_seq_cst);
+            auto top = top_.load(std::memory_order_seq_cst);
+            if (top > bottom) {
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            T* item = slot(bottom).load(std::memory_order_acquire);
+            if (top == bottom) {
+                // the last item: race the thieves for it
+                if (not top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    item = nullptr;
+                }
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+            }
+            return item;
+        }
+
+        /// any thread. \return null if the deque is empty or another thread won the race
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto steal() noexcept -> T* {
+            auto top = top_.load(std::memory_order_seq_cst);
+            const auto bottom = bottom_.load(std::memory_order_seq_cst);
+            if (top >= bottom) return nullptr;
+            T* item = slot(top).load(std::memory_order_acquire);
+            if (not top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return item;
+        }
+
+        /// any thread, a snapshot
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto empty() const noexcept -> bool {
+            return bottom_.load(std::memory_order_seq_cst) <= top_.load(std::memory_order_seq_cst);
+        }
+
+    private:
+        COIO_ALWAYS_INLINE auto slot(std::int64_t index) noexcept -> std::atomic<T*>& {
+            return slots_[static_cast<std::size_t>(index) & (Capacity - 1)];
+        }
+
+    private:
+        alignas(64) std::atomic<std::int64_t> top_{0};
+        alignas(64) std::atomic<std::int64_t> bottom_{0};
+        alignas(64) std::array<std::atomic<T*>, Capacity> slots_{};
+    };
+    COIO_MSVC_SUPPRESS_POP()
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
@@ -1,6 +1,7 @@
 ﻿// ReSharper disable CppPolymorphicClassWithNonVirtualPublicDestructor
 // ReSharper disable CppRedundantTypenameKeyword
 #pragma once
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <exception>
@@ -16,6 +17,7 @@
 #include <utility>
 #include <coio/detail/execution.h>
 #include <coio/detail/op_queue.h>
+#include <coio/utils/buffer_pool.h>
 #include <coio/utils/scope_exit.h>
 #include <coio/utils/stop_token.h>
 #include <coio/detail/suppress_push.h> // IWYU pragma: keep
@@ -24,6 +26,26 @@ namespace coio {
     template<typename T, typename Alloc, typename Sched>
     class task;
 
+    /**
+     * \brief query for the `buffer_pool` of a context, answered by its scheduler and by the environment of its senders.
+     */
+    struct get_buffer_pool_t {
+        template<typename Env> requires requires (const Env& env) {
+            { env.query(std::declval<get_buffer_pool_t>()) } -> std::same_as<buffer_pool&>;
+        }
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE COIO_STATIC_CALL_OP auto operator() (const Env& env) COIO_STATIC_CALL_OP_CONST noexcept -> buffer_pool& {
+            return env.query(get_buffer_pool_t{});
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE static constexpr auto query(forwarding_query_t) noexcept -> bool {
+            return true;
+        }
+    };
+
+    inline constexpr get_buffer_pool_t get_buffer_pool{};
+
     namespace detail {
         enum class operation_phase : unsigned char {
             starting,
@@ -37,6 +59,9 @@ namespace coio {
             pending
         };
 
+        /// inline completions nested on this thread's stack, across every context
+        inline thread_local std::size_t inline_completion_depth = 0;
+
         template<typename Ctx>
         class loop_base {
             friend Ctx;
@@ -54,9 +79,7 @@ namespace coio {
 
                 COIO_ALWAYS_INLINE auto immediately_post() -> void {
                     COIO_ASSERT(next_ == nullptr);
-                    auto& context = context_;
-                    context.op_queue_.enqueue(*this);
-                    context.wakeup_consumer();
+                    context_.post(*this);
                 }
 
                 auto publish() noexcept -> void {
@@ -114,6 +137,7 @@ namespace coio {
 
                     if (this->do_start() == start_result::completed) {
                         this->publish();
+                        if (this->context_.try_finish_inline(*this)) return;
                         return this->immediately_post();
                     }
 
@@ -183,6 +207,10 @@ namespace coio {
                     return ctx_.get_allocator();
                 }
 
+                auto query(get_buffer_pool_t) const noexcept -> buffer_pool& {
+                    return ctx_.get_buffer_pool();
+                }
+
                 Ctx& ctx_; // NOLINT(*-avoid-const-or-ref-data-members)
             };
 
@@ -258,14 +286,18 @@ namespace coio {
                 using time_point_type = clock_type::time_point;
 
                 struct timer_node : node {
-                    timer_node(Ctx& context, time_point_type deadline) noexcept: node(context), deadline(deadline) {}
-                    time_point_type deadline;
+                    timer_node(Ctx& context, time_point_type not_before, time_point_type deadline) noexcept:
+                        node(context), not_before(not_before), deadline(deadline) {}
+                    time_point_type not_before; // the requested expiry
+                    time_point_type deadline;   // the requested expiry plus the slack: the latest it may fire
                     detail::timer_heap_links<timer_node> heap_links;
+                    detail::timer_wheel_links<timer_node> wheel_links;
                 };
 
                 template<typename Rcvr>
                 struct state_base : timer_node {
-                    state_base(Rcvr rcvr, Ctx& context, time_point_type deadline) noexcept: timer_node(context, deadline), rcvr_(std::move(rcvr)) {}
+                    state_base(Rcvr rcvr, Ctx& context, time_point_type not_before, time_point_type deadline) noexcept:
+                        timer_node(context, not_before, deadline), rcvr_(std::move(rcvr)) {}
 
                     auto do_start() noexcept -> start_result {
                         auto& context = this->context_;
@@ -293,11 +325,15 @@ namespace coio {
                 using state = operation_state<state_base<Rcvr>>;
 
             public:
-                sleep_sender(Ctx& context, time_point_type deadline) noexcept : ctx_(&context), deadline_(deadline) {}
+                sleep_sender(Ctx& context, time_point_type deadline, duration_type slack = {}) noexcept :
+                    ctx_(&context), deadline_(deadline), slack_(slack) {}
 
                 sleep_sender(const sleep_sender&) = delete;
 
-                sleep_sender(sleep_sender&& other) noexcept : ctx_(std::exchange(other.ctx_, {})), deadline_(std::exchange(other.deadline_, {})) {}
+                sleep_sender(sleep_sender&& other) noexcept :
+                    ctx_(std::exchange(other.ctx_, {})),
+                    deadline_(std::exchange(other.deadline_, {})),
+                    slack_(std::exchange(other.slack_, {})) {}
 
                 ~sleep_sender() = default;
 
@@ -306,6 +342,7 @@ namespace coio {
                 auto operator= (sleep_sender&& other) noexcept -> sleep_sender& {
                     ctx_ = std::exchange(other.ctx_, {});
                     deadline_ = std::exchange(other.deadline_, {});
+                    slack_ = std::exchange(other.slack_, {});
                     return *this;
                 }
 
@@ -321,16 +358,21 @@ namespace coio {
                 template<execution::receiver Rcvr>
                 COIO_ALWAYS_INLINE auto connect(Rcvr rcvr) && noexcept {
                     COIO_ASSERT(ctx_ != nullptr);
+                    const auto deadline = std::exchange(deadline_, {});
+                    const auto slack = std::exchange(slack_, {});
                     return state<Rcvr>{
                         std::move(rcvr),
                         *std::exchange(ctx_, {}),
-                        std::exchange(deadline_, {})
+                        deadline,
+                        // saturate rather than wrap for deadlines near `time_point::max()`
+                        slack > time_point_type::max() - deadline ? time_point_type::max() : deadline + slack
                     };
                 }
 
             private:
                 Ctx* ctx_;
                 time_point_type deadline_;
+                duration_type slack_;
             };
 
         private:
@@ -357,11 +399,38 @@ namespace coio {
                     return this->schedule_at(now() + std::chrono::ceil<std::chrono::steady_clock::duration>(duration));
                 }
 
+                /**
+                 * \brief like `schedule_after(duration)`, but the timer may fire up to `slack` late, so that the context
+                 * can wake up once for several timers.
+                 */
+                template<typename Rep, typename Period, typename SlackRep, typename SlackPeriod>
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto schedule_after(
+                    std::chrono::duration<Rep, Period> duration,
+                    std::chrono::duration<SlackRep, SlackPeriod> slack
+                ) const noexcept {
+                    return this->schedule_at(now() + std::chrono::ceil<std::chrono::steady_clock::duration>(duration), slack);
+                }
+
                 [[nodiscard]]
                 COIO_ALWAYS_INLINE auto schedule_at(std::chrono::steady_clock::time_point deadline) const noexcept {
+                    return this->schedule_at(deadline, ctx_->timer_slack_.load(std::memory_order_relaxed));
+                }
+
+                /**
+                 * \brief like `schedule_at(deadline)`, but the timer may fire up to `slack` late, so that the context
+                 * can wake up once for several timers.
+                 */
+                template<typename SlackRep, typename SlackPeriod>
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto schedule_at(
+                    std::chrono::steady_clock::time_point deadline,
+                    std::chrono::duration<SlackRep, SlackPeriod> slack
+                ) const noexcept {
                     return stop_when(sleep_sender{
                         *ctx_,
-                        deadline
+                        deadline,
+                        std::max(std::chrono::ceil<std::chrono::steady_clock::duration>(slack), std::chrono::steady_clock::duration::zero())
                     }, ctx_->stop_source_.get_token());
                 }
 
@@ -382,6 +451,12 @@ namespace coio {
                     return ctx_->get_allocator();
                 }
 
+                [[nodiscard]]
+                COIO_ALWAYS_INLINE auto query(get_buffer_pool_t) const noexcept -> buffer_pool& {
+                    COIO_ASSERT(ctx_ != nullptr);
+                    return ctx_->get_buffer_pool();
+                }
+
                 friend auto operator== (const scheduler_base& lhs, const scheduler_base& rhs) -> bool = default;
 
             protected:
@@ -391,7 +466,9 @@ namespace coio {
             using timer_queue = detail::timer_queue<
                 typename sleep_sender::timer_node,
                 &sleep_sender::timer_node::deadline,
-                &sleep_sender::timer_node::heap_links
+                &sleep_sender::timer_node::heap_links,
+                &sleep_sender::timer_node::wheel_links,
+                &sleep_sender::timer_node::not_before
             >;
 
             using op_queue = detail::op_queue<node, &node::next_>;
@@ -399,7 +476,8 @@ namespace coio {
         private:
             loop_base() = default;
 
-            explicit loop_base(std::pmr::memory_resource& memory_resource) noexcept : allocator_(&memory_resource) {}
+            explicit loop_base(std::pmr::memory_resource& memory_resource) :
+                allocator_(&memory_resource), buffer_pool_(memory_resource) {}
 
             ~loop_base() {
                 if (work_count_.load(std::memory_order_acquire) != 0) [[unlikely]] {
@@ -423,10 +501,75 @@ namespace coio {
                 return allocator_;
             }
 
+            /**
+             * \brief the pool for transient I/O buffers, drawing from the context's memory resource.
+             * \note it is `buffer_pool::current()` on the threads running the context.
+             */
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto get_buffer_pool() noexcept -> buffer_pool& {
+                return buffer_pool_;
+            }
+
             COIO_ALWAYS_INLINE auto request_stop() -> void {
                 if (stop_source_.request_stop()) shutdown();
             }
 
+            /**
+             * \brief let an operation that completes while it starts (e.g. a read with data already buffered) complete
+             * inline on the starting thread, instead of through the ready queue, when that thread is the consumer.
+             * \param max_depth how many such completions may nest on one thread's stack before the next one is queued
+             * again, `0` (the default) to always queue.
+             * \note thread-safe; it applies to operations started afterwards.
+             */
+            COIO_ALWAYS_INLINE auto set_inline_completion_depth(std::size_t max_depth) noexcept -> void {
+                inline_completion_limit_.store(max_depth, std::memory_order_relaxed);
+            }
+
+            /**
+             * \brief bound how much ready work the consumer runs between two looks at I/O and timers.
+             *
+             * Without a budget, the consumer only polls again once the ready queue is empty, so continuations that keep
+             * scheduling each other can hold off I/O completions and timers indefinitely. With one, once the budget is
+             * spent the consumer polls without blocking, publishes what became ready, and starts a new budget.
+             * \param max_ops how many ready operations to run before polling again, `0` (the default) for no limit.
+             * \param max_time how long to run ready operations before polling again, zero (the default) for no limit.
+             * \note thread-safe; it applies from the consumer's next operation on.
+             */
+            COIO_ALWAYS_INLINE auto set_drain_budget(std::size_t max_ops, std::chrono::nanoseconds max_time = {}) noexcept -> void {
+                drain_max_ops_.store(max_ops, std::memory_order_relaxed);
+                drain_max_time_.store(max_time, std::memory_order_relaxed);
+            }
+
+            /**
+             * \brief keep timers in a hierarchical timing wheel of `tick` granularity until their tick begins.
+             *
+             * Timers are kept in a heap by default, where adding and cancelling one costs O(log n). With many long
+             * timers that are mostly cancelled before they fire, e.g. idle timeouts, the wheel makes both O(1). A timer
+             * moves from the wheel to the heap once the tick its deadline falls in begins, so it still fires on time.
+             * \param tick the wheel's granularity, zero to keep every timer in the heap.
+             * \note thread-safe; the pending timers are moved over.
+             */
+            auto set_timer_tick(std::chrono::nanoseconds tick) noexcept -> void {
+                timer_queue_.set_tick(std::chrono::ceil<std::chrono::steady_clock::duration>(tick));
+                wakeup_consumer(); // the earliest wakeup may have moved
+            }
+
+            /**
+             * \brief let every timer started without an explicit slack fire up to `slack` late.
+             *
+             * The consumer wakes up when the first timer runs out of slack, and also fires every other timer that is due
+             * by then. Nearby timers thus share one wakeup, which matters for servers with many idle timeouts.
+             * \param slack how late a timer may fire, zero (the default) to fire every timer as close to its deadline
+             * as the backend allows.
+             * \note thread-safe; it applies to timers started afterwards.
+             */
+            COIO_ALWAYS_INLINE auto set_timer_slack(std::chrono::nanoseconds slack) noexcept -> void {
+                timer_slack_.store(
+                    std::max(std::chrono::ceil<std::chrono::steady_clock::duration>(slack), std::chrono::steady_clock::duration::zero()),
+                    std::memory_order_relaxed
+                );
+            }
+
             COIO_ALWAYS_INLINE auto work_started() noexcept -> void {
                 ++work_count_;
             }
@@ -437,41 +580,59 @@ namespace coio {
 
             auto poll_one() -> bool {
                 auto self = static_cast<Ctx*>(this);
-                consumer_id_.store(std::this_thread::get_id(), std::memory_order_relaxed);
-                scope_exit _{[this]() noexcept { consumer_id_.store({}, std::memory_order_relaxed); }};
+                const auto _ = consume_on_this_thread();
                 return self->do_one(false);
             }
 
             auto poll() -> std::size_t {
                 auto self = static_cast<Ctx*>(this);
-                consumer_id_.store(std::this_thread::get_id(), std::memory_order_relaxed);
-                scope_exit _{[this]() noexcept { consumer_id_.store({}, std::memory_order_relaxed); }};
+                const auto _ = consume_on_this_thread();
                 std::size_t count = 0;
                 while (self->do_one(false)) {
-                    if (count < std::numeric_limits<std::size_t>::max()) ++count;
+                    // keep draining the ready queue without going through the backend, until the budget is spent
+                    do {
+                        if (count < std::numeric_limits<std::size_t>::max()) ++count;
+                    } while (consume());
                 }
                 return count;
             }
 
             auto run_one() -> bool {
                 auto self = static_cast<Ctx*>(this);
-                consumer_id_.store(std::this_thread::get_id(), std::memory_order_relaxed);
-                scope_exit _{[this]() noexcept { consumer_id_.store({}, std::memory_order_relaxed); }};
+                const auto _ = consume_on_this_thread();
                 return self->do_one(true);
             }
 
             auto run() -> std::size_t {
                 auto self = static_cast<Ctx*>(this);
-                consumer_id_.store(std::this_thread::get_id(), std::memory_order_relaxed);
-                scope_exit _{[this]() noexcept { consumer_id_.store({}, std::memory_order_relaxed); }};
+                const auto _ = consume_on_this_thread();
                 std::size_t count = 0;
                 while (self->do_one(true)) {
-                    if (count < std::numeric_limits<std::size_t>::max()) ++count;
+                    do {
+                        if (count < std::numeric_limits<std::size_t>::max()) ++count;
+                    } while (consume());
                 }
                 return count;
             }
 
         protected:
+            /// make this thread the consumer, and the context's buffer pool its current one, until the result is destroyed
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto consume_on_this_thread() noexcept {
+                consumer_id_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+                auto previous_pool = buffer_pool::set_current(&buffer_pool_);
+                return scope_exit{[this, previous_pool]() noexcept {
+                    consumer_id_.store({}, std::memory_order_relaxed);
+                    buffer_pool::set_current(previous_pool);
+                }};
+            }
+
+            /// hand a ready operation to the consumer; `Ctx` may hide this to queue ready operations its own way
+            COIO_ALWAYS_INLINE auto post(node& op) -> void {
+                op_queue_.enqueue(op);
+                wakeup_consumer();
+            }
+
             COIO_ALWAYS_INLINE static auto publish_pending(node* op) noexcept -> void {
                 while (op != nullptr) {
                     auto next = std::exchange(op->next_, nullptr);
@@ -480,10 +641,51 @@ namespace coio {
                 }
             }
 
+            /// complete `op`, which completed while it started, right here if the inline policy allows it
+            COIO_ALWAYS_INLINE auto try_finish_inline(node& op) -> bool {
+                auto& depth = detail::inline_completion_depth;
+                if (depth >= inline_completion_limit_.load(std::memory_order_relaxed)) return false;
+                if (consumer_id_.load(std::memory_order_relaxed) != std::this_thread::get_id()) return false;
+                ++depth;
+                scope_exit _{[&depth]() noexcept { --depth; }};
+                op.finish();
+                return true;
+            }
+
+            /// run one ready operation; false if there is none, or the drain budget is spent and the backend must poll
             COIO_ALWAYS_INLINE auto consume() -> bool {
+                if (poll_due_) return false;
+                if (drained_ != 0 and drain_budget_spent()) {
+                    poll_due_ = true;
+                    return false;
+                }
                 node* op = op_queue_.dequeue();
-                if (op) op->finish();
-                return op;
+                if (op == nullptr) return false;
+                if (drained_++ == 0 and drain_max_time_.load(std::memory_order_relaxed) != std::chrono::nanoseconds::zero()) {
+                    drain_start_ = std::chrono::steady_clock::now();
+                }
+                op->finish();
+                return true;
+            }
+
+            /// whether the backend must not block, because the drain budget ran out with ready operations left
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto poll_due() const noexcept -> bool {
+                return poll_due_;
+            }
+
+            /// the backend has polled I/O and timers: start a new drain budget
+            COIO_ALWAYS_INLINE auto polled() noexcept -> void {
+                drained_ = 0;
+                poll_due_ = false;
+            }
+
+            [[nodiscard]]
+            auto drain_budget_spent() const noexcept -> bool {
+                const auto max_ops = drain_max_ops_.load(std::memory_order_relaxed);
+                if (max_ops != 0 and drained_ >= max_ops) return true;
+                const auto max_time = drain_max_time_.load(std::memory_order_relaxed);
+                return max_time != std::chrono::nanoseconds::zero() and std::chrono::steady_clock::now() - drain_start_ >= max_time;
             }
 
             COIO_ALWAYS_INLINE auto wakeup_consumer() -> void {
@@ -497,11 +699,20 @@ namespace coio {
 
         protected:
             std::pmr::polymorphic_allocator<> allocator_;
+            buffer_pool buffer_pool_;
             inplace_stop_source stop_source_;
             op_queue op_queue_;
             timer_queue timer_queue_;
             std::atomic<std::size_t> work_count_{0};
             std::atomic<std::thread::id> consumer_id_{};
+            std::atomic<std::size_t> inline_completion_limit_{0};
+            std::atomic<std::size_t> drain_max_ops_{0};
+            std::atomic<std::chrono::nanoseconds> drain_max_time_{};
+            std::atomic<std::chrono::steady_clock::duration> timer_slack_{};
+            // consumer-only
+            std::size_t drained_ = 0;
+            std::chrono::steady_clock::time_point drain_start_;
+            bool poll_due_ = false;
         };
     }
 
@@ -551,7 +762,7 @@ namespace coio {
         using task = coio::task<T, Alloc, scheduler>;
 
     public:
-        explicit time_loop(std::pmr::memory_resource& resource = *std::pmr::get_default_resource()) noexcept : loop_base(resource) {}
+        explicit time_loop(std::pmr::memory_resource& resource = *std::pmr::get_default_resource()) : loop_base(resource) {}
 
         ~time_loop() = default;
 
@@ -564,7 +775,7 @@ namespace coio {
                     return true;
                 }
 
-                if (infinite) {
+                if (infinite and not poll_due()) {
                     if (const auto earliest = timer_queue_.earliest()) {
                         static_cast<void>(sema_.try_acquire_until(*earliest));
                     }
@@ -577,6 +788,7 @@ namespace coio {
                 timer_queue_.take_ready_timers(ready_time_ops);
 
                 publish_pending(ready_time_ops.release());
+                polled();
 
                 if (not infinite) {
                     return consume();
@@ -0,0 +1,208 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <coio/execution_context.h>
+#include <coio/detail/thread_affinity.h>
+#include <coio/net/basic.h>
+#include <coio/net/socket.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio {
+    struct io_context_pool_options {
+        /// the number of contexts, each run by its own thread; `0` for one per CPU the process may run on.
+        std::size_t thread_count = 0;
+
+        /// pin the `i`-th thread to the `i`-th CPU the process may run on, wrapping around when there are more threads than CPUs.
+        bool pin_threads = false;
+    };
+
+#if COIO_OS_LINUX
+    /// how the kernel picks the acceptor of a new connection among the ones made by `io_context_pool::make_acceptors`.
+    enum class reuseport_steering {
+        /// by a hash of the connection's addresses and ports, the kernel's default.
+        hash,
+
+        /// prefer the acceptor whose thread is pinned to the CPU that received the connection (`SO_INCOMING_CPU`).
+        incoming_cpu,
+
+        /// always the acceptor whose thread is pinned to the CPU that received the connection (`SO_ATTACH_REUSEPORT_CBPF`),
+        /// connections received on any other CPU are hashed.
+        cpu_bpf,
+    };
+#endif
+
+    /**
+     * \brief a fixed set of I/O contexts, each run by its own thread.
+     *
+     * A connection is cheapest when it is accepted and served on the same thread. On Linux, `make_acceptors` opens one
+     * `SO_REUSEPORT` acceptor per context, so the kernel spreads new connections over the contexts directly instead of
+     * one acceptor handing every socket to another thread.
+     */
+    template<execution_context IoContext>
+    class io_context_pool {
+    public:
+        using context_type = IoContext;
+        using scheduler = typename IoContext::scheduler;
+
+    public:
+        /**
+         * \brief start `thread_count` threads, each running its own default-constructed context.
+         * \param thread_count the number of contexts, `0` for one per CPU the process may run on.
+         * \throw std::system_error if a context or thread can't be created.
+         */
+        explicit io_context_pool(std::size_t thread_count = 0) :
+            io_context_pool(io_context_pool_options{.thread_count = thread_count}) {}
+
+        /**
+         * \brief start the threads described by `opts`.
+         * \param context_args passed to the constructor of every context.
+         * \throw std::system_error if a context or thread can't be created, or a thread can't be pinned.
+         */
+        template<typename... Args>
+        explicit io_context_pool(const io_context_pool_options& opts, const Args&... context_args) {
+            const auto cpus = detail::allowed_cpus();
+            const std::size_t count = opts.thread_count != 0 ? opts.thread_count : std::max<std::size_t>(cpus.size(), 1);
+            contexts_.reserve(count);
+            guards_.reserve(count);
+            threads_.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                guards_.emplace_back(*contexts_.emplace_back(std::make_unique<IoContext>(context_args...)));
+            }
+            if (opts.pin_threads and not cpus.empty()) {
+                cpus_.reserve(count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    cpus_.push_back(cpus[i % cpus.size()]);
+                }
+            }
+
+            try {
+                for (std::size_t i = 0; i < count; ++i) {
+                    auto& thread = threads_.emplace_back([context = contexts_[i].get()] { context->run(); });
+                    if (not cpus_.empty()) detail::pin_thread(thread.native_handle(), cpus_[i]);
+                }
+            }
+            catch (...) {
+                stop();
+                threads_.clear();
+                throw;
+            }
+        }
+
+        io_context_pool(const io_context_pool&) = delete;
+
+        /**
+         * \brief stop the contexts and join their threads.
+         */
+        ~io_context_pool() {
+            stop();
+            threads_.clear();
+        }
+
+        auto operator= (const io_context_pool&) -> io_context_pool& = delete;
+
+        [[nodiscard]]
+        auto size() const noexcept -> std::size_t {
+            return contexts_.size();
+        }
+
+        [[nodiscard]]
+        auto context(std::size_t index) noexcept -> context_type& {
+            return *contexts_[index];
+        }
+
+        [[nodiscard]]
+        auto get_scheduler(std::size_t index) noexcept -> scheduler {
+            return contexts_[index]->get_scheduler();
+        }
+
+        /**
+         * \brief pick the contexts in turn.
+         * \note thread-safe.
+         */
+        [[nodiscard]]
+        auto pick_scheduler() noexcept -> scheduler {
+            return get_scheduler(next_.fetch_add(1, std::memory_order_relaxed) % contexts_.size());
+        }
+
+        /**
+         * \brief get the CPU the `index`-th thread is pinned to.
+         * \return `std::nullopt` if the threads aren't pinned.
+         */
+        [[nodiscard]]
+        auto cpu(std::size_t index) const noexcept -> std::optional<unsigned> {
+            if (cpus_.empty()) return std::nullopt;
+            return cpus_[index];
+        }
+
+        /**
+         * \brief request every context to stop, and let their threads return once the remaining work is done.
+         * \note not thread-safe against itself.
+         */
+        auto stop() -> void {
+            for (auto& context : contexts_) {
+                context->request_stop();
+            }
+            guards_.clear();
+        }
+
+#if COIO_OS_LINUX
+        /**
+         * \brief open one listening acceptor per context, all bound to `local_endpoint` with `SO_REUSEPORT`.
+         *
+         * The `i`-th acceptor uses the `i`-th context, so a task accepting on it and serving the connections on the
+         * same scheduler never crosses threads. If the port of `local_endpoint` is 0, the first acceptor picks the port
+         * and the others share it.
+         * \param steering how the kernel picks the acceptor of a new connection, anything but `hash` needs pinned threads.
+         * \param backlog the maximum length of each acceptor's queue of pending connections.
+         * \return the acceptors, in the order of the contexts.
+         * \throw std::invalid_argument if `steering` needs pinned threads and they aren't.
+         * \throw std::system_error on failure.
+         */
+        template<typename Protocol>
+        [[nodiscard]]
+        auto make_acceptors(
+            endpoint local_endpoint,
+            reuseport_steering steering = reuseport_steering::hash,
+            std::size_t backlog = detail::socket::max_backlog()
+        ) -> std::vector<typename Protocol::template acceptor<scheduler>> {
+            if (steering != reuseport_steering::hash and cpus_.empty()) {
+                throw std::invalid_argument{"steering by cpu needs a pool with pinned threads."};
+            }
+            std::vector<typename Protocol::template acceptor<scheduler>> acceptors;
+            acceptors.reserve(size());
+            for (std::size_t i = 0; i < size(); ++i) {
+                auto& acceptor = acceptors.emplace_back(get_scheduler(i));
+                acceptor.open(local_endpoint.ip().is_v4() ? Protocol::v4() : Protocol::v6());
+                acceptor.set_option(detail::socket::reuse_address{true});
+                acceptor.set_option(detail::socket::reuse_port{true});
+                if (steering == reuseport_steering::incoming_cpu) {
+                    acceptor.set_option(detail::socket::incoming_cpu{static_cast<int>(cpus_[i])});
+                }
+                acceptor.bind(local_endpoint);
+                if (i == 0) local_endpoint = acceptor.local_endpoint();
+                // the acceptors join the group in this order, which the cpu program relies on
+                acceptor.listen(backlog);
+            }
+            if (steering == reuseport_steering::cpu_bpf) {
+                detail::socket::attach_reuseport_cpu_steering(acceptors.front().native_handle(), cpus_);
+            }
+            return acceptors;
+        }
+#endif
+
+    private:
+        std::vector<std::unique_ptr<IoContext>> contexts_;
+        std::vector<work_guard<IoContext>> guards_;
+        std::vector<unsigned> cpus_;
+        std::vector<std::jthread> threads_; // joined before the contexts are destroyed
+        std::atomic<std::size_t> next_{0};
+    };
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
@@ -210,6 +210,22 @@ namespace coio {
         std::uint16_t port_{};
     };
 
+
+    /// one datagram of a batched receive, see `basic_datagram_socket::async_receive_many`
+    struct datagram_receive_slot {
+        std::span<std::byte> buffer; ///< where the datagram is stored
+        endpoint peer{};             ///< set to the sender
+        std::size_t size = 0;        ///< set to the number of bytes stored
+        bool truncated = false;      ///< set when the datagram didn't fit in `buffer`, the rest is discarded
+    };
+
+
+    /// one datagram of a batched send, see `basic_datagram_socket::async_send_many`
+    struct datagram_send_slot {
+        std::span<const std::byte> buffer;
+        endpoint peer;
+    };
+
     inline auto reverse_bytes(std::span<std::byte> bytes) noexcept -> void {
         if (bytes.empty()) [[unlikely]] return;
         for (std::size_t i = 0, j = bytes.size() - 1; i < j; ++i, --j) {
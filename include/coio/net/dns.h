@@ -0,0 +1,499 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <coio/core.h>
+#include <coio/asyncio/io.h>
+#include <coio/detail/error.h>
+#include <coio/net/basic.h>
+#include <coio/net/resolver.h>
+#include <coio/net/tcp.h>
+#include <coio/net/udp.h>
+#include <coio/sync_primitives.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio {
+    /**
+     * \brief what `basic_dns_resolver` asks and whom, usually read from `/etc/resolv.conf` and `/etc/hosts`.
+     */
+    struct dns_config {
+        /// the name servers, tried in order; port 53 unless given
+        std::vector<endpoint> name_servers;
+        /// static names, keyed by their lower-case form; a name listed here is never sent to a name server
+        std::unordered_multimap<std::string, ip_address> hosts;
+        /// how long to wait for one name server to answer
+        std::chrono::milliseconds timeout{5000};
+        /// how many times to go through the name servers
+        unsigned attempts = 2;
+        /// the most an answer is cached, whatever its records say
+        std::chrono::seconds max_ttl{3600};
+        /// how long a missing name is cached if the name server doesn't say
+        std::chrono::seconds negative_ttl{30};
+        /// the cache is split in this many independently locked parts
+        std::size_t cache_shards = 16;
+        /// how many answers the cache holds at most, over all its parts
+        std::size_t cache_capacity = 4096;
+
+        /**
+         * \brief read the system configuration, falling back to a name server on `127.0.0.1` (as the C library does)
+         * if `/etc/resolv.conf` lists none.
+         */
+        [[nodiscard]]
+        static auto from_system() -> dns_config;
+
+        /**
+         * \brief read `resolv_conf` and `hosts`; a file that can't be read is skipped.
+         */
+        [[nodiscard]]
+        static auto from_files(const std::filesystem::path& resolv_conf, const std::filesystem::path& hosts) -> dns_config;
+
+        /**
+         * \brief add the `nameserver` lines, and the `timeout:`/`attempts:` options, of a `resolv.conf` text.
+         * \note `search`, `domain` and `ndots` are ignored: names are always looked up as given.
+         */
+        auto parse_resolv_conf(std::string_view text) -> void;
+
+        /**
+         * \brief add the entries of a `hosts` text.
+         */
+        auto parse_hosts(std::string_view text) -> void;
+    };
+
+    namespace detail {
+        enum class dns_record_type : std::uint16_t {
+            a = 1,
+            cname = 5,
+            soa = 6,
+            aaaa = 28,
+        };
+
+        struct dns_answer {
+            std::vector<ip_address> addresses;
+            std::string canonical_name; // the end of the CNAME chain, empty if there was none
+            std::chrono::seconds ttl{};
+        };
+
+        struct dns_response {
+            bool truncated = false;
+            std::uint8_t rcode = 0;
+            dns_answer answer;
+            std::optional<std::chrono::seconds> negative_ttl; // from the SOA record (RFC 2308), if one came along
+        };
+
+        /// lower-case `name` and strip its trailing dot
+        [[nodiscard]]
+        auto dns_normalize_name(std::string_view name) -> std::string;
+
+        /// the message asking for the `type` records of `name`, with recursion desired.
+        /// \throw std::system_error `error::dns_errc::invalid_name` if `name` isn't a valid domain name.
+        [[nodiscard]]
+        auto dns_encode_query(std::uint16_t id, std::string_view name, dns_record_type type) -> std::vector<std::byte>;
+
+        /// the ID of `message`, `std::nullopt` if it's too short to be one.
+        [[nodiscard]]
+        auto dns_message_id(std::span<const std::byte> message) noexcept -> std::optional<std::uint16_t>;
+
+        /// decode the response to the query for the `type` records of `name` (normalized), following CNAMEs.
+        /// \throw std::system_error `error::dns_errc::malformed_response` if it isn't one.
+        [[nodiscard]]
+        auto dns_parse_response(std::span<const std::byte> message, std::string_view name, dns_record_type type) -> dns_response;
+
+        /// `name` as a numeric address, `std::nullopt` if it isn't one.
+        [[nodiscard]]
+        auto dns_numeric_address(std::string_view name) -> std::optional<ip_address>;
+
+        // a lookup in progress; the ones asking for the same records meanwhile wait for it instead of asking again
+        struct dns_flight {
+            async_latch<> done{1};
+            dns_answer answer;   // valid once `done`
+            std::error_code error;
+        };
+
+        // sharded TTL cache of answers (and of errors for missing names), plus the lookups in flight
+        class dns_cache {
+        public:
+            using clock = std::chrono::steady_clock;
+
+            struct probe_result {
+                bool hit = false;                   // `answer`/`error` are cached
+                dns_answer answer;
+                std::error_code error;
+                std::shared_ptr<dns_flight> flight; // otherwise the lookup to wait for, or to perform if `leader`
+                bool leader = false;
+            };
+
+        public:
+            dns_cache(std::size_t shard_count, std::size_t capacity);
+
+            dns_cache(const dns_cache&) = delete;
+
+            ~dns_cache();
+
+            auto operator= (const dns_cache&) -> dns_cache& = delete;
+
+            [[nodiscard]]
+            auto probe(const std::string& name, dns_record_type type, clock::time_point now) -> probe_result;
+
+            /// publish the outcome of the lookup `flight` leads, caching it until `expiry` if that's later than now.
+            auto settle(
+                const std::string& name,
+                dns_record_type type,
+                const std::shared_ptr<dns_flight>& flight,
+                dns_answer answer,
+                std::error_code error,
+                std::optional<clock::time_point> expiry
+            ) noexcept -> void;
+
+            auto clear() -> void;
+
+            [[nodiscard]]
+            auto size() const -> std::size_t;
+
+        private:
+            struct shard;
+
+            [[nodiscard]]
+            auto shard_of(const std::string& name, dns_record_type type) const noexcept -> shard&;
+
+        private:
+            std::unique_ptr<shard[]> shards_;
+            std::size_t shard_count_;
+            std::size_t shard_capacity_;
+        };
+
+        // what copies of one `basic_dns_resolver` share
+        class dns_resolver_state {
+        public:
+            explicit dns_resolver_state(dns_config config);
+
+            [[nodiscard]]
+            auto config() const noexcept -> const dns_config& {
+                return config_;
+            }
+
+            [[nodiscard]]
+            auto cache() noexcept -> dns_cache& {
+                return cache_;
+            }
+
+            /// an unpredictable query ID
+            [[nodiscard]]
+            auto next_id() -> std::uint16_t;
+
+            /// the answer from the numeric form or the hosts table, `std::nullopt` if the name server must be asked.
+            [[nodiscard]]
+            auto local_answer(const std::string& name, dns_record_type type) const -> std::optional<dns_answer>;
+
+            /// when an answer obtained now with `ttl` expires
+            [[nodiscard]]
+            auto expiry_of(std::chrono::seconds ttl) const noexcept -> dns_cache::clock::time_point;
+
+        private:
+            dns_config config_;
+            dns_cache cache_;
+            std::mutex id_mtx_;
+            std::uint64_t id_state_;
+        };
+
+        // settles the flight it leads as cancelled if the lookup ends without an outcome (e.g. it was stopped);
+        // the followers then look again rather than fail
+        class dns_flight_ticket {
+        public:
+            dns_flight_ticket(dns_cache& cache, const std::string& name, dns_record_type type, std::shared_ptr<dns_flight> flight) noexcept :
+                cache_(&cache), name_(&name), type_(type), flight_(std::move(flight)) {}
+
+            dns_flight_ticket(const dns_flight_ticket&) = delete;
+
+            ~dns_flight_ticket() {
+                if (flight_) settle({}, std::make_error_code(std::errc::operation_canceled), {});
+            }
+
+            auto operator= (const dns_flight_ticket&) -> dns_flight_ticket& = delete;
+
+            auto settle(dns_answer answer, std::error_code error, std::optional<dns_cache::clock::time_point> expiry) noexcept -> void {
+                cache_->settle(*name_, type_, std::exchange(flight_, {}), std::move(answer), error, expiry);
+            }
+
+        private:
+            dns_cache* cache_;
+            const std::string* name_;
+            dns_record_type type_;
+            std::shared_ptr<dns_flight> flight_;
+        };
+    }
+
+    /**
+     * \brief resolve host names by asking the name servers over the scheduler's own sockets, without blocking a thread.
+     *
+     * Answers are cached for their TTL and missing names for their negative TTL. Concurrent lookups of the same
+     * name share one query. Copies of a resolver share the cache.
+     */
+    template<io_scheduler IoScheduler>
+    class basic_dns_resolver {
+    public:
+        using scheduler_type = IoScheduler;
+        using result_t = detail::resolve_result_t;
+
+    private:
+        using state_type = detail::dns_resolver_state;
+        using record_type = detail::dns_record_type;
+        using udp_socket = udp::socket<IoScheduler>;
+        using tcp_socket = tcp::socket<IoScheduler>;
+
+        // the classic limit without EDNS; longer answers are truncated and fetched over TCP
+        static constexpr std::size_t udp_message_size = 512;
+
+    public:
+        explicit basic_dns_resolver(IoScheduler sched, dns_config config = dns_config::from_system()) :
+            sched_(std::move(sched)), state_(std::make_shared<state_type>(std::move(config))) {}
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto get_scheduler() const noexcept -> IoScheduler {
+            return sched_;
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto config() const noexcept -> const dns_config& {
+            return state_->config();
+        }
+
+        /**
+         * \brief forget every cached answer; lookups in flight are unaffected.
+         */
+        COIO_ALWAYS_INLINE auto clear_cache() -> void {
+            state_->cache().clear();
+        }
+
+        /**
+         * \brief the number of cached answers, expired ones included until they're evicted.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto cache_size() const -> std::size_t {
+            return state_->cache().size();
+        }
+
+        /**
+         * \brief asynchronously resolve `host_name` into its IPv4 and IPv6 endpoints with `port`.
+         * \return a task of the endpoints, IPv4 ones first.
+         * \throw std::system_error in category `error::dns_category()` if the name doesn't exist, has no addresses,
+         * or no name server answered.
+         */
+        [[nodiscard]]
+        auto async_resolve(std::string host_name, std::uint16_t port = 0) const -> task<std::vector<result_t>> {
+            return resolve(sched_, state_, detail::dns_normalize_name(host_name), port, true, true);
+        }
+
+        /**
+         * \brief asynchronously resolve `host_name` into the endpoints of `protocol`'s family with `port`.
+         */
+        template<typename Protocol> requires requires { Protocol::v4(); Protocol::v6(); }
+        [[nodiscard]]
+        auto async_resolve(const Protocol& protocol, std::string host_name, std::uint16_t port = 0) const -> task<std::vector<result_t>> {
+            const bool v6 = protocol == Protocol::v6();
+            return resolve(sched_, state_, detail::dns_normalize_name(host_name), port, not v6, v6);
+        }
+
+    private:
+        struct outcome {
+            detail::dns_answer answer;
+            std::exception_ptr exception;
+        };
+
+        static auto resolve(
+            IoScheduler sched,
+            std::shared_ptr<state_type> state,
+            std::string name,
+            std::uint16_t port,
+            bool want_v4,
+            bool want_v6
+        ) -> task<std::vector<result_t>> {
+            outcome v4, v6;
+            if (want_v4 and want_v6) {
+                co_await when_all(
+                    capture(lookup(sched, state, name, record_type::a), v4),
+                    capture(lookup(sched, state, name, record_type::aaaa), v6)
+                );
+            }
+            else if (want_v4) {
+                co_await capture(lookup(sched, state, name, record_type::a), v4);
+            }
+            else {
+                co_await capture(lookup(sched, state, name, record_type::aaaa), v6);
+            }
+            // one family failing doesn't fail the other, unless neither yields an address
+            if (v4.answer.addresses.empty() and v6.answer.addresses.empty()) {
+                if (v4.exception) std::rethrow_exception(v4.exception);
+                if (v6.exception) std::rethrow_exception(v6.exception);
+                throw std::system_error{error::dns_errc::no_data, "async_resolve"};
+            }
+            std::vector<result_t> results;
+            results.reserve(v4.answer.addresses.size() + v6.answer.addresses.size());
+            for (const outcome* family : {&v4, &v6}) {
+                for (const ip_address& address : family->answer.addresses) {
+                    result_t& result = results.emplace_back();
+                    result.endpoint = address.is_v4() ? endpoint{address.v4(), port} : endpoint{address.v6(), port};
+                    result.canonical_name = family->answer.canonical_name;
+                }
+            }
+            co_return results;
+        }
+
+        static auto capture(task<detail::dns_answer> lookup, outcome& out) -> task<> {
+            try {
+                out.answer = co_await std::move(lookup);
+            }
+            catch (...) {
+                out.exception = std::current_exception();
+            }
+        }
+
+        static auto lookup(IoScheduler sched, std::shared_ptr<state_type> state, std::string name, record_type type) -> task<detail::dns_answer> {
+            if (auto local = state->local_answer(name, type)) co_return *std::move(local);
+
+            auto probe = state->cache().probe(name, type, detail::dns_cache::clock::now());
+            while (not probe.hit and not probe.leader) {
+                co_await probe.flight->done.wait();
+                if (probe.flight->error != std::errc::operation_canceled) {
+                    if (probe.flight->error) throw std::system_error{probe.flight->error, "async_resolve"};
+                    co_return probe.flight->answer;
+                }
+                // the leading lookup was stopped, not this one: look again, and lead the query unless another follower does
+                probe = state->cache().probe(name, type, detail::dns_cache::clock::now());
+            }
+            if (probe.hit) {
+                if (probe.error) throw std::system_error{probe.error, "async_resolve"};
+                co_return std::move(probe.answer);
+            }
+
+            detail::dns_flight_ticket ticket{state->cache(), name, type, std::move(probe.flight)};
+            std::error_code error;
+            std::optional<detail::dns_response> response;
+            try {
+                response = co_await ask(sched, state, name, type);
+            }
+            catch (const std::system_error& e) {
+                error = e.code();
+            }
+            if (error) {
+                ticket.settle({}, error, {}); // transient: not cached
+                throw std::system_error{error, "async_resolve"};
+            }
+            const auto ttl = response->answer.addresses.empty()
+                ? response->negative_ttl.value_or(state->config().negative_ttl)
+                : response->answer.ttl;
+            const auto expiry = state->expiry_of(ttl);
+            if (response->rcode == rcode_name_error) {
+                ticket.settle({}, error::dns_errc::host_not_found, expiry);
+                throw std::system_error{error::dns_errc::host_not_found, "async_resolve"};
+            }
+            ticket.settle(response->answer, {}, expiry);
+            co_return std::move(response->answer);
+        }
+
+        // every name server in turn, `attempts` times, until one gives a definite answer
+        static auto ask(IoScheduler sched, std::shared_ptr<state_type> state, std::string name, record_type type) -> task<detail::dns_response> {
+            const dns_config& config = state->config();
+            if (config.name_servers.empty()) throw std::system_error{error::dns_errc::no_name_servers, "async_resolve"};
+            std::error_code last_error = error::dns_errc::timed_out;
+            for (unsigned attempt = 0; attempt < std::max(config.attempts, 1u); ++attempt) {
+                for (const endpoint& server : config.name_servers) {
+                    const std::uint16_t id = state->next_id();
+                    const auto query = detail::dns_encode_query(id, name, type);
+                    std::optional<detail::dns_response> response;
+                    std::error_code error;
+                    try {
+                        response = co_await when_any(
+                            exchange_udp(sched, server, query, id, name, type),
+                            sched.schedule_after(config.timeout) | then([] { return std::optional<detail::dns_response>{}; })
+                        );
+                        if (response and response->truncated) {
+                            response = co_await when_any(
+                                exchange_tcp(sched, server, query, id, name, type),
+                                sched.schedule_after(config.timeout) | then([] { return std::optional<detail::dns_response>{}; })
+                            );
+                        }
+                    }
+                    catch (const std::system_error& e) {
+                        error = e.code();
+                    }
+                    if (error) {
+                        last_error = error;
+                        continue;
+                    }
+                    if (not response) {
+                        last_error = error::dns_errc::timed_out;
+                        continue;
+                    }
+                    if (response->rcode == rcode_no_error or response->rcode == rcode_name_error) co_return *std::move(response);
+                    last_error = response->rcode == rcode_refused ? error::dns_errc::refused : error::dns_errc::server_failure;
+                }
+            }
+            throw std::system_error{last_error, "async_resolve"};
+        }
+
+        static auto exchange_udp(
+            IoScheduler sched,
+            endpoint server,
+            std::span<const std::byte> query,
+            std::uint16_t id,
+            const std::string& name,
+            record_type type
+        ) -> task<std::optional<detail::dns_response>> {
+            udp_socket socket{sched, server.ip().is_v4() ? udp::v4() : udp::v6()};
+            socket.connect(server); // only the server's datagrams get through
+            static_cast<void>(co_await socket.async_send(query));
+            std::byte buffer[udp_message_size];
+            while (true) {
+                const std::size_t size = co_await socket.async_receive(buffer);
+                const std::span message{buffer, size};
+                if (detail::dns_message_id(message) != id) continue; // a late answer to an earlier query
+                co_return detail::dns_parse_response(message, name, type);
+            }
+        }
+
+        static auto exchange_tcp(
+            IoScheduler sched,
+            endpoint server,
+            std::span<const std::byte> query,
+            std::uint16_t id,
+            const std::string& name,
+            record_type type
+        ) -> task<std::optional<detail::dns_response>> {
+            tcp_socket socket{sched, server.ip().is_v4() ? tcp::v4() : tcp::v6()};
+            co_await socket.async_connect(server);
+            // each message is preceded by its length
+            std::vector<std::byte> framed(2 + query.size());
+            framed[0] = static_cast<std::byte>(query.size() >> 8);
+            framed[1] = static_cast<std::byte>(query.size() & 0xff);
+            std::ranges::copy(query, framed.begin() + 2);
+            if (auto [ec, _] = co_await async_write(socket, std::span<const std::byte>{framed}); ec) throw std::system_error{ec, "async_resolve"};
+            std::byte length[2];
+            if (auto [ec, _] = co_await async_read(socket, std::span<std::byte>{length}); ec) throw std::system_error{ec, "async_resolve"};
+            std::vector<std::byte> message((std::to_integer<std::size_t>(length[0]) << 8) | std::to_integer<std::size_t>(length[1]));
+            if (auto [ec, _] = co_await async_read(socket, std::span<std::byte>{message}); ec) throw std::system_error{ec, "async_resolve"};
+            if (detail::dns_message_id(message) != id) throw std::system_error{error::dns_errc::malformed_response, "async_resolve"};
+            co_return detail::dns_parse_response(message, name, type);
+        }
+
+    private:
+        static constexpr std::uint8_t rcode_no_error = 0;
+        static constexpr std::uint8_t rcode_name_error = 3;
+        static constexpr std::uint8_t rcode_refused = 5;
+
+        IoScheduler sched_;
+        std::shared_ptr<state_type> state_;
+    };
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
@@ -32,6 +32,8 @@ namespace coio {
 
         auto ipproto_tcp_v() noexcept -> int;
 
+        auto ipproto_udp_v() noexcept -> int;
+
         template<typename ValueType>
         struct sock_option_traits {
             using storage = ValueType;
@@ -201,6 +203,41 @@ namespace coio {
             static auto name() noexcept -> int;
         };
 
+#if COIO_OS_LINUX
+        // udp options
+        struct udp_segment_size : sock_option<int, ipproto_udp_v> {
+            using sock_option::sock_option;
+
+            [[nodiscard]]
+            static auto name() noexcept -> int;
+        };
+
+        // linux socket options
+        struct reuse_port : sock_option<bool, sol_socket_v> {
+            using sock_option::sock_option;
+
+            [[nodiscard]]
+            static auto name() noexcept -> int;
+        };
+
+        struct incoming_cpu : sock_option<int, sol_socket_v> {
+            using sock_option::sock_option;
+
+            [[nodiscard]]
+            static auto name() noexcept -> int;
+        };
+
+        /**
+         * \brief steer the connections of a `SO_REUSEPORT` group by the CPU that received them.
+         *
+         * Attaches a classic BPF program (`SO_ATTACH_REUSEPORT_CBPF`) to the group `handle` belongs to:
+         * a connection received on `cpus[i]` goes to the `i`-th socket that joined the group, a connection received
+         * on any other CPU falls back to the kernel's hash.
+         * \throw std::system_error on failure.
+         */
+        auto attach_reuseport_cpu_steering(socket_native_handle_type handle, std::span<const unsigned> cpus) -> void;
+#endif
+
         [[nodiscard]]
         auto open(int family, int type, int protocol_id) -> socket_native_handle_type;
 
@@ -224,6 +261,57 @@ namespace coio {
         auto accept(socket_native_handle_type handle) -> socket_native_handle_type;
     }
 
+    namespace detail {
+        /// accepts one connection per `next`, for io objects without a native accept stream
+        template<typename IoObject>
+        class accept_loop {
+        public:
+            explicit accept_loop(IoObject& acceptor) noexcept : acceptor_(&acceptor) {}
+
+            [[nodiscard]]
+            COIO_ALWAYS_INLINE auto next() {
+                return acceptor_->async_accept();
+            }
+
+        private:
+            IoObject* acceptor_;
+        };
+    }
+
+    /**
+     * \brief a stream of connections accepted by a `basic_socket_acceptor`, see `basic_socket_acceptor::async_accept_stream`.
+     */
+    template<typename Socket, typename Impl>
+    class basic_accept_stream {
+    public:
+        using socket_type = Socket;
+        using scheduler_type = typename socket_type::scheduler_type;
+        using native_handle_type = typename socket_type::native_handle_type;
+
+    public:
+        basic_accept_stream(scheduler_type scheduler, Impl impl) noexcept(std::is_nothrow_move_constructible_v<Impl>) :
+            scheduler_(std::move(scheduler)), impl_(std::move(impl)) {}
+
+        /**
+         * \brief wait for the next accepted connection.
+         * \return a sender of `socket_type`.
+         * \note at most one `next` may be pending at any time.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto next() {
+            return then(
+                impl_.next(),
+                [scheduler = scheduler_](native_handle_type handle) {
+                    return socket_type(scheduler, handle);
+                }
+            );
+        }
+
+    private:
+        scheduler_type scheduler_;
+        Impl impl_;
+    };
+
     template<typename Protocol, io_scheduler IoScheduler>
     class basic_socket {
     private:
@@ -249,6 +337,11 @@ namespace coio {
         using send_buffer_size = detail::socket::send_buffer_size;
         using send_low_watermark = detail::socket::send_low_watermark;
 
+#if COIO_OS_LINUX
+        using reuse_port = detail::socket::reuse_port;
+        using incoming_cpu = detail::socket::incoming_cpu;
+#endif
+
         // Ip options
         using v6_only = detail::socket::v6_only;
 
@@ -311,6 +404,15 @@ namespace coio {
             impl_.cancel();
         }
 
+        /**
+         * \brief install the socket into the scheduler's registered file table, so asynchronous operations skip the kernel's per-operation file lookup.
+         * \throw std::system_error on failure.
+         * \note only available on schedulers with a registered file table (e.g. `uring_context::scheduler`).
+         */
+        COIO_ALWAYS_INLINE auto register_file() -> void requires requires (implementation_type& impl) { impl.register_file(); } {
+            impl_.register_file();
+        }
+
         /**
          * \brief disable sends or receives on the socket.
          * \param how `shutdown_send`: disable sends,
@@ -401,6 +503,22 @@ namespace coio {
             });
         }
 
+        /**
+         * \brief send some message data asynchronously, letting the kernel transmit straight from `buffer` instead of copying it.
+         * \param buffer the data to send; it must neither change nor go away until the operation completes.
+         * \return a sender of `std::size_t`, the number of bytes sent.
+         * \note
+         * 1) the operation completes only once the kernel has released `buffer`, which for TCP means the peer acknowledged the data;
+         * cancellation is ignored from the moment the data has been handed to the kernel.\n
+         * 2) pinning pages costs more than copying a few kilobytes, use it for large payloads.\n
+         * 3) only available on schedulers supporting zero-copy sends (e.g. `epoll_context::scheduler`, `uring_context::scheduler`);
+         * the kernel silently copies where zero-copy isn't possible (e.g. over loopback).
+        */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_send_zc(std::span<const std::byte> buffer) requires requires (implementation_type& impl) { impl.async_send_zc(buffer); } {
+            return impl_.async_send_zc(buffer);
+        }
+
     protected:
         implementation_type impl_;
     };
@@ -537,6 +655,29 @@ namespace coio {
         COIO_ALWAYS_INLINE auto async_accept() {
             return this->async_accept(this->get_io_scheduler());
         }
+
+        /**
+         * \brief start accepting connections as a stream.
+         * \return a `basic_accept_stream` whose `next` yields `protocol_type::socket<scheduler_type>`.
+         * \throw std::system_error on failure.
+         * \note
+         * 1) schedulers with a native accept stream (e.g. `uring_context::scheduler`) accept every connection
+         * through a single multishot request; elsewhere each `next` starts an `async_accept`.\n
+         * 2) the program must ensure that no other calls to `async_accept`, `accept` are performed while the stream is alive.\n
+         * 3) the stream must not outlive the acceptor.
+         */
+        [[nodiscard]]
+        auto async_accept_stream() {
+            using socket_t = protocol_socket_<scheduler_type>;
+            if constexpr (requires { this->impl_.make_accept_stream(); }) {
+                using stream_t = decltype(this->impl_.make_accept_stream());
+                return basic_accept_stream<socket_t, stream_t>{this->get_io_scheduler(), this->impl_.make_accept_stream()};
+            }
+            else {
+                using loop_t = detail::accept_loop<std::remove_reference_t<decltype(this->impl_)>>;
+                return basic_accept_stream<socket_t, loop_t>{this->get_io_scheduler(), loop_t{this->impl_}};
+            }
+        }
     };
 
     template<typename Protocol, io_scheduler IoScheduler>
@@ -626,6 +767,30 @@ namespace coio {
             return this->impl_.async_send(buffer);
         }
 
+        /**
+         * \brief receive some message data asynchronously, scattering it over several buffers (`readv`).
+         * \param buffers the buffers to fill, in order; only the first 16 non-empty ones take part in one operation.
+         * \return a sender of `std::size_t`.
+         * \note same requirements as the single-buffer overload.
+        */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_read_some(std::span<const std::span<std::byte>> buffers)
+            requires requires { this->impl_.async_receive(buffers); } {
+            return this->impl_.async_receive(buffers);
+        }
+
+        /**
+         * \brief send some message data asynchronously, gathering it from several buffers (`sendmsg`).
+         * \param buffers the buffers to send, in order; only the first 16 non-empty ones take part in one operation.
+         * \return a sender of `std::size_t`.
+         * \note same requirements as the single-buffer overload.
+        */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_write_some(std::span<const std::span<const std::byte>> buffers)
+            requires requires { this->impl_.async_send(buffers); } {
+            return this->impl_.async_send(buffers);
+        }
+
         /**
          * \brief same as `async_read_some`
          */
@@ -634,6 +799,37 @@ namespace coio {
             return async_read_some(buffer);
         }
 
+        /**
+         * \brief same as `async_read_some`
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_receive(std::span<const std::span<std::byte>> buffers)
+            requires requires { this->impl_.async_receive(buffers); } {
+            return async_read_some(buffers);
+        }
+
+        /**
+         * \brief receive some message data asynchronously into a buffer picked from the scheduler's provided-buffer ring.
+         * \return a sender of the scheduler's buffer lease; the buffer is given back to the ring when the lease is destroyed.
+         * \note only available on schedulers that own a provided-buffer ring (e.g. `uring_context::scheduler`).
+        */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_receive_buffered() requires requires { this->impl_.async_receive_buffered(); } {
+            return this->impl_.async_receive_buffered();
+        }
+
+        /**
+         * \brief start receiving through a single multishot request.
+         * \return the scheduler's receive stream, whose `next` yields the same values as `async_receive_buffered`.
+         * \throw std::system_error on failure.
+         * \note only available on schedulers supporting multishot receive (e.g. `uring_context::scheduler`);
+         * the stream must not outlive the socket.
+        */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_receive_stream() requires requires { this->impl_.make_receive_stream(); } {
+            return this->impl_.make_receive_stream();
+        }
+
         /**
          * \brief same as `async_write_some`
          */
@@ -641,6 +837,32 @@ namespace coio {
         COIO_ALWAYS_INLINE auto async_send(std::span<const std::byte> buffer) {
             return async_write_some(buffer);
         }
+
+        /**
+         * \brief same as `async_write_some`
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_send(std::span<const std::span<const std::byte>> buffers)
+            requires requires { this->impl_.async_send(buffers); } {
+            return async_write_some(buffers);
+        }
+
+        /**
+         * \brief send some data of a file asynchronously, without copying it through user memory.
+         * \param file the native handle of a file opened for reading, e.g. `random_access_file::native_handle()`.
+         * \param offset where in the file to start; the file's own position is neither used nor changed.
+         * \param count the number of bytes to send at most.
+         * \return a sender of `std::size_t`; it completes with `coio::error::eof` if the file ends at `offset`.
+         * \note
+         * 1) same requirements as `async_write_some`.\n
+         * 2) only available on schedulers supporting it (`epoll_context::scheduler` uses `sendfile`,
+         * `uring_context::scheduler` splices through a pipe); consider using `coio::async_sendfile` to send a whole range.
+        */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_sendfile_some(auto file, std::size_t offset, std::size_t count)
+            requires requires { this->impl_.async_sendfile(file, offset, count); } {
+            return this->impl_.async_sendfile(file, offset, count);
+        }
     };
 
     template<typename Protocol, io_scheduler IoScheduler>
@@ -719,6 +941,19 @@ namespace coio {
             return this->impl_.async_receive(buffer);
         }
 
+        /**
+         * \brief receive one message asynchronously, scattering it over several buffers (`readv`).
+         * \param buffers the buffers to fill, in order; at most 16 non-empty ones.
+         * \return a sender of `std::size_t`; it fails with `std::errc::message_size` given more non-empty buffers,
+         * which the message couldn't be received into whole.
+         * \note same requirements as the single-buffer overload.
+        */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_receive(std::span<const std::span<std::byte>> buffers)
+            requires requires { this->impl_.async_receive(buffers); } {
+            return this->impl_.async_receive(buffers);
+        }
+
         /**
          * \brief send message data asynchronously.
          * \param buffer the buffers containing the message part to send.
@@ -734,6 +969,19 @@ namespace coio {
             return this->impl_.async_send(buffer);
         }
 
+        /**
+         * \brief send one message asynchronously, gathering it from several buffers (`sendmsg`).
+         * \param buffers the buffers making up the message, in order; at most 16 non-empty ones.
+         * \return a sender of `std::size_t`; it fails with `std::errc::message_size` given more non-empty buffers,
+         * rather than send the message truncated.
+         * \note same requirements as the single-buffer overload.
+        */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_send(std::span<const std::span<const std::byte>> buffers)
+            requires requires { this->impl_.async_send(buffers); } {
+            return this->impl_.async_send(buffers);
+        }
+
         /**
          * \brief receive message data asynchronously.
          * \param buffer the buffers containing the message part to receive.
@@ -764,6 +1012,32 @@ namespace coio {
         COIO_ALWAYS_INLINE auto async_send_to(std::span<const std::byte> buffer, const endpoint& peer) {
             return this->impl_.async_send_to(buffer, peer);
         }
+
+        /**
+         * \brief receive several datagrams asynchronously, with one system call where the platform has one (`recvmmsg`).
+         * \param slots the datagrams to receive, in order; the sender, size and truncation of each received datagram are stored in its slot.
+         * \return a sender of `std::size_t`, the number of leading slots filled. It completes as soon as at least one datagram
+         * arrived, and fills at most a bounded number of slots per operation.
+         * \note the same restrictions as `async_receive_from` apply.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_receive_many(std::span<datagram_receive_slot> slots)
+            requires requires { this->impl_.async_receive_many(slots); } {
+            return this->impl_.async_receive_many(slots);
+        }
+
+        /**
+         * \brief send several datagrams asynchronously, with one system call where the platform has one (`sendmmsg`).
+         * \param slots the datagrams to send and their destinations, in order.
+         * \return a sender of `std::size_t`, the number of leading slots sent. It may be fewer than `slots.size()`,
+         * resubmit the rest to send them.
+         * \note the same restrictions as `async_send_to` apply.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto async_send_many(std::span<const datagram_send_slot> slots)
+            requires requires { this->impl_.async_send_many(slots); } {
+            return this->impl_.async_send_many(slots);
+        }
     };
 
 }
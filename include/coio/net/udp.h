@@ -11,6 +11,12 @@ namespace coio {
         template<scheduler Scheduler>
         using resolver = basic_resolver<udp, Scheduler>;
 
+#if COIO_OS_LINUX
+        // udp socket options:
+        /// generic segmentation offload: each send is split by the kernel into datagrams of this size (0 disables it)
+        using segment_size = detail::socket::udp_segment_size;
+#endif
+
     private:
         explicit udp(int family) noexcept : family_(family) {}
 
@@ -0,0 +1,129 @@
+// ReSharper disable CppPolymorphicClassWithNonVirtualPublicDestructor
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <semaphore>
+#include <thread>
+#include <coio/execution_context.h>
+#include <coio/detail/op_queue.h>
+#include <coio/detail/work_stealing_deque.h>
+#include <coio/utils/atomutex.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio {
+    /**
+     * \brief a pool of worker threads for CPU-bound work.
+     *
+     * Every worker keeps a local deque of ready operations. Work scheduled from a worker stays in its deque,
+     * work scheduled from any other thread (e.g. an I/O context handing back a completion) is pushed onto a lock-free
+     * injection queue, and idle workers steal from the others. Unlike the single-consumer contexts, the pool drives
+     * itself: the workers start in the constructor and are joined by the destructor, so there is no `run()`.
+     */
+    class thread_pool_context : public detail::loop_base<thread_pool_context> {
+        friend loop_base;
+    private:
+        static constexpr std::size_t local_queue_capacity = 256;
+
+        struct worker {
+            thread_pool_context* pool = nullptr;
+            detail::work_stealing_deque<node, local_queue_capacity> queue;
+            std::binary_semaphore sema{0};
+            std::atomic<bool> sleeping{false};
+            std::atomic<std::chrono::steady_clock::time_point> deadline{}; // while it keeps the timers
+            std::uint32_t tick = 0;
+            std::uint32_t seed = 1;
+            std::thread thread;
+        };
+
+    public:
+        struct scheduler : scheduler_base {
+            using scheduler_base::scheduler_base;
+        };
+
+        template<typename T = void, typename Alloc = std::allocator<std::byte>>
+        using task = coio::task<T, Alloc, scheduler>;
+
+    public:
+        /**
+         * \brief start the worker threads.
+         * \param thread_count the number of workers, `0` for one per hardware thread.
+         * \throw std::system_error if a worker thread can't be started.
+         */
+        explicit thread_pool_context(std::size_t thread_count = 0, std::pmr::memory_resource& resource = *std::pmr::get_default_resource());
+
+        /**
+         * \brief run the remaining ready work, then join the workers.
+         * \note like every other context, destroying it with outstanding operations (e.g. a pending `schedule_after`) terminates.
+         */
+        ~thread_pool_context();
+
+        [[nodiscard]]
+        auto thread_count() const noexcept -> std::size_t {
+            return worker_count_;
+        }
+
+    private:
+        // the workers drive the pool
+        using loop_base::poll_one;
+        using loop_base::poll;
+        using loop_base::run_one;
+        using loop_base::run;
+        // the workers have their own fairness interval
+        using loop_base::set_drain_budget;
+        // no consumer thread: nothing completes inline on the pool, so there is no depth to tune
+        using loop_base::set_inline_completion_depth;
+
+        COIO_ALWAYS_INLINE auto post(node& op) -> void {
+            if (auto self = current_worker_; self == nullptr or self->pool != this or not self->queue.push(&op)) {
+                inject(op);
+            }
+            if (idle_count_.load() != 0) wake_one();
+        }
+
+        auto inject(node& op) noexcept -> void;
+
+        auto interrupt() -> void;
+
+        auto work(worker& self) -> void;
+
+        auto next_op(worker& self) -> node*;
+
+        auto take_injected() noexcept -> node*;
+
+        auto steal(worker& self) noexcept -> node*;
+
+        auto fire_timers() -> void;
+
+        [[nodiscard]]
+        auto has_work() const noexcept -> bool;
+
+        auto sleep(worker& self) -> void;
+
+        auto cancel_sleep(worker& self) noexcept -> void;
+
+        auto wake(worker& target) noexcept -> bool;
+
+        auto wake_one() noexcept -> void;
+
+        auto stop_workers() noexcept -> void;
+
+    private:
+        static inline thread_local worker* current_worker_ = nullptr;
+
+        std::unique_ptr<worker[]> workers_;
+        std::size_t worker_count_ = 0;
+        detail::op_queue<node, &node::next_> injected_;
+        atomutex injected_mtx_; // guards the consumer side of `injected_`
+        std::atomic<std::size_t> injected_count_{0};
+        std::atomic<std::size_t> idle_count_{0};
+        std::atomic<std::size_t> next_wake_{0};
+        std::atomic<worker*> timer_keeper_{nullptr}; // the idle worker waiting for the earliest timer
+        std::atomic<bool> stopping_{false};
+    };
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
@@ -0,0 +1,127 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <coio/detail/config.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio {
+    /**
+     * \brief round `n` up to a multiple of `alignment`, a power of two.
+     */
+    [[nodiscard]]
+    COIO_ALWAYS_INLINE constexpr auto align_up(std::size_t n, std::size_t alignment) noexcept -> std::size_t {
+        COIO_ASSERT(std::has_single_bit(alignment));
+        return (n + alignment - 1) & ~(alignment - 1);
+    }
+
+    /**
+     * \brief round `n` down to a multiple of `alignment`, a power of two.
+     */
+    [[nodiscard]]
+    COIO_ALWAYS_INLINE constexpr auto align_down(std::size_t n, std::size_t alignment) noexcept -> std::size_t {
+        COIO_ASSERT(std::has_single_bit(alignment));
+        return n & ~(alignment - 1);
+    }
+
+    /**
+     * \brief whether `buffer` may take part in direct I/O at `offset`: its address, its size and the offset
+     * are all multiples of `alignment`, a power of two.
+     */
+    [[nodiscard]]
+    COIO_ALWAYS_INLINE auto is_aligned(std::span<const std::byte> buffer, std::size_t offset, std::size_t alignment) noexcept -> bool {
+        COIO_ASSERT(std::has_single_bit(alignment));
+        return ((reinterpret_cast<std::uintptr_t>(buffer.data()) | buffer.size() | offset) & (alignment - 1)) == 0;
+    }
+
+    /**
+     * \brief an owned byte buffer whose address and size are multiples of an alignment, as direct I/O
+     * (`open_mode::direct`) requires, see `direct_io_alignment` of the files.
+     */
+    class aligned_buffer {
+    public:
+        aligned_buffer() = default;
+
+        /**
+         * \brief allocate `size` bytes, rounded up to a multiple of `alignment`; the bytes are left uninitialized.
+         * \throw std::invalid_argument if `alignment` isn't a power of two.
+         * \throw std::bad_alloc on allocation failure.
+         */
+        aligned_buffer(std::size_t size, std::size_t alignment) : alignment_(alignment) {
+            if (not std::has_single_bit(alignment)) {
+                throw std::invalid_argument{"coio::aligned_buffer: alignment must be a power of two"};
+            }
+            size_ = align_up(size, alignment);
+            if (size_ != 0) {
+                data_ = static_cast<std::byte*>(::operator new(size_, std::align_val_t{alignment_}));
+            }
+        }
+
+        aligned_buffer(const aligned_buffer&) = delete;
+
+        aligned_buffer(aligned_buffer&& other) noexcept :
+            data_(std::exchange(other.data_, nullptr)),
+            size_(std::exchange(other.size_, 0)),
+            alignment_(other.alignment_) {}
+
+        ~aligned_buffer() {
+            if (data_ != nullptr) {
+                ::operator delete(data_, size_, std::align_val_t{alignment_});
+            }
+        }
+
+        auto operator= (aligned_buffer other) noexcept -> aligned_buffer& {
+            swap(other);
+            return *this;
+        }
+
+        auto swap(aligned_buffer& other) noexcept -> void {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            std::swap(alignment_, other.alignment_);
+        }
+
+        friend auto swap(aligned_buffer& lhs, aligned_buffer& rhs) noexcept -> void {
+            lhs.swap(rhs);
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto data() const noexcept -> std::byte* {
+            return data_;
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto size() const noexcept -> std::size_t {
+            return size_;
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto empty() const noexcept -> bool {
+            return size_ == 0;
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto alignment() const noexcept -> std::size_t {
+            return alignment_;
+        }
+
+        /**
+         * \brief the whole buffer.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto bytes() const noexcept -> std::span<std::byte> {
+            return {data_, size_};
+        }
+
+    private:
+        std::byte* data_ = nullptr;
+        std::size_t size_ = 0;
+        std::size_t alignment_ = alignof(std::max_align_t);
+    };
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
@@ -0,0 +1,187 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <coio/detail/config.h>
+#include <coio/utils/frame_pool_resource.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio {
+    class buffer_pool;
+
+    /**
+     * \brief a block of bytes borrowed from a `buffer_pool`, given back when the lease is destroyed.
+     */
+    class buffer_lease {
+        friend buffer_pool;
+    public:
+        buffer_lease() = default;
+
+        buffer_lease(const buffer_lease&) = delete;
+
+        buffer_lease(buffer_lease&& other) noexcept :
+            pool_(std::exchange(other.pool_, nullptr)),
+            data_(std::exchange(other.data_, nullptr)),
+            size_(std::exchange(other.size_, 0)) {}
+
+        ~buffer_lease() {
+            reset();
+        }
+
+        auto operator= (const buffer_lease&) -> buffer_lease& = delete;
+
+        auto operator= (buffer_lease&& other) noexcept -> buffer_lease& {
+            if (this != &other) {
+                reset();
+                pool_ = std::exchange(other.pool_, nullptr);
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+            }
+            return *this;
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto data() const noexcept -> std::byte* {
+            return data_;
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto size() const noexcept -> std::size_t {
+            return size_;
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto empty() const noexcept -> bool {
+            return size_ == 0;
+        }
+
+        /**
+         * \brief the leased bytes.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto bytes() const noexcept -> std::span<std::byte> {
+            return {data_, size_};
+        }
+
+        /**
+         * \brief the pool the bytes are borrowed from, or null if the lease is empty.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto pool() const noexcept -> buffer_pool* {
+            return pool_;
+        }
+
+        /**
+         * \brief give the bytes back now.
+         */
+        auto reset() noexcept -> void;
+
+        friend auto swap(buffer_lease& lhs, buffer_lease& rhs) noexcept -> void {
+            std::swap(lhs.pool_, rhs.pool_);
+            std::swap(lhs.data_, rhs.data_);
+            std::swap(lhs.size_, rhs.size_);
+        }
+
+    private:
+        buffer_lease(buffer_pool& pool, std::byte* data, std::size_t size) noexcept : pool_(&pool), data_(data), size_(size) {}
+
+    private:
+        buffer_pool* pool_ = nullptr;
+        std::byte* data_ = nullptr;
+        std::size_t size_ = 0;
+    };
+
+    /**
+     * \brief a pool for the transient buffers of I/O, such as a connection's read buffer.
+     *
+     * A `frame_pool_resource` sized for buffers: blocks of up to 64 KiB by default are grouped in size classes and
+     * cached per thread, so a buffer leased and given back on one thread takes no lock. Every context owns one, which
+     * is the *current* pool on the threads running the context: `pooled_flat_buffer` and `pooled_streambuf` allocate
+     * from it, and a request that reuses buffers of the same sizes allocates nothing once the pool has warmed up.
+     */
+    class buffer_pool : public frame_pool_resource {
+    public:
+        buffer_pool();
+
+        explicit buffer_pool(std::pmr::memory_resource& upstream);
+
+        explicit buffer_pool(const options& opts, std::pmr::memory_resource& upstream = *std::pmr::get_default_resource());
+
+        /**
+         * \brief borrow `size` bytes, aligned to `alignof(std::max_align_t)`.
+         * \throw std::bad_alloc if neither the pool nor upstream can provide them.
+         */
+        [[nodiscard]]
+        auto lease(std::size_t size) -> buffer_lease {
+            return {*this, static_cast<std::byte*>(allocate(size, alignof(std::max_align_t))), size};
+        }
+
+        /**
+         * \brief the pool of the context running on this thread, or a process-wide pool if there is none.
+         */
+        [[nodiscard]]
+        static auto current() noexcept -> buffer_pool&;
+
+        /**
+         * \brief make `pool` the current pool of this thread, null for none; contexts do so while they run.
+         * \return the previous one.
+         */
+        static auto set_current(buffer_pool* pool) noexcept -> buffer_pool*;
+    };
+
+    inline auto buffer_lease::reset() noexcept -> void {
+        if (pool_ != nullptr) {
+            pool_->deallocate(data_, size_, alignof(std::max_align_t));
+            pool_ = nullptr;
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    /**
+     * \brief an allocator drawing from a `buffer_pool`, by default the current one when it is constructed.
+     */
+    template<typename T>
+    class buffer_pool_allocator {
+        template<typename>
+        friend class buffer_pool_allocator;
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+    public:
+        buffer_pool_allocator() noexcept : pool_(&buffer_pool::current()) {}
+
+        buffer_pool_allocator(buffer_pool& pool) noexcept : pool_(&pool) {} // NOLINT(*-explicit-constructor)
+
+        template<typename U>
+        buffer_pool_allocator(const buffer_pool_allocator<U>& other) noexcept : pool_(other.pool_) {} // NOLINT(*-explicit-constructor)
+
+        [[nodiscard]]
+        auto allocate(std::size_t n) -> T* {
+            return static_cast<T*>(pool_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        auto deallocate(T* p, std::size_t n) noexcept -> void {
+            pool_->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto pool() const noexcept -> buffer_pool& {
+            return *pool_;
+        }
+
+        template<typename U>
+        friend auto operator== (const buffer_pool_allocator& lhs, const buffer_pool_allocator<U>& rhs) noexcept -> bool {
+            return &lhs.pool() == &rhs.pool();
+        }
+
+    private:
+        buffer_pool* pool_;
+    };
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
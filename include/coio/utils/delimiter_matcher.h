@@ -0,0 +1,99 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <coio/detail/config.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio {
+    /**
+     * \brief a set of delimiters, prepared once to be searched for together, e.g. by `read_until`.
+     *
+     * The search looks for the first byte of any delimiter with SIMD, then checks the delimiters starting
+     * with the byte found. The earliest match wins; of the delimiters matching at the same position, the
+     * longest does.
+     */
+    class delimiter_matcher {
+    public:
+        /**
+         * \brief a delimiter found in the searched data.
+         */
+        struct match {
+            /// the offset of its first byte.
+            std::size_t position;
+
+            /// its length.
+            std::size_t size;
+
+            /// its index among the delimiters the matcher was constructed with.
+            std::size_t index;
+        };
+
+    public:
+        /// \throw std::invalid_argument if a delimiter is empty.
+        delimiter_matcher(std::initializer_list<std::string_view> delimiters);
+
+        /// \throw std::invalid_argument if a delimiter is empty.
+        explicit delimiter_matcher(std::span<const std::string_view> delimiters);
+
+        /**
+         * \brief the earliest delimiter in `data` starting at `from` or later.
+         */
+        [[nodiscard]]
+        auto find(std::span<const std::byte> data, std::size_t from = 0) const noexcept -> std::optional<match>;
+
+        /**
+         * \brief the earliest delimiter in the concatenation of `data`, starting at `from` or later, even across segments.
+         */
+        [[nodiscard]]
+        auto find(std::span<const std::span<const std::byte>> data, std::size_t from = 0) const noexcept -> std::optional<match>;
+
+        /**
+         * \brief the number of delimiters.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto size() const noexcept -> std::size_t {
+            return entries_.size();
+        }
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto empty() const noexcept -> bool {
+            return entries_.empty();
+        }
+
+        /**
+         * \brief the length of the longest delimiter.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto max_length() const noexcept -> std::size_t {
+            return max_length_;
+        }
+
+    private:
+        struct entry {
+            std::uint32_t offset; // in `bytes_`
+            std::uint32_t size;
+            std::uint32_t index;
+        };
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto view(const entry& e) const noexcept -> std::string_view {
+            return {bytes_.data() + e.offset, e.size};
+        }
+
+    private:
+        std::string bytes_;           // the delimiters, one after another
+        std::vector<entry> entries_;  // grouped by first byte, longest first within a group
+        std::array<std::uint32_t, 257> groups_{}; // the delimiters starting with byte `b` are `entries_[groups_[b], groups_[b + 1])`
+        std::string first_bytes_;     // each first byte once
+        std::size_t max_length_ = 0;
+    };
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
@@ -7,6 +7,7 @@
 #include <stdexcept>
 #include <utility>
 #include <coio/detail/config.h>
+#include <coio/utils/buffer_pool.h>
 
 namespace coio {
     /// A dynamic buffer similar to boost::beast::flat_buffer
@@ -366,4 +367,7 @@ namespace coio {
     };
 
     using flat_buffer = basic_flat_buffer<std::allocator<std::byte>>;
+
+    /// a `flat_buffer` drawing from the current `buffer_pool`, that of the context it is created on
+    using pooled_flat_buffer = basic_flat_buffer<buffer_pool_allocator<std::byte>>;
 }
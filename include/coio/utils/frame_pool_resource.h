@@ -0,0 +1,146 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+#include <coio/detail/config.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio {
+    /**
+     * \brief a `std::pmr::memory_resource` that pools small blocks, such as coroutine frames, per thread.
+     *
+     * Blocks are grouped in size classes, four per doubling, and carved from slabs obtained from `upstream`.
+     * Each thread allocating from the resource gets its own cache of free blocks, so allocating and freeing on
+     * one thread takes no lock and no atomic read-modify-write. A block freed on another thread goes back to
+     * its owner through a lock-free return list, which the owner takes over when its own list runs dry.
+     * Requests larger than `options::max_block_size`, or aligned to more than `alignof(std::max_align_t)`,
+     * are passed to `upstream`.
+     *
+     * Slabs are kept until the resource is destroyed: the memory held is that of the peak usage.
+     * Like any `pmr` resource, it must outlive every allocation made through it.
+     */
+    class frame_pool_resource : public std::pmr::memory_resource {
+    public:
+        /**
+         * \brief construction parameters of a `frame_pool_resource`.
+         */
+        struct options {
+            /// the largest request served from the pool, at most an eighth of `slab_size`.
+            std::size_t max_block_size = 16 * 1024;
+
+            /// the size, and alignment, of the slabs obtained from upstream; rounded up to a power of two.
+            std::size_t slab_size = 64 * 1024;
+        };
+
+        /**
+         * \brief counters of a `frame_pool_resource`, summed over its threads.
+         * \note blocks in use are `allocations - deallocations - remote_deallocations`.
+         */
+        struct statistics {
+            /// blocks handed out from the pool.
+            std::size_t allocations = 0;
+
+            /// blocks given back on the thread that owns them.
+            std::size_t deallocations = 0;
+
+            /// blocks given back on another thread, through the owner's return list.
+            std::size_t remote_deallocations = 0;
+
+            /// requests passed to upstream for being too large or too aligned.
+            std::size_t upstream_allocations = 0;
+
+            /// slabs obtained from upstream.
+            std::size_t slabs = 0;
+
+            /// threads that have allocated from the pool, including those that have exited since.
+            std::size_t thread_caches = 0;
+        };
+
+    public:
+        frame_pool_resource();
+
+        explicit frame_pool_resource(std::pmr::memory_resource& upstream);
+
+        explicit frame_pool_resource(const options& opts, std::pmr::memory_resource& upstream = *std::pmr::get_default_resource());
+
+        frame_pool_resource(const frame_pool_resource&) = delete;
+
+        /// \note every block shall have been deallocated by now; the slabs are returned to upstream.
+        ~frame_pool_resource() override;
+
+        auto operator= (const frame_pool_resource&) -> frame_pool_resource& = delete;
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto upstream_resource() const noexcept -> std::pmr::memory_resource* {
+            return upstream_;
+        }
+
+        /**
+         * \brief the largest request served from the pool, and the size of its slabs.
+         */
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto get_options() const noexcept -> options {
+            return {max_block_size_, slab_size_};
+        }
+
+        /**
+         * \brief a snapshot of the counters; each is exact, but they are read one by one while other threads go on.
+         */
+        [[nodiscard]]
+        auto stats() const -> statistics;
+
+    protected:
+        auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override;
+
+        auto do_deallocate(void* p, std::size_t bytes, std::size_t alignment) -> void override;
+
+        auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override {
+            return this == &other;
+        }
+
+    private:
+        struct thread_cache;
+        struct slab_header;
+        struct thread_registry;
+
+        [[nodiscard]]
+        static auto this_thread_registry() noexcept -> thread_registry*&;
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto pooled(std::size_t bytes, std::size_t alignment) const noexcept -> bool {
+            return bytes <= max_block_size_ and alignment <= alignof(std::max_align_t);
+        }
+
+        [[nodiscard]]
+        auto local_cache() -> thread_cache*;
+
+        [[nodiscard]]
+        auto take_cache() -> thread_cache&;
+
+        [[nodiscard]]
+        auto allocate_from(thread_cache& cache, std::size_t bytes) -> void*;
+
+        [[nodiscard]]
+        auto refill(thread_cache& cache, std::size_t size_class) -> void*;
+
+        auto abandon(thread_cache& cache) noexcept -> void;
+
+    private:
+        std::uint64_t id_;
+        std::pmr::memory_resource* upstream_;
+        std::size_t slab_size_;
+        std::size_t max_block_size_;
+        std::size_t class_count_;
+        mutable std::mutex mtx_; // guards everything below, and the calls to `upstream_`
+        std::vector<thread_cache*> caches_;
+        std::vector<thread_cache*> idle_caches_; // left by threads that have exited, for the next new thread
+        slab_header* slabs_ = nullptr;
+        std::size_t slab_count_ = 0;
+        std::atomic<std::size_t> upstream_allocations_{0};
+    };
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
@@ -0,0 +1,327 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <coio/detail/config.h>
+#include <coio/utils/buffer_pool.h>
+
+namespace coio {
+    /// A dynamic buffer made of a chain of fixed-size blocks, similar to boost::beast::multi_buffer
+    ///
+    /// Buffer layout:
+    /// |<-- consumed -->|<-- readable data -->|<-- prepared -->|<-- free -->|
+    /// [ block 0      ][ block 1             ][ block 2             ]...
+    /// ^                ^
+    /// blocks_[0]       blocks_[0] + in_
+    ///
+    /// Growing never moves the bytes already held: `prepare` appends blocks, `consume` recycles the blocks it
+    /// empties for the next `prepare`. `data()` and `prepare()` are thus sequences of spans, one per block,
+    /// suited to scatter/gather I/O.
+    template<typename Alloc>
+    class basic_segmented_buffer {
+    public:
+        using allocator_type = std::allocator_traits<Alloc>::template rebind_alloc<std::byte>;
+
+        static constexpr std::size_t default_block_size = 4096;
+
+    private:
+        using alloc_traits = std::allocator_traits<allocator_type>;
+
+        template<typename T>
+        using vector = std::vector<T, typename alloc_traits::template rebind_alloc<T>>;
+
+    public:
+        basic_segmented_buffer() = default;
+
+        explicit basic_segmented_buffer(const allocator_type& alloc) noexcept :
+            alloc_(alloc), blocks_(alloc), spare_(alloc), data_spans_(alloc), prepared_spans_(alloc) {}
+
+        explicit basic_segmented_buffer(
+            std::size_t max_size,
+            std::size_t block_size = default_block_size,
+            const allocator_type& alloc = allocator_type()
+        ) noexcept :
+            alloc_(alloc), max_(max_size), block_size_(std::max<std::size_t>(block_size, 1)),
+            blocks_(alloc), spare_(alloc), data_spans_(alloc), prepared_spans_(alloc) {}
+
+        basic_segmented_buffer(const basic_segmented_buffer&) = delete;
+
+        basic_segmented_buffer(basic_segmented_buffer&& other) noexcept
+            : alloc_(std::move(other.alloc_)),
+              max_(other.max_),
+              block_size_(other.block_size_),
+              blocks_(std::move(other.blocks_)),
+              spare_(std::move(other.spare_)),
+              data_spans_(std::move(other.data_spans_)),
+              prepared_spans_(std::move(other.prepared_spans_)),
+              in_(std::exchange(other.in_, 0)),
+              size_(std::exchange(other.size_, 0)),
+              prepared_(std::exchange(other.prepared_, 0)) {
+            other.data_spans_.clear();
+            other.prepared_spans_.clear();
+        }
+
+        auto operator= (const basic_segmented_buffer&) -> basic_segmented_buffer& = delete;
+
+        auto operator= (basic_segmented_buffer&& other) noexcept(
+            alloc_traits::propagate_on_container_move_assignment::value or
+            alloc_traits::is_always_equal::value
+        ) -> basic_segmented_buffer& {
+            if (this == &other) {
+                return *this;
+            }
+
+            static constexpr bool propagate = alloc_traits::propagate_on_container_move_assignment::value;
+
+            if (propagate or alloc_ == other.alloc_) {
+                destroy();
+                if constexpr (propagate) {
+                    alloc_ = std::move(other.alloc_);
+                }
+                max_ = other.max_;
+                block_size_ = other.block_size_;
+                blocks_ = std::move(other.blocks_);
+                spare_ = std::move(other.spare_);
+                data_spans_ = std::move(other.data_spans_);
+                prepared_spans_ = std::move(other.prepared_spans_);
+                in_ = std::exchange(other.in_, 0);
+                size_ = std::exchange(other.size_, 0);
+                prepared_ = std::exchange(other.prepared_, 0);
+                other.blocks_.clear();
+                other.spare_.clear();
+                other.data_spans_.clear();
+                other.prepared_spans_.clear();
+                return *this;
+            }
+
+            // the blocks can't change hands: copy the readable bytes into blocks of our own
+            clear();
+            max_ = other.max_;
+            for (const auto segment : other.data()) {
+                std::size_t copied = 0;
+                for (const auto target : prepare(segment.size())) {
+                    std::memcpy(target.data(), segment.data() + copied, target.size());
+                    copied += target.size();
+                }
+                commit(segment.size());
+            }
+            other.clear();
+            return *this;
+        }
+
+        ~basic_segmented_buffer() {
+            destroy();
+        }
+
+        [[nodiscard]]
+        auto get_allocator() const noexcept -> allocator_type {
+            return alloc_;
+        }
+
+        [[nodiscard]]
+        auto size() const noexcept -> std::size_t {
+            return size_;
+        }
+
+        [[nodiscard]]
+        auto empty() const noexcept -> bool {
+            return size_ == 0;
+        }
+
+        [[nodiscard]]
+        auto max_size() const noexcept -> std::size_t {
+            return max_;
+        }
+
+        /// the bytes the buffer can hold without allocating another block
+        [[nodiscard]]
+        auto capacity() const noexcept -> std::size_t {
+            return (blocks_.size() + spare_.size()) * block_size_ - in_;
+        }
+
+        [[nodiscard]]
+        auto block_size() const noexcept -> std::size_t {
+            return block_size_;
+        }
+
+        /// the readable bytes, one span per block; valid until the buffer is next modified
+        [[nodiscard]]
+        auto data() const noexcept -> std::span<const std::span<const std::byte>> {
+            return data_spans_;
+        }
+
+        [[nodiscard]]
+        auto cdata() const noexcept -> std::span<const std::span<const std::byte>> { return data(); }
+
+        /// `n` writable bytes after the readable ones, one span per block; valid until the buffer is next modified
+        [[nodiscard]]
+        auto prepare(std::size_t n) -> std::span<const std::span<std::byte>> {
+            if (n > max_ - size_) {
+                throw std::length_error("coio::segmented_buffer too long");
+            }
+
+            prepared_ = 0;
+            prepared_spans_.clear();
+            if (n == 0) {
+                return {};
+            }
+
+            const std::size_t first = in_ + size_;
+            const std::size_t last = first + n;
+            const std::size_t block_count = (last + block_size_ - 1) / block_size_;
+            while (blocks_.size() < block_count) {
+                take_block();
+            }
+
+            for (std::size_t pos = first; pos < last;) {
+                const std::size_t offset = pos % block_size_;
+                const std::size_t len = std::min(block_size_ - offset, last - pos);
+                prepared_spans_.push_back({blocks_[pos / block_size_] + offset, len});
+                pos += len;
+            }
+            prepared_ = n;
+            return prepared_spans_;
+        }
+
+        auto commit(std::size_t n) noexcept -> void {
+            n = std::min(n, prepared_);
+            // extend the readable spans over the committed bytes, the last one grows while still in its block
+            for (std::size_t pos = in_ + size_, last = pos + n; pos < last;) {
+                const std::size_t offset = pos % block_size_;
+                const std::size_t len = std::min(block_size_ - offset, last - pos);
+                if (offset != 0 and not data_spans_.empty()) {
+                    const auto back = data_spans_.back();
+                    data_spans_.back() = {back.data(), back.size() + len};
+                }
+                else {
+                    data_spans_.push_back({blocks_[pos / block_size_] + offset, len}); // room reserved by `take_block`
+                }
+                pos += len;
+            }
+            size_ += n;
+            prepared_ -= n;
+        }
+
+        auto consume(std::size_t n) noexcept -> void {
+            n = std::min(n, size_);
+            in_ += n;
+            size_ -= n;
+            if (size_ == 0 and prepared_ == 0) {
+                in_ = 0; // the first block is reused from its start
+                data_spans_.clear();
+                return;
+            }
+
+            // hand the emptied blocks over for the next `prepare`; `spare_` has room for all, see `take_block`
+            if (const std::size_t emptied = in_ / block_size_; emptied > 0) {
+                spare_.insert(spare_.end(), blocks_.begin(), blocks_.begin() + static_cast<std::ptrdiff_t>(emptied));
+                blocks_.erase(blocks_.begin(), blocks_.begin() + static_cast<std::ptrdiff_t>(emptied));
+                in_ -= emptied * block_size_;
+            }
+
+            // drop the consumed bytes from the front of the readable spans
+            auto first = data_spans_.begin();
+            for (; first != data_spans_.end() and n >= first->size(); ++first) n -= first->size();
+            if (first != data_spans_.end()) *first = first->subspan(n);
+            data_spans_.erase(data_spans_.begin(), first);
+        }
+
+        auto clear() noexcept -> void {
+            in_ = 0;
+            size_ = 0;
+            prepared_ = 0;
+            data_spans_.clear();
+        }
+
+        /// free the blocks holding neither readable nor prepared bytes
+        auto shrink_to_fit() noexcept -> void {
+            for (std::byte* block : spare_) {
+                alloc_traits::deallocate(alloc_, block, block_size_);
+            }
+            spare_.clear();
+            const std::size_t used = (in_ + size_ + prepared_ + block_size_ - 1) / block_size_;
+            while (blocks_.size() > used) {
+                alloc_traits::deallocate(alloc_, blocks_.back(), block_size_);
+                blocks_.pop_back();
+            }
+        }
+
+        auto swap(
+            basic_segmented_buffer& other
+        ) noexcept(
+            alloc_traits::propagate_on_container_swap::value or
+            alloc_traits::is_always_equal::value
+        ) -> void {
+            static constexpr bool propagate = alloc_traits::propagate_on_container_swap::value;
+            if constexpr (propagate) {
+                std::swap(alloc_, other.alloc_);
+            }
+            COIO_ASSERT(propagate or alloc_ == other.alloc_);
+
+            std::swap(max_, other.max_);
+            std::swap(block_size_, other.block_size_);
+            blocks_.swap(other.blocks_);
+            spare_.swap(other.spare_);
+            data_spans_.swap(other.data_spans_);
+            prepared_spans_.swap(other.prepared_spans_);
+            std::swap(in_, other.in_);
+            std::swap(size_, other.size_);
+            std::swap(prepared_, other.prepared_);
+        }
+
+        friend auto swap(basic_segmented_buffer& lhs, basic_segmented_buffer& rhs) noexcept(noexcept(lhs.swap(rhs))) -> void {
+            lhs.swap(rhs);
+        }
+
+    private:
+        // append a block, reused or new, to `blocks_`
+        auto take_block() -> void {
+            if (not spare_.empty()) {
+                blocks_.push_back(spare_.back()); // `blocks_` is reserved for every block, see below
+                spare_.pop_back();
+                return;
+            }
+            // reserve room for every block in each list, so that `consume` and `data` never allocate
+            const std::size_t total = blocks_.size() + spare_.size() + 1;
+            blocks_.reserve(total);
+            spare_.reserve(total);
+            data_spans_.reserve(total);
+            prepared_spans_.reserve(total);
+            blocks_.push_back(alloc_traits::allocate(alloc_, block_size_));
+        }
+
+        auto destroy() noexcept -> void {
+            for (std::byte* block : blocks_) {
+                alloc_traits::deallocate(alloc_, block, block_size_);
+            }
+            for (std::byte* block : spare_) {
+                alloc_traits::deallocate(alloc_, block, block_size_);
+            }
+            blocks_.clear();
+            spare_.clear();
+            clear();
+        }
+
+    private:
+        COIO_NO_UNIQUE_ADDRESS allocator_type alloc_;
+        std::size_t max_ = std::numeric_limits<std::size_t>::max();
+        std::size_t block_size_ = default_block_size;
+        vector<std::byte*> blocks_{alloc_};  // in order; the readable bytes start `in_` into the first
+        vector<std::byte*> spare_{alloc_};   // emptied blocks, kept for the next `prepare`
+        vector<std::span<const std::byte>> data_spans_{alloc_}; // kept up to date by `commit` and `consume`
+        vector<std::span<std::byte>> prepared_spans_{alloc_};
+        std::size_t in_ = 0;
+        std::size_t size_ = 0;
+        std::size_t prepared_ = 0;
+    };
+
+    using segmented_buffer = basic_segmented_buffer<std::allocator<std::byte>>;
+
+    /// a `segmented_buffer` drawing its blocks from the current `buffer_pool`, that of the context it is created on
+    using pooled_segmented_buffer = basic_segmented_buffer<buffer_pool_allocator<std::byte>>;
+}
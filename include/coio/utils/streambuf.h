@@ -5,6 +5,7 @@
 #include <span>
 #include <streambuf>
 #include <vector>
+#include <coio/utils/buffer_pool.h>
 
 namespace coio {
     template<typename Allocator>
@@ -125,4 +126,7 @@ namespace coio {
     };
 
     using streambuf = basic_streambuf<std::allocator<char>>;
+
+    /// a `streambuf` drawing from the current `buffer_pool`, that of the context it is created on
+    using pooled_streambuf = basic_streambuf<buffer_pool_allocator<char>>;
 }
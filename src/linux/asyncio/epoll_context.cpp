@@ -2,12 +2,17 @@
 #include <coio/detail/config.h>
 #if COIO_HAS_EPOLL
 #include <algorithm>
+#include <cstring>
+#include <limits>
 #include <ranges>
 #include <fcntl.h>
+#include <linux/errqueue.h>
 #include <poll.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
+#include <sys/sendfile.h>
 #include <sys/stat.h>
+#include <sys/timerfd.h>
 #include <coio/asyncio/epoll_context.h>
 #include "../common.h"
 
@@ -15,6 +20,8 @@ namespace coio {
     namespace detail {
         namespace {
             constexpr int epoll_max_wait_count = 128;
+
+            constexpr std::size_t max_sendfile_size = 0x7ffff000; // the most Linux moves in one call
         }
 
         reactor_interrupter::reactor_interrupter() {
@@ -76,61 +83,96 @@ namespace coio {
         }
     }
 
-    auto epoll_context::epoll_node::register_event(int event_type) noexcept -> register_result {
-        int epoll_ctl_errno = 0;
-
-        std::unique_lock guard{data->fd_lock};
-        const bool in_op_registered = data->in_op;
-        const bool out_op_registered = data->out_op;
-        if (event_type == EPOLLIN /* or event_type == EPOLLPRI */) {
-            COIO_ASSERT(not in_op_registered && "an asynchronous input operation shall be initiated after another input operation has completed.");
-        }
-        else if (event_type == EPOLLOUT) {
-            COIO_ASSERT(not out_op_registered && "an asynchronous output operation shall be initiated after another output operation has completed.");
+    auto epoll_context::op_slot::arm(epoll_node* op, bool op_pinned) noexcept -> bool {
+        const auto armed_state = reinterpret_cast<std::uintptr_t>(op) | (op_pinned ? pinned : 0);
+        auto state = state_.load(std::memory_order_acquire);
+        while (true) {
+            if (state == ready) {
+                if (state_.compare_exchange_weak(state, idle, std::memory_order_acq_rel, std::memory_order_acquire)) return false;
+                continue;
+            }
+            COIO_ASSERT(state == idle);
+            if (state_.compare_exchange_weak(state, armed_state, std::memory_order_acq_rel, std::memory_order_acquire)) return true;
         }
-        else unreachable();
+    }
 
-        // under EPOLLET an edge reported while no op claims it is recorded by do_one into
-        // `ready_events`; consume it here and make the caller retry the I/O, otherwise the
-        // edge would be lost forever whenever the unchanged mask lets us skip epoll_ctl below
-        const std::uint32_t interest = event_type | EPOLLERR | EPOLLHUP;
-        if (data->ready_events & interest) {
-            data->ready_events &= ~interest;
-            return register_result::ready;
+    auto epoll_context::op_slot::claim() noexcept -> epoll_node* {
+        auto state = state_.load(std::memory_order_acquire);
+        while (true) {
+            if (state == idle) {
+                if (state_.compare_exchange_weak(state, ready, std::memory_order_acq_rel, std::memory_order_acquire)) return nullptr;
+                continue;
+            }
+            if (state == ready) return nullptr;
+            COIO_ASSERT((state & (running | cancelled)) == 0 && "only the reactor runs operations");
+            if (state_.compare_exchange_weak(state, state | running, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return reinterpret_cast<epoll_node*>(state & ~tags);
+            }
         }
+    }
 
-        std::uint32_t ev = event_type | EPOLLET;
-        int epoll_ctl_op = data->events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
-
-        if (in_op_registered) {
-            ev |= EPOLLIN;
-            epoll_ctl_op = EPOLL_CTL_MOD;
-        }
-        if (out_op_registered) {
-            ev |= EPOLLOUT;
-            epoll_ctl_op = EPOLL_CTL_MOD;
+    auto epoll_context::op_slot::rearm(epoll_node* op, bool op_pinned) noexcept -> bool {
+        const auto armed_state = reinterpret_cast<std::uintptr_t>(op) | (op_pinned ? pinned : 0);
+        auto state = state_.load(std::memory_order_acquire);
+        while (true) {
+            // a pinned operation ignores the cancellation, like a canceller that finds it pinned
+            if ((state & cancelled) and not op_pinned) {
+                state_.store(idle, std::memory_order_release);
+                return false;
+            }
+            if (state_.compare_exchange_weak(state, armed_state, std::memory_order_acq_rel, std::memory_order_acquire)) return true;
         }
+    }
 
-        bool ok = ev == data->events;
-        if (not ok) {
-            ::epoll_event event{.events = ev, .data = {.ptr = data}};
-            ok = ::epoll_ctl(context_.epoll_fd_, epoll_ctl_op, fd, &event) == 0;
-            if (not ok) epoll_ctl_errno = errno; // capture before unlocking below
-        }
-        if (ok) [[likely]] {
-            data->events = ev;
-            if (event_type == EPOLLIN /* or event_type == EPOLLPRI */) {
-                data->in_op = this;
+    auto epoll_context::op_slot::take(epoll_node* op) noexcept -> epoll_node* {
+        auto state = state_.load(std::memory_order_acquire);
+        while (true) {
+            const auto current = state & ~tags;
+            if (current == 0 or (op != nullptr and current != reinterpret_cast<std::uintptr_t>(op)) or (state & (cancelled | pinned))) {
+                return nullptr;
             }
-            else if (event_type == EPOLLOUT) {
-                data->out_op = this;
+            // a running operation belongs to the reactor: leave it a note to publish the operation if it would block
+            const auto desired = (state & running) ? state | cancelled : idle;
+            if (state_.compare_exchange_weak(state, desired, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return (state & running) ? nullptr : reinterpret_cast<epoll_node*>(current);
             }
-            return register_result::armed;
         }
+    }
 
-        guard.unlock();
-        errno = epoll_ctl_errno;
-        return register_result::failure;
+    auto epoll_context::epoll_node::register_event(int event_type) noexcept -> register_result {
+        op_slot* slot = nullptr;
+        if (event_type == EPOLLIN /* or event_type == EPOLLPRI */) {
+            slot = &data->in_slot;
+            COIO_ASSERT(not slot->armed() && "an asynchronous input operation shall be initiated after another input operation has completed.");
+        }
+        else if (event_type == EPOLLOUT) {
+            slot = &data->out_slot;
+            COIO_ASSERT(not slot->armed() && "an asynchronous output operation shall be initiated after another output operation has completed.");
+        }
+        else unreachable();
+
+        if (not add_interest(event_type)) [[unlikely]] return register_result::failure;
+
+        // under EPOLLET an edge reported while no op claims it is recorded by do_one into the slot;
+        // consume it here and make the caller retry the I/O, otherwise the edge would be lost forever
+        return slot->arm(this, pinned) ? register_result::armed : register_result::ready;
+    }
+
+    auto epoll_context::epoll_node::add_interest(int event_type) noexcept -> bool {
+        // the interest set only grows: past the first operation in each direction, this is a single load
+        if ((data->events.load(std::memory_order_acquire) & static_cast<std::uint32_t>(event_type)) != 0) [[likely]] return true;
+        std::unique_lock guard{data->fd_lock};
+        const std::uint32_t events = data->events.load(std::memory_order_relaxed);
+        if ((events & static_cast<std::uint32_t>(event_type)) != 0) return true;
+        ::epoll_event event{.events = events | static_cast<std::uint32_t>(event_type | EPOLLET), .data = {.ptr = data}};
+        if (::epoll_ctl(context_.epoll_fd_, events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event) == -1) {
+            const int epoll_ctl_errno = errno; // capture before unlocking below
+            guard.unlock();
+            errno = epoll_ctl_errno;
+            return false;
+        }
+        data->events.store(event.events, std::memory_order_release);
+        return true;
     }
 
 
@@ -140,12 +182,20 @@ namespace coio {
         if (::fstat(fd, &st) == -1) [[unlikely]] {
             throw std::system_error{errno, std::system_category(), "fstat"};
         }
-        if (S_ISREG(st.st_mode) or S_ISDIR(st.st_mode)) [[unlikely]] {
+        if (S_ISDIR(st.st_mode)) [[unlikely]] {
             throw std::system_error{
                 std::make_error_code(std::errc::operation_not_permitted),
                 "the target file `fd` doesn't support epoll"
             };
         }
+        if (S_ISREG(st.st_mode)) {
+            // always "ready" to epoll, and blocking all the same: left blocking, its operations go to the file threads
+            data_ = ctx_->new_epoll_data();
+            std::scoped_lock _{ctx_->file_mtx_};
+            data_->offloaded = true;
+            data_->file_queue_depth = ctx_->file_queue_depth_;
+            return;
+        }
         const int flags = ::fcntl(fd, F_GETFL);
         if (flags == -1) [[unlikely]] {
             throw std::system_error{errno, std::system_category(), "fcntl(fd, F_GETFL)"};
@@ -169,11 +219,18 @@ namespace coio {
     auto epoll_context::scheduler::io_object::close() -> void {
         if (fd_ == -1) return;
         COIO_ASSERT(data_ != nullptr);
+        if (data_->offloaded) {
+            // the queued operations complete as stopped; the running ones still use `fd_` and `data_`
+            ctx_->cancel_file_ops(data_);
+            std::unique_lock guard{ctx_->file_mtx_};
+            data_->file_draining = true;
+            ctx_->file_drained_cv_.wait(guard, [this] { return data_->file_running == 0; });
+        }
         {
             std::scoped_lock _{data_->fd_lock};
-            if (data_->events != 0) {
+            if (data_->events.load(std::memory_order_relaxed) != 0) {
                 static_cast<void>(::epoll_ctl(ctx_->epoll_fd_, EPOLL_CTL_DEL, fd_, nullptr));
-                data_->events = 0;
+                data_->events.store(0, std::memory_order_relaxed);
             }
         }
         ctx_->reclaim_epoll_data(std::exchange(data_, nullptr));
@@ -183,13 +240,11 @@ namespace coio {
     auto epoll_context::scheduler::io_object::cancel() -> void {
         if (fd_ == -1) return;
         COIO_ASSERT(data_ != nullptr);
-        const auto ops = [this]{
-            std::scoped_lock _{data_->fd_lock};
-            return std::array{
-                std::exchange(data_->in_op, nullptr),
-                std::exchange(data_->out_op, nullptr)
-            };
-        }();
+        if (data_->offloaded) {
+            ctx_->cancel_file_ops(data_);
+            return;
+        }
+        const std::array ops{data_->in_slot.take(), data_->out_slot.take()};
         for (auto op : ops) {
             if (op != nullptr) op->publish();
         }
@@ -243,8 +298,21 @@ namespace coio {
         detail::file_resize(fd_, new_size);
     }
 
-    epoll_context::epoll_context(std::pmr::memory_resource& memory_resource) :
-        loop_base(memory_resource), data_pool_(&memory_resource), epoll_fd_(detail::create_epoll())
+    auto epoll_context::scheduler::io_object::set_queue_depth(std::size_t depth) -> void {
+        if (data_ == nullptr or not data_->offloaded) {
+            throw std::system_error{std::make_error_code(std::errc::operation_not_supported), "set_queue_depth"};
+        }
+        ctx_->set_file_queue_depth(data_, static_cast<std::uint32_t>(std::clamp<std::size_t>(depth, 1, std::numeric_limits<std::uint32_t>::max())));
+    }
+
+    epoll_context::epoll_context(std::pmr::memory_resource& memory_resource) : epoll_context(options{}, memory_resource) {}
+
+    epoll_context::epoll_context(const options& opts, std::pmr::memory_resource& memory_resource) :
+        loop_base(memory_resource),
+        data_pool_(&memory_resource),
+        epoll_fd_(detail::create_epoll()),
+        file_thread_limit_(std::max<std::size_t>(opts.file_threads, 1)),
+        file_queue_depth_(static_cast<std::uint32_t>(std::clamp<std::size_t>(opts.file_queue_depth, 1, std::numeric_limits<std::uint32_t>::max())))
     {
         ::epoll_event event {
             .events = std::uint32_t(EPOLLIN | EPOLLET),
@@ -254,12 +322,60 @@ namespace coio {
             ::close(epoll_fd_);
             throw std::system_error(errno, std::system_category());
         }
+        // optional: without it timers are rounded up to milliseconds
+        timer_fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        if (timer_fd_ != -1) [[likely]] {
+            event.data.ptr = &timer_fd_;
+            if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &event) == -1) [[unlikely]] {
+                ::close(std::exchange(timer_fd_, -1));
+            }
+        }
     }
 
     epoll_context::~epoll_context() {
+        {
+            std::scoped_lock _{file_mtx_};
+            file_stopping_ = true;
+        }
+        file_cv_.notify_all();
+        for (auto& thread : file_threads_) thread.join();
+        // the threads left the admitted operations, and those waiting behind them, unstarted: complete them as stopped.
+        // every file with a backlog has an operation admitted, `file_running` counts them
+        detail::intrusive_list<node> abandoned{&node::next_};
+        while (const auto op = file_queue_.pop_front()) {
+            abandoned.push_back(*op);
+            const auto data = static_cast<epoll_node*>(op)->data;
+            data->file_running = 0; // a receiver closing its file must not wait on these
+            if (const auto head = data->file_backlog.release()) static_cast<void>(abandoned.append(*head));
+        }
+        file_queued_ = 0;
+        while (const auto op = abandoned.pop_front()) {
+            // armed, nobody else completes it; finished here rather than posted to a loop that no longer runs
+            op->phase_.store(detail::operation_phase::completed, std::memory_order_relaxed);
+            op->finish();
+        }
+        if (timer_fd_ != -1) ::close(timer_fd_);
         ::close(epoll_fd_);
     }
 
+    auto epoll_context::arm_timer(std::chrono::steady_clock::time_point deadline) noexcept -> bool {
+        if (timer_fd_ == -1) return false;
+        if (deadline == timer_armed_) return true;
+        // `steady_clock` is `CLOCK_MONOTONIC`
+        const auto since_epoch = deadline.time_since_epoch();
+        const auto sec = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+        const ::itimerspec spec{
+            .it_interval = {},
+            .it_value = {
+                .tv_sec = static_cast<::time_t>(sec.count()),
+                .tv_nsec = static_cast<long>(std::chrono::nanoseconds{since_epoch - sec}.count())
+            }
+        };
+        if (::timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr) == -1) [[unlikely]] return false;
+        timer_armed_ = deadline;
+        return true;
+    }
+
     auto epoll_context::do_one(bool infinite) -> bool {
         if (work_count_ == 0) return false;
 
@@ -271,13 +387,20 @@ namespace coio {
 
             if (work_count_ == 0) break;
 
-            int timeout = infinite ? -1 : 0;
-            if (infinite) {
+            // a spent drain budget with ready operations left only peeks at the events
+            const bool wait = infinite and not poll_due();
+            int timeout = wait ? -1 : 0;
+            if (wait) {
                 if (const auto earliest = timer_queue_.earliest()) {
                     const auto now = std::chrono::steady_clock::now();
-                    using int_type = std::common_type_t<int, std::chrono::milliseconds::rep>;
-                    int_type msec = std::chrono::ceil<std::chrono::milliseconds>(*earliest - now).count();
-                    timeout = static_cast<int>(std::clamp<int_type>(msec, 0, std::numeric_limits<int>::max()));
+                    if (*earliest <= now) {
+                        timeout = 0;
+                    }
+                    else if (not arm_timer(*earliest)) {
+                        using int_type = std::common_type_t<int, std::chrono::milliseconds::rep>;
+                        int_type msec = std::chrono::ceil<std::chrono::milliseconds>(*earliest - now).count();
+                        timeout = static_cast<int>(std::clamp<int_type>(msec, 0, std::numeric_limits<int>::max()));
+                    }
                 }
             }
             const int ready_count = ::epoll_wait(epoll_fd_, ready_events, detail::epoll_max_wait_count, timeout);
@@ -294,29 +417,35 @@ namespace coio {
                     interrupter_.reset();
                     continue;
                 }
+                if (data.ptr == &timer_fd_) {
+                    std::uint64_t expirations;
+                    static_cast<void>(::read(timer_fd_, &expirations, sizeof(expirations)));
+                    timer_armed_ = std::chrono::steady_clock::time_point::max(); // one-shot: disarmed now
+                    continue;
+                }
                 const auto fd_data = static_cast<per_fd_data*>(data.ptr);
-                std::scoped_lock _{fd_data->fd_lock};
-                std::array ops{
-                    std::pair{EPOLLIN, std::ref(fd_data->in_op)},
-                    std::pair{EPOLLOUT, std::ref(fd_data->out_op)}
+                std::array slots{
+                    std::pair{EPOLLIN, &fd_data->in_slot},
+                    std::pair{EPOLLOUT, &fd_data->out_slot}
                     // TODO: handle EPOLLPRI for out-of-band data
                 };
-                for (auto [ev, op_ref] : ops) {
-                    auto& op = op_ref.get();
-                    if (event & (ev | EPOLLERR | EPOLLHUP)) {
-                        if (op == nullptr) {
-                            fd_data->ready_events |= event & (ev | EPOLLERR | EPOLLHUP);
-                            continue;
-                        }
-                        if (not op->perform()) continue;
+                for (auto [ev, slot] : slots) {
+                    if ((event & (ev | EPOLLERR | EPOLLHUP)) == 0) continue;
+                    epoll_node* op = slot->claim();
+                    if (op == nullptr) continue; // recorded for the next operation
+                    if (op->perform()) {
+                        slot->release();
                         ready_io_ops.push_back(*op);
-                        op = nullptr;
+                    }
+                    else if (not slot->rearm(op, op->pinned)) {
+                        ready_io_ops.push_back(*op); // cancelled while it ran, completes as stopped
                     }
                 }
             }
 
             publish_pending(ready_time_ops.release());
             publish_pending(ready_io_ops.release());
+            polled();
 
             if (not infinite) {
                 return consume();
@@ -327,13 +456,22 @@ namespace coio {
 
     auto epoll_context::new_epoll_data() -> per_fd_data* {
         const auto data = data_pool_.acquire();
-        // serialize with straggling stale accessors before recycling the entry
+        // serialize with a straggling close of the previous owner; the reactor may still record a stale edge
+        // from an event batch fetched for it, which only costs the new owner a retried syscall
         std::scoped_lock _{data->fd_lock};
-        data->events = 0;
-        data->ready_events = 0;
-        data->in_op = nullptr;
-        data->out_op = nullptr;
+        data->events.store(0, std::memory_order_relaxed);
+        data->in_slot.reset();
+        data->out_slot.reset();
         data->next_free = nullptr;
+        data->zerocopy = 0;
+        data->zerocopy_sent = 0;
+        data->zerocopy_released = 0;
+        std::scoped_lock _file{file_mtx_};
+        data->offloaded = false;
+        data->file_queue_depth = 0;
+        data->file_running = 0;
+        data->file_draining = false;
+        data->file_backlog.clear();
         return data;
     }
 
@@ -344,17 +482,132 @@ namespace coio {
 
     auto epoll_context::cancel_op(int event, epoll_node* op) -> void {
         COIO_ASSERT(op != nullptr and op->data != nullptr);
-        std::unique_lock fd_lock{op->data->fd_lock};
-        auto& registered_op = event == EPOLLIN ? op->data->in_op : op->data->out_op;
+        auto& slot = event == EPOLLIN ? op->data->in_slot : op->data->out_slot;
         // `data` may have been recycled for another fd, in which case the slot belongs
-        // to someone else's operation: only clear it when it is still ours
-        if (registered_op == op) {
-            registered_op = nullptr;
-            fd_lock.unlock();
+        // to someone else's operation: only take it when it is still ours
+        if (slot.take(op) != nullptr) {
             op->publish();
         }
     }
 
+    auto epoll_context::submit_file_op(epoll_node& op) noexcept -> bool {
+        std::unique_lock guard{file_mtx_};
+        auto data = op.data;
+        if (data->file_running == data->file_queue_depth) {
+            data->file_backlog.push_back(op);
+            return true;
+        }
+        ++data->file_running;
+        file_queue_.push_back(op);
+        ++file_queued_;
+        // threads are started as the admitted operations outnumber the idle ones, up to the limit
+        if (file_queued_ > file_idle_ and file_threads_.size() < file_thread_limit_) {
+            try {
+                file_threads_.emplace_back([this] { run_file_thread(); });
+            }
+            catch (...) {
+                if (file_threads_.empty()) {
+                    static_cast<void>(file_queue_.erase(op));
+                    --file_queued_;
+                    --data->file_running;
+                    return false;
+                }
+                // the threads already running get to it
+            }
+        }
+        guard.unlock();
+        file_cv_.notify_one();
+        return true;
+    }
+
+    auto epoll_context::cancel_file_op(epoll_node* op) -> void {
+        COIO_ASSERT(op != nullptr and op->data != nullptr);
+        auto data = op->data;
+        {
+            std::unique_lock guard{file_mtx_};
+            if (file_queue_.erase(*op)) {
+                --file_queued_;
+                --data->file_running;
+                const bool admitted = admit_file_backlog(data);
+                guard.unlock();
+                if (admitted) file_cv_.notify_one();
+            }
+            else if (not data->file_backlog.erase(*op)) {
+                return; // a thread runs it already, or it has completed
+            }
+        }
+        op->publish();
+    }
+
+    auto epoll_context::cancel_file_ops(per_fd_data* data) -> void {
+        detail::intrusive_list<node> cancelled{&node::next_};
+        {
+            std::scoped_lock _{file_mtx_};
+            detail::intrusive_list<node> kept{&node::next_};
+            while (auto op = file_queue_.pop_front()) {
+                if (static_cast<epoll_node*>(op)->data == data) {
+                    --file_queued_;
+                    --data->file_running;
+                    cancelled.push_back(*op);
+                }
+                else {
+                    kept.push_back(*op);
+                }
+            }
+            if (auto head = kept.release()) static_cast<void>(file_queue_.append(*head));
+            if (auto head = data->file_backlog.release()) static_cast<void>(cancelled.append(*head));
+        }
+        publish_pending(cancelled.release());
+    }
+
+    auto epoll_context::set_file_queue_depth(per_fd_data* data, std::uint32_t depth) -> void {
+        std::size_t admitted = 0;
+        {
+            std::scoped_lock _{file_mtx_};
+            data->file_queue_depth = depth;
+            while (admit_file_backlog(data)) ++admitted;
+        }
+        for (; admitted > 0; --admitted) file_cv_.notify_one();
+    }
+
+    auto epoll_context::admit_file_backlog(per_fd_data* data) noexcept -> bool {
+        if (data->file_running >= data->file_queue_depth or data->file_backlog.empty()) return false;
+        file_queue_.push_back(*data->file_backlog.pop_front());
+        ++file_queued_;
+        ++data->file_running;
+        return true;
+    }
+
+    auto epoll_context::run_file_thread() noexcept -> void {
+        std::unique_lock guard{file_mtx_};
+        while (true) {
+            ++file_idle_;
+            file_cv_.wait(guard, [this] { return file_stopping_ or not file_queue_.empty(); });
+            --file_idle_;
+            if (file_stopping_) return;
+
+            const auto op = static_cast<epoll_node*>(file_queue_.pop_front());
+            --file_queued_;
+            guard.unlock();
+            // a regular file never reports would-block: `perform` runs the blocking call to completion
+            [[maybe_unused]] const bool performed = op->perform();
+            COIO_ASSERT(performed);
+            guard.lock();
+
+            // this thread picks up the operation it admits on the next round. `data` is still this file's:
+            // `close` waits for `file_running` to drain before the entry is recycled
+            const auto data = op->data;
+            --data->file_running;
+            static_cast<void>(admit_file_backlog(data));
+            const bool drained = data->file_draining and data->file_running == 0;
+            guard.unlock();
+            op->publish();
+            // `data` may be recycled as soon as `close` wakes
+            if (drained) file_drained_cv_.notify_all();
+            guard.lock();
+        }
+    }
+
     namespace detail {
         /// async_read_some
         auto epoll_state_base_for<read_some_tag>::do_start() noexcept -> start_result {
@@ -366,6 +619,7 @@ namespace coio {
                 result.set_value(0);
                 return start_result::completed;
             }
+            if (data->offloaded) return offload();
             while (true) {
                 const ::ssize_t n = ::read(fd, buffer_.data(), buffer_.size());
                 if (n == -1) {
@@ -414,6 +668,7 @@ namespace coio {
         }
 
         auto epoll_state_base_for<read_some_tag>::do_cancel() -> void {
+            if (data->offloaded) return context_.cancel_file_op(this);
             context_.cancel_op(EPOLLIN, this);
         }
 
@@ -428,6 +683,7 @@ namespace coio {
                 result.set_value(0);
                 return start_result::completed;
             }
+            if (data->offloaded) return offload();
             while (true) {
                 const ::ssize_t n = ::write(fd, buffer_.data(), buffer_.size());
                 if (n == -1) {
@@ -465,10 +721,248 @@ namespace coio {
         }
 
         auto epoll_state_base_for<write_some_tag>::do_cancel() -> void {
+            if (data->offloaded) return context_.cancel_file_op(this);
             context_.cancel_op(EPOLLOUT, this);
         }
 
 
+        /// async_read_some (scatter), async_receive (scatter)
+        auto epoll_state_base_for<read_some_vectored_tag>::do_start() noexcept -> start_result {
+            if (fd == -1) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::bad_file_descriptor));
+                return start_result::completed;
+            }
+            if (buffers_.overflowed()) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::message_size));
+                return start_result::completed;
+            }
+            if (eof_on_zero_ and buffers_.total() == 0) [[unlikely]] {
+                result.set_value(0);
+                return start_result::completed;
+            }
+            if (data->offloaded) return offload();
+            while (true) {
+                const ::ssize_t n = ::readv(fd, buffers_.data(), static_cast<int>(buffers_.count()));
+                if (n == -1) {
+                    if (is_blocking_errno(errno)) {
+                        switch (register_event(EPOLLIN)) {
+                        case register_result::armed:
+                            return start_result::pending;
+                        case register_result::ready:
+                            continue; // consume a previously skipped edge, retry the I/O
+                        case register_result::failure:
+                            result.set_error(std::error_code{errno, std::system_category()});
+                            return start_result::completed;
+                        }
+                    }
+                    result.set_error(std::error_code{errno, std::system_category()});
+                    return start_result::completed;
+                }
+                if (eof_on_zero_ and n == 0) [[unlikely]] {
+                    result.set_error(error::eof);
+                }
+                else {
+                    result.set_value(n);
+                }
+                return start_result::completed;
+            }
+        }
+
+        auto epoll_state_base_for<read_some_vectored_tag>::perform() noexcept -> bool {
+            const ::ssize_t n = ::readv(fd, buffers_.data(), static_cast<int>(buffers_.count()));
+            if (n == -1) {
+                if (is_blocking_errno(errno)) [[unlikely]] {
+                    return false;
+                }
+                result.set_error(std::error_code{errno, std::system_category()});
+            }
+            else {
+                if (eof_on_zero_ and n == 0) [[unlikely]] {
+                    result.set_error(error::eof);
+                }
+                else {
+                    result.set_value(n);
+                }
+            }
+            return true;
+        }
+
+        auto epoll_state_base_for<read_some_vectored_tag>::do_cancel() -> void {
+            if (data->offloaded) return context_.cancel_file_op(this);
+            context_.cancel_op(EPOLLIN, this);
+        }
+
+
+        /// async_write_some (gather)
+        auto epoll_state_base_for<write_some_vectored_tag>::do_start() noexcept -> start_result {
+            if (fd == -1) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::bad_file_descriptor));
+                return start_result::completed;
+            }
+            if (buffers_.total() == 0) [[unlikely]] {
+                result.set_value(0);
+                return start_result::completed;
+            }
+            if (data->offloaded) return offload();
+            while (true) {
+                const ::ssize_t n = ::writev(fd, buffers_.data(), static_cast<int>(buffers_.count()));
+                if (n == -1) {
+                    if (is_blocking_errno(errno)) {
+                        switch (register_event(EPOLLOUT)) {
+                        case register_result::armed:
+                            return start_result::pending;
+                        case register_result::ready:
+                            continue; // consume a previously skipped edge, retry the I/O
+                        case register_result::failure:
+                            result.set_error(std::error_code{errno, std::system_category()});
+                            return start_result::completed;
+                        }
+                    }
+                    result.set_error(std::error_code{errno, std::system_category()});
+                    return start_result::completed;
+                }
+                result.set_value(n);
+                return start_result::completed;
+            }
+        }
+
+        auto epoll_state_base_for<write_some_vectored_tag>::perform() noexcept -> bool {
+            const ::ssize_t n = ::writev(fd, buffers_.data(), static_cast<int>(buffers_.count()));
+            if (n == -1) {
+                if (is_blocking_errno(errno)) [[unlikely]] {
+                    return false;
+                }
+                result.set_error(std::error_code{errno, std::system_category()});
+            }
+            else {
+                result.set_value(n);
+            }
+            return true;
+        }
+
+        auto epoll_state_base_for<write_some_vectored_tag>::do_cancel() -> void {
+            if (data->offloaded) return context_.cancel_file_op(this);
+            context_.cancel_op(EPOLLOUT, this);
+        }
+
+
+        /// async_read_some_at
+        auto epoll_state_base_for<read_some_at_tag>::do_start() noexcept -> start_result {
+            if (fd == -1) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::bad_file_descriptor));
+                return start_result::completed;
+            }
+            if (buffer_.empty()) [[unlikely]] {
+                result.set_value(0);
+                return start_result::completed;
+            }
+            if (data->offloaded) return offload();
+            result.set_error(std::make_error_code(std::errc::invalid_seek)); // pipes and sockets have no offsets
+            return start_result::completed;
+        }
+
+        auto epoll_state_base_for<read_some_at_tag>::perform() noexcept -> bool {
+            const ::ssize_t n = ::pread(fd, buffer_.data(), buffer_.size(), static_cast<::off_t>(offset_));
+            if (n == -1) {
+                result.set_error(std::error_code{errno, std::system_category()});
+            }
+            else if (n == 0) {
+                result.set_error(error::eof);
+            }
+            else {
+                result.set_value(n);
+            }
+            return true;
+        }
+
+        auto epoll_state_base_for<read_some_at_tag>::do_cancel() -> void {
+            context_.cancel_file_op(this);
+        }
+
+
+        /// async_write_some_at
+        auto epoll_state_base_for<write_some_at_tag>::do_start() noexcept -> start_result {
+            if (fd == -1) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::bad_file_descriptor));
+                return start_result::completed;
+            }
+            if (buffer_.empty()) [[unlikely]] {
+                result.set_value(0);
+                return start_result::completed;
+            }
+            if (data->offloaded) return offload();
+            result.set_error(std::make_error_code(std::errc::invalid_seek));
+            return start_result::completed;
+        }
+
+        auto epoll_state_base_for<write_some_at_tag>::perform() noexcept -> bool {
+            const ::ssize_t n = ::pwrite(fd, buffer_.data(), buffer_.size(), static_cast<::off_t>(offset_));
+            if (n == -1) {
+                result.set_error(std::error_code{errno, std::system_category()});
+            }
+            else {
+                result.set_value(n);
+            }
+            return true;
+        }
+
+        auto epoll_state_base_for<write_some_at_tag>::do_cancel() -> void {
+            context_.cancel_file_op(this);
+        }
+
+
+        /// async_sync_all, async_sync_data
+        auto epoll_state_base_for<sync_tag>::do_start() noexcept -> start_result {
+            if (fd == -1) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::bad_file_descriptor));
+                return start_result::completed;
+            }
+            if (data->offloaded) return offload();
+            static_cast<void>(perform()); // nothing to wait for on pipes and sockets, it fails right away
+            return start_result::completed;
+        }
+
+        auto epoll_state_base_for<sync_tag>::perform() noexcept -> bool {
+            if ((data_only_ ? ::fdatasync(fd) : ::fsync(fd)) == -1) {
+                result.set_error(std::error_code{errno, std::system_category()});
+            }
+            else {
+                result.set_value();
+            }
+            return true;
+        }
+
+        auto epoll_state_base_for<sync_tag>::do_cancel() -> void {
+            context_.cancel_file_op(this);
+        }
+
+
+        /// async_allocate
+        auto epoll_state_base_for<allocate_tag>::do_start() noexcept -> start_result {
+            if (fd == -1) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::bad_file_descriptor));
+                return start_result::completed;
+            }
+            if (data->offloaded) return offload();
+            static_cast<void>(perform());
+            return start_result::completed;
+        }
+
+        auto epoll_state_base_for<allocate_tag>::perform() noexcept -> bool {
+            if (::fallocate(fd, mode_, static_cast<::off_t>(offset_), static_cast<::off_t>(length_)) == -1) {
+                result.set_error(std::error_code{errno, std::system_category()});
+            }
+            else {
+                result.set_value();
+            }
+            return true;
+        }
+
+        auto epoll_state_base_for<allocate_tag>::do_cancel() -> void {
+            context_.cancel_file_op(this);
+        }
+
+
         /// async_receive
         auto epoll_state_base_for<receive_tag>::do_start() noexcept -> start_result {
             if (fd == -1) [[unlikely]] {
@@ -581,6 +1075,243 @@ namespace coio {
         }
 
 
+        /// async_send (gather)
+        auto epoll_state_base_for<send_vectored_tag>::send() noexcept -> ::ssize_t {
+            ::msghdr msg{};
+            msg.msg_iov = buffers_.data();
+            msg.msg_iovlen = buffers_.count();
+            return ::sendmsg(fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        }
+
+        auto epoll_state_base_for<send_vectored_tag>::do_start() noexcept -> start_result {
+            if (fd == -1) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::bad_file_descriptor));
+                return start_result::completed;
+            }
+            if (buffers_.overflowed()) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::message_size));
+                return start_result::completed;
+            }
+            while (true) {
+                const ::ssize_t n = send();
+                if (n == -1) {
+                    if (is_blocking_errno(errno)) {
+                        switch (register_event(EPOLLOUT)) {
+                        case register_result::armed:
+                            return start_result::pending;
+                        case register_result::ready:
+                            continue; // consume a previously skipped edge, retry the I/O
+                        case register_result::failure:
+                            result.set_error(std::error_code{errno, std::system_category()});
+                            return start_result::completed;
+                        }
+                    }
+                    result.set_error(std::error_code{errno, std::system_category()});
+                    return start_result::completed;
+                }
+                result.set_value(n);
+                return start_result::completed;
+            }
+        }
+
+        auto epoll_state_base_for<send_vectored_tag>::perform() noexcept -> bool {
+            const ::ssize_t n = send();
+            if (n == -1) {
+                if (is_blocking_errno(errno)) [[unlikely]] {
+                    return false;
+                }
+                result.set_error(std::error_code{errno, std::system_category()});
+            }
+            else {
+                result.set_value(n);
+            }
+            return true;
+        }
+
+        auto epoll_state_base_for<send_vectored_tag>::do_cancel() -> void {
+            context_.cancel_op(EPOLLOUT, this);
+        }
+
+
+        /// async_sendfile
+        auto epoll_state_base_for<sendfile_tag>::send() noexcept -> ::ssize_t {
+            auto offset = static_cast<::off_t>(offset_);
+            return ::sendfile(fd, file_, &offset, std::min(count_, max_sendfile_size));
+        }
+
+        auto epoll_state_base_for<sendfile_tag>::set_result(::ssize_t n) noexcept -> void {
+            if (n == -1) {
+                result.set_error(std::error_code{errno, std::system_category()});
+            }
+            else if (n == 0) [[unlikely]] {
+                result.set_error(error::eof); // the file ends before `offset_`
+            }
+            else {
+                result.set_value(n);
+            }
+        }
+
+        auto epoll_state_base_for<sendfile_tag>::do_start() noexcept -> start_result {
+            if (fd == -1) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::bad_file_descriptor));
+                return start_result::completed;
+            }
+            if (count_ == 0) [[unlikely]] {
+                result.set_value(0);
+                return start_result::completed;
+            }
+            while (true) {
+                const ::ssize_t n = send();
+                if (n == -1 and is_blocking_errno(errno)) {
+                    switch (register_event(EPOLLOUT)) {
+                    case register_result::armed:
+                        return start_result::pending;
+                    case register_result::ready:
+                        continue; // consume a previously skipped edge, retry the I/O
+                    case register_result::failure:
+                        result.set_error(std::error_code{errno, std::system_category()});
+                        return start_result::completed;
+                    }
+                }
+                set_result(n);
+                return start_result::completed;
+            }
+        }
+
+        auto epoll_state_base_for<sendfile_tag>::perform() noexcept -> bool {
+            const ::ssize_t n = send();
+            if (n == -1 and is_blocking_errno(errno)) [[unlikely]] {
+                return false;
+            }
+            set_result(n);
+            return true;
+        }
+
+        auto epoll_state_base_for<sendfile_tag>::do_cancel() -> void {
+            context_.cancel_op(EPOLLOUT, this);
+        }
+
+
+        /// async_send_zc
+        auto epoll_state_base_for<send_zc_tag>::do_start() noexcept -> start_result {
+            if (fd == -1) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::bad_file_descriptor));
+                return start_result::completed;
+            }
+            if (buffer_.empty()) [[unlikely]] {
+                result.set_value(0);
+                return start_result::completed;
+            }
+            // once the kernel pins the buffer the operation has to wait for the notification (EPOLLERR),
+            // so get the descriptor into the interest set while giving up is still possible
+            if (not add_interest(EPOLLOUT)) [[unlikely]] {
+                result.set_error(std::error_code{errno, std::system_category()});
+                return start_result::completed;
+            }
+            while (true) {
+                if (not pinned) {
+                    const ::ssize_t n = send();
+                    if (n == -1 and not is_blocking_errno(errno)) {
+                        result.set_error(std::error_code{errno, std::system_category()});
+                        return start_result::completed;
+                    }
+                    if (n >= 0 and not pinned) { // the data was copied
+                        result.set_value(n);
+                        return start_result::completed;
+                    }
+                }
+                if (pinned and released()) {
+                    pinned = false;
+                    result.set_value(sent_);
+                    return start_result::completed;
+                }
+                // wait for room in the socket buffer, or for the notification (EPOLLERR) while pinned
+                switch (register_event(EPOLLOUT)) {
+                case register_result::armed:
+                    return start_result::pending;
+                case register_result::ready:
+                    continue; // consume a previously skipped edge, retry
+                case register_result::failure:
+                    COIO_ASSERT(not pinned && "the interest set was extended before sending");
+                    result.set_error(std::error_code{errno, std::system_category()});
+                    return start_result::completed;
+                }
+            }
+        }
+
+        auto epoll_state_base_for<send_zc_tag>::perform() noexcept -> bool {
+            if (not pinned) {
+                const ::ssize_t n = send();
+                if (n == -1) {
+                    if (is_blocking_errno(errno)) [[unlikely]] {
+                        return false;
+                    }
+                    result.set_error(std::error_code{errno, std::system_category()});
+                    return true;
+                }
+                if (not pinned) {
+                    result.set_value(n);
+                    return true;
+                }
+            }
+            if (not released()) return false;
+            pinned = false;
+            result.set_value(sent_);
+            return true;
+        }
+
+        auto epoll_state_base_for<send_zc_tag>::do_cancel() -> void {
+            context_.cancel_op(EPOLLOUT, this);
+        }
+
+        auto epoll_state_base_for<send_zc_tag>::send() noexcept -> ::ssize_t {
+            if (data->zerocopy == 0) {
+                const int enable = 1;
+                data->zerocopy = ::setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == 0 ? 1 : -1;
+            }
+            if (data->zerocopy > 0) {
+                const ::ssize_t n = ::send(fd, buffer_.data(), buffer_.size(), MSG_DONTWAIT | MSG_NOSIGNAL | MSG_ZEROCOPY);
+                if (n >= 0) {
+                    sent_ = static_cast<std::size_t>(n);
+                    id_ = data->zerocopy_sent++;
+                    pinned = true;
+                    return n;
+                }
+                // ENOBUFS: out of option memory for pinning pages, copy this time
+                if (errno != ENOBUFS) return n;
+            }
+            return ::send(fd, buffer_.data(), buffer_.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+        }
+
+        auto epoll_state_base_for<send_zc_tag>::released() noexcept -> bool {
+            // completion notifications arrive on the socket's error queue as ranges of send numbers
+            while (true) {
+                alignas(::cmsghdr) std::byte control[CMSG_SPACE(sizeof(::sock_extended_err) + sizeof(::sockaddr_in6))];
+                ::msghdr msg{};
+                msg.msg_control = control;
+                msg.msg_controllen = sizeof(control);
+                if (::recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == -1) {
+                    if (errno == EINTR) continue;
+                    break;
+                }
+                for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+                    const bool recverr = (cmsg->cmsg_level == SOL_IP and cmsg->cmsg_type == IP_RECVERR)
+                        or (cmsg->cmsg_level == SOL_IPV6 and cmsg->cmsg_type == IPV6_RECVERR);
+                    if (not recverr) continue;
+                    ::sock_extended_err err;
+                    std::memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+                    if (err.ee_errno != 0 or err.ee_origin != SO_EE_ORIGIN_ZEROCOPY) continue;
+                    // the kernel copied anyway (e.g. loopback): stop paying for the notifications
+                    if (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) data->zerocopy = -1;
+                    if (static_cast<std::int32_t>(err.ee_data + 1 - data->zerocopy_released) > 0) {
+                        data->zerocopy_released = err.ee_data + 1;
+                    }
+                }
+            }
+            return static_cast<std::int32_t>(data->zerocopy_released - id_) > 0;
+        }
+
+
         /// async_receive_from
         auto epoll_state_base_for<receive_from_tag>::do_start() noexcept -> start_result {
             if (fd == -1) [[unlikely]] {
@@ -687,6 +1418,118 @@ namespace coio {
         }
 
 
+        /// async_receive_many
+        auto epoll_state_base_for<receive_many_tag>::receive() noexcept -> int {
+            return ::recvmmsg(fd, batch_.data(), batch_.count(), MSG_DONTWAIT, nullptr);
+        }
+
+        auto epoll_state_base_for<receive_many_tag>::do_start() noexcept -> start_result {
+            if (fd == -1) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::bad_file_descriptor));
+                return start_result::completed;
+            }
+            if (batch_.count() == 0) [[unlikely]] {
+                result.set_value(0);
+                return start_result::completed;
+            }
+            while (true) {
+                const int n = receive();
+                if (n == -1) {
+                    if (is_blocking_errno(errno)) {
+                        switch (register_event(EPOLLIN)) {
+                        case register_result::armed:
+                            return start_result::pending;
+                        case register_result::ready:
+                            continue; // consume a previously skipped edge, retry the I/O
+                        case register_result::failure:
+                            result.set_error(std::error_code{errno, std::system_category()});
+                            return start_result::completed;
+                        }
+                    }
+                    result.set_error(std::error_code{errno, std::system_category()});
+                    return start_result::completed;
+                }
+                batch_.finish_receive(slots_, n);
+                result.set_value(n);
+                return start_result::completed;
+            }
+        }
+
+        auto epoll_state_base_for<receive_many_tag>::perform() noexcept -> bool {
+            const int n = receive();
+            if (n == -1) {
+                if (is_blocking_errno(errno)) [[unlikely]] {
+                    return false;
+                }
+                result.set_error(std::error_code{errno, std::system_category()});
+            }
+            else {
+                batch_.finish_receive(slots_, n);
+                result.set_value(n);
+            }
+            return true;
+        }
+
+        auto epoll_state_base_for<receive_many_tag>::do_cancel() -> void {
+            context_.cancel_op(EPOLLIN, this);
+        }
+
+
+        /// async_send_many
+        auto epoll_state_base_for<send_many_tag>::send() noexcept -> int {
+            return ::sendmmsg(fd, batch_.data(), batch_.count(), MSG_DONTWAIT | MSG_NOSIGNAL);
+        }
+
+        auto epoll_state_base_for<send_many_tag>::do_start() noexcept -> start_result {
+            if (fd == -1) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::bad_file_descriptor));
+                return start_result::completed;
+            }
+            if (batch_.count() == 0) [[unlikely]] {
+                result.set_value(0);
+                return start_result::completed;
+            }
+            while (true) {
+                const int n = send();
+                if (n == -1) {
+                    if (is_blocking_errno(errno)) {
+                        switch (register_event(EPOLLOUT)) {
+                        case register_result::armed:
+                            return start_result::pending;
+                        case register_result::ready:
+                            continue; // consume a previously skipped edge, retry the I/O
+                        case register_result::failure:
+                            result.set_error(std::error_code{errno, std::system_category()});
+                            return start_result::completed;
+                        }
+                    }
+                    result.set_error(std::error_code{errno, std::system_category()});
+                    return start_result::completed;
+                }
+                result.set_value(n);
+                return start_result::completed;
+            }
+        }
+
+        auto epoll_state_base_for<send_many_tag>::perform() noexcept -> bool {
+            const int n = send();
+            if (n == -1) {
+                if (is_blocking_errno(errno)) [[unlikely]] {
+                    return false;
+                }
+                result.set_error(std::error_code{errno, std::system_category()});
+            }
+            else {
+                result.set_value(n);
+            }
+            return true;
+        }
+
+        auto epoll_state_base_for<send_many_tag>::do_cancel() -> void {
+            context_.cancel_op(EPOLLOUT, this);
+        }
+
+
         /// async_accept
         auto epoll_state_base_for<accept_tag>::do_start() noexcept -> start_result {
             if (fd == -1) [[unlikely]] {
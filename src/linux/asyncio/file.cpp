@@ -1,43 +1,46 @@
 // NOLINTBEGIN(*-narrowing-conversions)
+#include <algorithm>
+#include <bit>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <coio/asyncio/file.h>
 #include "../common.h"
 
 namespace coio::detail {
-    namespace {
-        COIO_ALWAYS_INLINE auto to_native_openmode(open_mode mode) noexcept -> int {
-            int result = 0;
-            if (bool(mode & open_mode::read_only)) {
-                result |= O_RDONLY;
-            }
-            if (bool(mode & open_mode::write_only)) {
-                result |= O_WRONLY;
-            }
-            if (bool(mode & open_mode::read_write)) {
-                result |= O_RDWR;
-            }
-            if (bool(mode & open_mode::append)) {
-                result |= O_APPEND;
-            }
-            if (bool(mode & open_mode::create)) {
-                result |= O_CREAT;
-            }
-            if (bool(mode & open_mode::exclusive)) {
-                result |= O_EXCL;
-            }
-            if (bool(mode & open_mode::truncate)) {
-                result |= O_TRUNC;
-            }
-            if (bool(mode & open_mode::sync_all_on_write)) {
-                result |= O_SYNC;
-            }
-            return result;
+    auto native_open_flags(open_mode mode) noexcept -> int {
+        int result = 0;
+        if (bool(mode & open_mode::read_only)) {
+            result |= O_RDONLY;
+        }
+        if (bool(mode & open_mode::write_only)) {
+            result |= O_WRONLY;
+        }
+        if (bool(mode & open_mode::read_write)) {
+            result |= O_RDWR;
+        }
+        if (bool(mode & open_mode::append)) {
+            result |= O_APPEND;
         }
+        if (bool(mode & open_mode::create)) {
+            result |= O_CREAT;
+        }
+        if (bool(mode & open_mode::exclusive)) {
+            result |= O_EXCL;
+        }
+        if (bool(mode & open_mode::truncate)) {
+            result |= O_TRUNC;
+        }
+        if (bool(mode & open_mode::sync_all_on_write)) {
+            result |= O_SYNC;
+        }
+        if (bool(mode & open_mode::direct)) {
+            result |= O_DIRECT;
+        }
+        return result;
     }
 
     auto open_file(zstring_view path, open_mode mode, bool random_access) -> file_native_handle_type {
-        const auto fd = ::open(path.c_str(), to_native_openmode(mode), 0777);
+        const auto fd = ::open(path.c_str(), native_open_flags(mode), 0777);
         throw_last_error(fd, "open");
         if (random_access) ::posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
         return fd;
@@ -130,6 +133,19 @@ namespace coio::detail {
         return st.st_size;
     }
 
+    auto file_direct_io_alignment(file_native_handle_type handle) -> std::size_t {
+#ifdef STATX_DIOALIGN
+        struct ::statx stx{}; // NOLINT(cppcoreguidelines-pro-type-member-init)
+        if (::statx(handle, "", AT_EMPTY_PATH, STATX_DIOALIGN, &stx) == 0 and (stx.stx_mask & STATX_DIOALIGN) != 0 and stx.stx_dio_offset_align != 0) {
+            return std::max<std::size_t>(stx.stx_dio_mem_align, stx.stx_dio_offset_align);
+        }
+#endif
+        // kernels before 6.1 don't report it: the preferred I/O size is a multiple of the logical block size
+        struct ::stat st; // NOLINT(cppcoreguidelines-pro-type-member-init)
+        throw_last_error(::fstat(handle, &st), "direct_io_alignment");
+        return std::bit_ceil(std::max<std::size_t>(st.st_blksize, 512));
+    }
+
     auto file_resize(file_native_handle_type handle, std::size_t new_size) -> void {
         if (new_size > std::numeric_limits<::off_t>::max()) [[unlikely]] {
             throw std::system_error{std::make_error_code(std::errc::value_too_large), "resize"};
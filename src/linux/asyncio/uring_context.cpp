@@ -1,6 +1,12 @@
 #include <coio/detail/config.h>
 #if COIO_HAS_IO_URING
+#include <algorithm>
+#include <bit>
 #include <limits>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <coio/asyncio/file.h>
 #include <coio/asyncio/uring_context.h>
 #include <coio/utils/scope_exit.h>
 #include <coio/detail/suppress_push.h> // IWYU pragma: keep
@@ -8,15 +14,44 @@
 
 namespace coio {
     namespace {
-        constexpr std::size_t default_uring_entries = 4096;
-
         constexpr std::size_t submit_batch_size = 32;
 
-        auto init_uring(::io_uring& uring, std::size_t entries) -> void {
-            if (entries > std::numeric_limits<unsigned>::max()) {
+        constexpr std::uint16_t provided_buffer_group = 0;
+
+        constexpr std::size_t max_provided_buffers = 32768;
+
+        constexpr std::size_t max_queued_completions = 64;
+
+        constexpr std::chrono::milliseconds overflow_retry_interval{1};
+
+        constexpr std::size_t max_idle_splice_pipes = 16;
+
+        constexpr int splice_pipe_size = 1 << 20; // fewer round trips per `async_sendfile`, if the pipe size limit allows
+
+        /// \return the last opcode the kernel supports
+        auto init_uring(::io_uring& uring, const uring_context::options& opts) -> std::uint8_t {
+            constexpr auto max_entries = std::numeric_limits<unsigned>::max();
+            if (opts.entries > max_entries or opts.cq_entries > max_entries
+                or opts.sq_poll_idle.count() < 0 or opts.sq_poll_idle.count() > max_entries) {
                 throw std::system_error{std::make_error_code(std::errc::value_too_large)};
             }
-            if (const auto ec = ::io_uring_queue_init(entries, &uring, 0u); ec < 0) {
+            ::io_uring_params params{};
+            if (opts.cq_entries > 0) {
+                params.flags |= IORING_SETUP_CQSIZE;
+                params.cq_entries = static_cast<unsigned>(opts.cq_entries);
+            }
+            if (opts.sq_poll) {
+                params.flags |= IORING_SETUP_SQPOLL;
+                params.sq_thread_idle = static_cast<unsigned>(opts.sq_poll_idle.count());
+                if (opts.sq_poll_cpu) {
+                    params.flags |= IORING_SETUP_SQ_AFF;
+                    params.sq_thread_cpu = *opts.sq_poll_cpu;
+                }
+            }
+            if (opts.single_issuer or opts.defer_taskrun) params.flags |= IORING_SETUP_SINGLE_ISSUER;
+            if (opts.defer_taskrun) params.flags |= IORING_SETUP_DEFER_TASKRUN;
+            if (opts.coop_taskrun) params.flags |= IORING_SETUP_COOP_TASKRUN;
+            if (const auto ec = ::io_uring_queue_init_params(static_cast<unsigned>(opts.entries), &uring, &params); ec < 0) {
                 throw std::system_error{-ec, std::system_category()};
             }
             // IORING_OP_SOCKET (opcode 45) shipped in Linux 5.19 together with
@@ -30,26 +65,195 @@ namespace coio {
                     "coio::uring_context requires Linux kernel 5.19 or newer"
                 };
             }
-        }
-
-        [[noreturn]]
-        auto sqe_exhuasted() -> void {
-            // TODO: more proper handle
-            std::terminate();
+            return probe.last_op;
         }
     }
 
     auto uring_context::uring_node::do_cancel() -> void {
+        if (context_.foreign_issuer()) {
+            // the kernel rejects submissions from any other thread: let the issuer thread submit it
+            {
+                std::scoped_lock _{context_.remote_mtx_};
+                if (std::exchange(remote_cancel_, true)) return;
+                context_.remote_cancels_.push_back(*this);
+            }
+            context_.interrupt();
+            return;
+        }
         std::scoped_lock _{context_.uring_mtx_};
+        if (overflow_ == overflow_state::start) {
+            // never reached the kernel: `do_one` completes it as cancelled
+            overflow_ = overflow_state::cancelled;
+            return;
+        }
+        if (overflow_ != overflow_state::none) return; // already asked for
         auto sqe = context_.allocate_sqe();
         if (sqe == nullptr) [[unlikely]] {
-            sqe_exhuasted();
+            context_.defer(*this, overflow_state::cancel);
+            return;
         }
         ::io_uring_prep_cancel(sqe, this, 0);
         ::io_uring_sqe_set_data(sqe, nullptr);
         context_.submit_sqes();
     }
 
+    auto uring_context::uring_node::withdraw() noexcept -> void {
+        // only a deferred cancellation can still be queued here, and `do_cancel` has returned by now
+        if (remote_cancel_) {
+            std::scoped_lock _{context_.remote_mtx_};
+            remote_cancel_ = false;
+            context_.remote_cancels_.erase(*this);
+        }
+        if (overflow_ == overflow_state::none) return;
+        std::scoped_lock _{context_.uring_mtx_};
+        if (overflow_ != overflow_state::none) context_.unlink(*this);
+    }
+
+    uring_context::multishot_node::multishot_node(uring_context& context, int fd, int file_index, std::uint8_t opcode) :
+        uring_node(context, fd),
+        backlog_(context.get_allocator()),
+        opcode_(opcode) {
+        this->file_index = file_index;
+        multishot = true;
+    }
+
+    auto uring_context::multishot_node::attach(uring_node& waiter) noexcept -> detail::start_result {
+        std::scoped_lock _{mtx_};
+        COIO_ASSERT(waiter_ == nullptr);
+        if (not backlog_.empty()) {
+            const auto [res, flags] = backlog_.front();
+            backlog_.pop_front();
+            waiter.complete(res, flags);
+            return detail::start_result::completed;
+        }
+        if (not armed_ and not starved_) arm();
+        waiter_ = &waiter;
+        return detail::start_result::pending;
+    }
+
+    auto uring_context::multishot_node::detach(uring_node& waiter) noexcept -> bool {
+        std::scoped_lock _{mtx_};
+        if (waiter_ != &waiter) return false;
+        waiter_ = nullptr;
+        return true;
+    }
+
+    auto uring_context::multishot_node::orphan() noexcept -> void {
+        {
+            std::scoped_lock _{mtx_};
+            COIO_ASSERT(waiter_ == nullptr);
+            orphaned_ = true;
+            // leave the parked list before recycling anything, or a returned buffer could pick the node up again
+            const bool replenishing = starved_ and not context_.unstarve(*this);
+            for (const auto c : backlog_) discard(c);
+            backlog_.clear();
+            if (armed_) {
+                throttle(); // the final completion disposes of the node
+                return;
+            }
+            if (replenishing) return; // `replenish` disposes of the node
+        }
+        delete_object(context_.allocator_, this);
+    }
+
+    auto uring_context::multishot_node::complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void {
+        auto& context = context_;
+        const bool more = cqe_flags & IORING_CQE_F_MORE;
+        uring_node* ready = nullptr;
+        bool dispose = false;
+        {
+            std::scoped_lock _{mtx_};
+            const bool was_throttled = not more and std::exchange(throttled_, false);
+            if (not more) {
+                armed_ = false;
+                withdraw(); // a cancellation still waiting for room in the ring has nothing left to cancel
+            }
+
+            if (orphaned_) {
+                discard({cqe_res, cqe_flags});
+                dispose = not more;
+            }
+            else if (cqe_res == -ECANCELED and (was_throttled or waiter_ == nullptr)) {
+                // our own backpressure, or a cancellation nobody is waiting to observe
+            }
+            else if (cqe_res == -ENOBUFS and not more and opcode_ != IORING_OP_ACCEPT) {
+                // the buffer ring ran dry, which lasts only until a lease is released
+                starved_ = context.starve(*this);
+            }
+            else if (waiter_) {
+                waiter_->complete(cqe_res, cqe_flags);
+                ready = std::exchange(waiter_, nullptr);
+            }
+            else {
+                backlog_.push_back({cqe_res, cqe_flags});
+                // nobody is consuming: stop the kernel from filling the queue without bound
+                if (more and backlog_.size() >= max_queued_completions) throttle();
+            }
+
+            if (not more and waiter_ and not starved_) arm();
+        }
+
+        if (ready) ready->publish();
+        if (dispose) delete_object(context.allocator_, this);
+        if (not more) context.work_finished();
+    }
+
+    auto uring_context::multishot_node::prepare_request(::io_uring_sqe* sqe) noexcept -> void {
+        if (opcode_ == IORING_OP_ACCEPT) {
+            ::io_uring_prep_multishot_accept(sqe, fd, nullptr, nullptr, 0);
+        }
+        else {
+            ::io_uring_prep_recv_multishot(sqe, fd, nullptr, 0, 0);
+            sqe->flags |= IOSQE_BUFFER_SELECT;
+            sqe->buf_group = provided_buffer_group;
+        }
+    }
+
+    auto uring_context::multishot_node::arm() noexcept -> void { // pre: mtx_ is locked
+        if (opcode_ != IORING_OP_ACCEPT) {
+            std::scoped_lock _{context_.buf_ring_mtx_};
+            recycled_ = context_.buffers_recycled_;
+        }
+        std::scoped_lock _{context_.uring_mtx_};
+        context_.work_started();
+        armed_ = true;
+        auto sqe = context_.allocate_sqe();
+        if (sqe == nullptr) [[unlikely]] {
+            context_.defer(*this, overflow_state::start);
+            return;
+        }
+        prepare_request(sqe);
+        use_fixed_file(sqe);
+        ::io_uring_sqe_set_data(sqe, static_cast<uring_node*>(this));
+        COIO_TSAN_RELEASE(static_cast<uring_node*>(this));
+        context_.post_submit_sqes();
+    }
+
+    auto uring_context::multishot_node::throttle() noexcept -> void { // pre: mtx_ is locked
+        if (not std::exchange(throttled_, true)) do_cancel();
+    }
+
+    auto uring_context::multishot_node::replenish() noexcept -> void {
+        {
+            std::scoped_lock _{mtx_};
+            starved_ = false;
+            if (not orphaned_) {
+                if (waiter_ and not armed_) arm();
+                return;
+            }
+        }
+        delete_object(context_.allocator_, this);
+    }
+
+    auto uring_context::multishot_node::discard(completion c) noexcept -> void {
+        if (opcode_ == IORING_OP_ACCEPT) {
+            if (c.res >= 0) ::close(c.res);
+        }
+        else if (c.flags & IORING_CQE_F_BUFFER) {
+            context_.recycle_buffer(static_cast<std::uint16_t>(c.flags >> IORING_CQE_BUFFER_SHIFT));
+        }
+    }
+
     uring_context::scheduler::io_object::io_object(uring_context& ctx, int fd) : ctx_(&ctx), fd_(fd), stream_oriented_(detail::is_stream_oriented_(fd)) {}
 
     uring_context::scheduler::io_object::~io_object() {
@@ -58,21 +262,100 @@ namespace coio {
 
     auto uring_context::scheduler::io_object::close() -> void {
         if (fd_ == -1) return;
-        detail::throw_last_error(::close(std::exchange(fd_, -1)), "close");
+        detail::throw_last_error(::close(release()), "close");
+    }
+
+    auto uring_context::scheduler::io_object::release() noexcept -> int {
+        if (fd_ == -1) return -1;
+        {
+            // the descriptor may be reused right away, don't let a stale cancellation hit its next owner
+            std::scoped_lock _{ctx_->uring_mtx_};
+            std::erase(ctx_->deferred_fd_cancels_, fd_);
+        }
+        if (ctx_->uring_mtx_.single_issuer) {
+            std::scoped_lock _{ctx_->remote_mtx_};
+            std::erase(ctx_->remote_fd_cancels_, fd_);
+        }
+        if (file_index_ != -1) {
+            const int slot = std::exchange(file_index_, -1);
+            int removed = -1;
+            std::scoped_lock _{ctx_->files_mtx_};
+            // in-flight operations hold their own reference to the file, so the slot can be reused at once.
+            // Should clearing it fail, the slot still names this file: it is never handed out again
+            if (::io_uring_register_files_update(&ctx_->uring_, static_cast<unsigned>(slot), &removed, 1) == 1) {
+                ctx_->free_file_slots_.push_back(slot);
+            }
+        }
+        return std::exchange(fd_, -1);
+    }
+
+    auto uring_context::scheduler::io_object::register_file() -> void {
+        if (fd_ == -1) {
+            throw std::system_error{std::make_error_code(std::errc::bad_file_descriptor), "register_file"};
+        }
+        if (file_index_ != -1) return;
+        std::scoped_lock _{ctx_->files_mtx_};
+        if (not ctx_->file_table_registered_) {
+            throw std::system_error{std::make_error_code(std::errc::operation_not_supported), "register_file"};
+        }
+        if (ctx_->free_file_slots_.empty()) {
+            throw std::system_error{std::make_error_code(std::errc::too_many_files_open), "register_file"};
+        }
+        const int slot = ctx_->free_file_slots_.back();
+        if (const int ec = ::io_uring_register_files_update(&ctx_->uring_, static_cast<unsigned>(slot), &fd_, 1); ec < 0) {
+            throw std::system_error{-ec, std::system_category(), "io_uring_register_files_update"};
+        }
+        ctx_->free_file_slots_.pop_back();
+        file_index_ = slot;
     }
 
     auto uring_context::scheduler::io_object::cancel() -> void {
         if (fd_ == -1) return;
+        if (ctx_->foreign_issuer()) {
+            {
+                std::scoped_lock _{ctx_->remote_mtx_};
+                if (std::ranges::find(ctx_->remote_fd_cancels_, fd_) == ctx_->remote_fd_cancels_.end()) {
+                    ctx_->remote_fd_cancels_.push_back(fd_);
+                }
+            }
+            ctx_->interrupt();
+            return;
+        }
         std::scoped_lock _{ctx_->uring_mtx_};
         auto sqe = ctx_->allocate_sqe();
         if (sqe == nullptr) [[unlikely]] {
-            sqe_exhuasted();
+            if (std::ranges::find(ctx_->deferred_fd_cancels_, fd_) == ctx_->deferred_fd_cancels_.end()) {
+                ctx_->deferred_fd_cancels_.push_back(fd_);
+            }
+            return;
         }
         ::io_uring_prep_cancel_fd(sqe, fd_, IORING_ASYNC_CANCEL_ALL);
         ::io_uring_sqe_set_data(sqe, nullptr);
         ctx_->submit_sqes();
     }
 
+    auto uring_context::scheduler::io_object::make_accept_stream() -> accept_stream {
+        if (fd_ == -1) {
+            throw std::system_error{std::make_error_code(std::errc::bad_file_descriptor), "make_accept_stream"};
+        }
+        return accept_stream{*ctx_, fd_, new_object<multishot_node>(ctx_->allocator_, *ctx_, fd_, file_index_, std::uint8_t{IORING_OP_ACCEPT})};
+    }
+
+    auto uring_context::scheduler::io_object::make_receive_stream() -> receive_stream {
+        if (fd_ == -1) {
+            throw std::system_error{std::make_error_code(std::errc::bad_file_descriptor), "make_receive_stream"};
+        }
+        if (ctx_->buf_ring_ == nullptr) {
+            throw std::system_error{std::make_error_code(std::errc::operation_not_supported), "make_receive_stream"};
+        }
+        return receive_stream{
+            *ctx_,
+            fd_,
+            new_object<multishot_node>(ctx_->allocator_, *ctx_, fd_, file_index_, std::uint8_t{IORING_OP_RECV}),
+            stream_oriented_
+        };
+    }
+
     auto uring_context::scheduler::io_object::receive(std::span<std::byte> buffer) -> std::size_t {
         return detail::socket::receive(fd_, buffer, stream_oriented_);
     }
@@ -129,16 +412,73 @@ namespace coio {
         throw;
     }
 
-    uring_context::uring_context(std::size_t entries, std::pmr::memory_resource& memory_resource) : loop_base(memory_resource) {
-        init_uring(uring_, entries);
+    uring_context::uring_context(std::size_t entries, std::pmr::memory_resource& memory_resource) :
+        uring_context(options{.entries = entries}, memory_resource) {}
+
+    uring_context::uring_context(const options& opts, std::pmr::memory_resource& memory_resource) :
+        loop_base(memory_resource),
+        deferred_fd_cancels_(&memory_resource),
+        remote_fd_cancels_(&memory_resource),
+        free_file_slots_(&memory_resource),
+        registered_buffers_(&memory_resource),
+        splice_pipes_(&memory_resource) {
+        splice_pipes_.reserve(max_idle_splice_pipes);
+        send_zc_supported_ = init_uring(uring_, opts) >= ::IORING_OP_SEND_ZC;
+        if (not opts.single_issuer and not opts.defer_taskrun) return;
+
+        // only the owning thread may submit, so other threads can't wake it with a nop
+        uring_mtx_.single_issuer = true;
+        issuer_id_ = std::this_thread::get_id();
+        wakeup_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (wakeup_fd_ == -1 or not arm_wakeup()) [[unlikely]] {
+            const auto ec = wakeup_fd_ == -1 ? errno : ENOBUFS;
+            if (wakeup_fd_ != -1) ::close(wakeup_fd_);
+            ::io_uring_queue_exit(&uring_);
+            throw std::system_error{ec, std::system_category(), "uring_context"};
+        }
     }
 
-    uring_context::uring_context() : uring_context(default_uring_entries) {}
+    uring_context::uring_context() : uring_context(options{}) {}
 
     uring_context::~uring_context() {
+        if (wakeup_fd_ != -1) ::close(wakeup_fd_);
+        for (const auto& pipe : splice_pipes_) {
+            ::close(pipe.read_end);
+            ::close(pipe.write_end);
+        }
+        if (buf_ring_) {
+            ::io_uring_free_buf_ring(&uring_, buf_ring_, buf_ring_entries_, provided_buffer_group);
+            allocator_.deallocate_bytes(buf_ring_storage_, buf_ring_buffer_size_ * buf_ring_entries_, alignof(std::max_align_t));
+        }
         ::io_uring_queue_exit(&uring_);
     }
 
+    auto uring_context::register_buffer_ring(std::size_t buffer_size, std::size_t buffer_count) -> void {
+        if (buf_ring_) {
+            throw std::system_error{std::make_error_code(std::errc::device_or_resource_busy), "register_buffer_ring"};
+        }
+        if (buffer_size == 0 or buffer_size > std::numeric_limits<unsigned>::max()
+            or buffer_count == 0 or buffer_count > max_provided_buffers or not std::has_single_bit(buffer_count)) {
+            throw std::system_error{std::make_error_code(std::errc::invalid_argument), "register_buffer_ring"};
+        }
+        const auto storage = static_cast<std::byte*>(allocator_.allocate_bytes(buffer_size * buffer_count, alignof(std::max_align_t)));
+        int ec = 0;
+        const auto ring = ::io_uring_setup_buf_ring(&uring_, static_cast<unsigned>(buffer_count), provided_buffer_group, 0u, &ec);
+        if (ring == nullptr) {
+            allocator_.deallocate_bytes(storage, buffer_size * buffer_count, alignof(std::max_align_t));
+            throw std::system_error{-ec, std::system_category(), "io_uring_setup_buf_ring"};
+        }
+        const int mask = ::io_uring_buf_ring_mask(buffer_count);
+        for (std::size_t i = 0; i < buffer_count; ++i) {
+            ::io_uring_buf_ring_add(ring, storage + i * buffer_size, static_cast<unsigned>(buffer_size), static_cast<unsigned short>(i), mask, static_cast<int>(i));
+        }
+        ::io_uring_buf_ring_advance(ring, static_cast<int>(buffer_count));
+        buf_ring_ = ring;
+        buf_ring_storage_ = storage;
+        buf_ring_buffer_size_ = buffer_size;
+        buf_ring_entries_ = static_cast<std::uint16_t>(buffer_count);
+    }
+
     auto uring_context::do_one(bool infinite) -> bool {
         if (work_count_ == 0) return false;
 
@@ -154,24 +494,55 @@ namespace coio {
 
             if (work_count_ == 0) break;
 
+            detail::intrusive_list<node> ready_io_ops{&node::next_};
+            auto dispatch = [&](void* user_data, int res, std::uint32_t flags) noexcept {
+                if (not user_data or user_data == this) return;
+                if (user_data == &wakeup_fd_) {
+                    drain_wakeup();
+                    if (not (flags & IORING_CQE_F_MORE)) {
+                        wakeup_armed_ = false;
+                        arm_wakeup();
+                    }
+                    return;
+                }
+                auto op = static_cast<uring_node*>(user_data);
+                COIO_TSAN_ACQUIRE(op);
+                const bool multishot = op->multishot; // a multishot node may be gone after `complete`
+                op->complete(res, flags);
+                if (not multishot) ready_io_ops.push_back(*op);
+            };
+
+            take_remote_requests();
             uring_mtx_.lock();
             submit_sqes(); // nothrow
+            auto cancelled = drain_overflow();
+            if (wakeup_fd_ != -1 and not wakeup_armed_) arm_wakeup();
+            const bool backlogged = overflow_head_ != nullptr or not deferred_fd_cancels_.empty()
+                or (wakeup_fd_ != -1 and not wakeup_armed_);
             uring_mtx_.unlock();
-
-            detail::intrusive_list<node> ready_io_ops{&node::next_};
+            while (cancelled) {
+                dispatch(std::exchange(cancelled, cancelled->overflow_next_), -ECANCELED, 0);
+            }
             ::io_uring_cqe* cqe = nullptr;
             scope_exit cqe_guard{[&] {
                 ::io_uring_cqe_seen(&uring_, cqe);
             }};
             int ec = 0;
-            if (infinite) {
-                using microseconds = std::chrono::duration<std::int64_t, std::micro>;
-                if (const auto earliest = timer_queue_.earliest()) {
-                    const auto now = std::chrono::steady_clock::now();
-                    const auto usec = std::max(std::chrono::ceil<microseconds>(*earliest - now).count(), {});
+            // a spent drain budget with ready operations left only peeks at the completions
+            if (infinite and not poll_due()) {
+                using nanoseconds = std::chrono::duration<std::int64_t, std::nano>;
+                const auto now = std::chrono::steady_clock::now();
+                auto earliest = timer_queue_.earliest();
+                if (backlogged and (not earliest or *earliest > now + overflow_retry_interval)) {
+                    // the ring was full, come back soon to retry what didn't fit
+                    earliest = now + overflow_retry_interval;
+                }
+                if (earliest) {
+                    // submitted as an `IORING_OP_TIMEOUT` (or passed along with the wait): nanosecond precision
+                    const auto nsec = std::max(std::chrono::ceil<nanoseconds>(*earliest - now).count(), {});
                     ::__kernel_timespec timeout{
-                        .tv_sec = usec / 1000'000,
-                        .tv_nsec = (usec % 1000'000) * 1'000
+                        .tv_sec = nsec / 1000'000'000,
+                        .tv_nsec = nsec % 1000'000'000
                     };
                     ec = -::io_uring_wait_cqe_timeout(&uring_, &cqe, &timeout);
                 }
@@ -191,14 +562,7 @@ namespace coio {
             }
             if (ec > 0) throw std::system_error{ec, std::system_category()};
 
-            if (cqe) {
-                if (auto user_data = ::io_uring_cqe_get_data(cqe); user_data and user_data != this) {
-                    auto op = static_cast<uring_node*>(user_data);
-                    COIO_TSAN_ACQUIRE(op);
-                    op->complete(cqe->res);
-                    ready_io_ops.push_back(*op);
-                }
-            }
+            if (cqe) dispatch(::io_uring_cqe_get_data(cqe), cqe->res, cqe->flags);
             cqe_guard.reset();
 
             detail::intrusive_list<node> ready_time_ops{&node::next_};
@@ -212,12 +576,7 @@ namespace coio {
                     ::io_uring_cq_advance(&uring_, n);
                 }};
                 for (auto peeked_cqe : std::span(peeked_cqes, n)) {
-                    if (auto user_data = ::io_uring_cqe_get_data(peeked_cqe); user_data and user_data != this) {
-                        auto op = static_cast<uring_node*>(user_data);
-                        COIO_TSAN_ACQUIRE(op);
-                        op->complete(peeked_cqe->res);
-                        ready_io_ops.push_back(*op);
-                    }
+                    dispatch(::io_uring_cqe_get_data(peeked_cqe), peeked_cqe->res, peeked_cqe->flags);
                 }
             }
 
@@ -225,6 +584,7 @@ namespace coio {
 
             publish_pending(ready_time_ops.release());
             publish_pending(ready_io_ops.release());
+            polled();
 
             if (not infinite) {
                 return consume();
@@ -237,6 +597,8 @@ namespace coio {
         ::io_uring_sqe* sqe = ::io_uring_get_sqe(&uring_);
         for (std::size_t retry = 3u; sqe == nullptr and retry-- > 0;) {
             submit_sqes();
+            // the submission queue polling thread frees entries on its own, wait for it
+            if (uring_.flags & IORING_SETUP_SQPOLL) ::io_uring_sqring_wait(&uring_);
             sqe = ::io_uring_get_sqe(&uring_);
         }
         if (sqe) ++pending_sqes_;
@@ -246,11 +608,66 @@ namespace coio {
     auto uring_context::submit_sqes() noexcept -> void { // pre: uring_mtx_ is locked
         if (pending_sqes_ == 0) return;
         const int n = ::io_uring_submit(&uring_);
+        // the kernel refuses new work while completions overflow the CQ; retry after reaping them
+        if (n == -EBUSY or n == -EAGAIN) [[unlikely]] return;
         if (n < 0) [[unlikely]] std::terminate();
         COIO_ASSERT(pending_sqes_ >= std::size_t(n)); // NOLINT(*-use-integer-sign-comparison)
         pending_sqes_ -= n;
     }
 
+    auto uring_context::defer(uring_node& op, overflow_state state) noexcept -> void { // pre: uring_mtx_ is locked
+        COIO_ASSERT(op.overflow_ == overflow_state::none);
+        op.overflow_ = state;
+        op.overflow_prev_ = overflow_tail_;
+        op.overflow_next_ = nullptr;
+        (overflow_tail_ ? overflow_tail_->overflow_next_ : overflow_head_) = &op;
+        overflow_tail_ = &op;
+    }
+
+    auto uring_context::unlink(uring_node& op) noexcept -> void { // pre: uring_mtx_ is locked
+        (op.overflow_prev_ ? op.overflow_prev_->overflow_next_ : overflow_head_) = op.overflow_next_;
+        (op.overflow_next_ ? op.overflow_next_->overflow_prev_ : overflow_tail_) = op.overflow_prev_;
+        op.overflow_prev_ = nullptr;
+        op.overflow_next_ = nullptr;
+        op.overflow_ = overflow_state::none;
+    }
+
+    auto uring_context::drain_overflow() noexcept -> uring_node* { // pre: uring_mtx_ is locked
+        uring_node* cancelled = nullptr; // linked through `overflow_next_`, completed by the caller
+        for (auto op = overflow_head_; op != nullptr;) {
+            const auto next = op->overflow_next_;
+            if (op->overflow_ == overflow_state::cancelled) {
+                unlink(*op);
+                op->overflow_next_ = std::exchange(cancelled, op);
+                op = next;
+                continue;
+            }
+            auto sqe = allocate_sqe();
+            if (sqe == nullptr) break;
+            if (op->overflow_ == overflow_state::start) {
+                op->prepare_request(sqe);
+                op->use_fixed_file(sqe);
+                ::io_uring_sqe_set_data(sqe, op);
+                COIO_TSAN_RELEASE(op);
+            }
+            else {
+                ::io_uring_prep_cancel(sqe, op, 0);
+                ::io_uring_sqe_set_data(sqe, nullptr);
+            }
+            unlink(*op);
+            op = next;
+        }
+        while (not deferred_fd_cancels_.empty()) {
+            auto sqe = allocate_sqe();
+            if (sqe == nullptr) break;
+            ::io_uring_prep_cancel_fd(sqe, deferred_fd_cancels_.back(), IORING_ASYNC_CANCEL_ALL);
+            ::io_uring_sqe_set_data(sqe, nullptr);
+            deferred_fd_cancels_.pop_back();
+        }
+        submit_sqes();
+        return cancelled;
+    }
+
     auto uring_context::post_submit_sqes() noexcept -> void { // pre: uring_mtx_ is locked
         if (not pulling_cqes_.load(std::memory_order_acquire)) {
             if (pending_sqes_ < submit_batch_size) return;
@@ -261,11 +678,189 @@ namespace coio {
         }
     }
 
+    auto uring_context::register_file_table(std::size_t size) -> void {
+        std::scoped_lock _{files_mtx_};
+        if (file_table_registered_) {
+            throw std::system_error{std::make_error_code(std::errc::device_or_resource_busy), "register_file_table"};
+        }
+        if (size == 0 or size > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+            throw std::system_error{std::make_error_code(std::errc::invalid_argument), "register_file_table"};
+        }
+        free_file_slots_.reserve(size);
+        if (const int ec = ::io_uring_register_files_sparse(&uring_, static_cast<unsigned>(size)); ec < 0) {
+            throw std::system_error{-ec, std::system_category(), "io_uring_register_files_sparse"};
+        }
+        // hand out low slots first
+        for (std::size_t slot = size; slot-- > 0;) {
+            free_file_slots_.push_back(static_cast<int>(slot));
+        }
+        file_table_registered_ = true;
+    }
+
+    auto uring_context::register_buffers(std::span<const std::span<std::byte>> buffers) -> void {
+        std::scoped_lock _{files_mtx_};
+        if (buffers_registered_.load(std::memory_order_relaxed)) {
+            throw std::system_error{std::make_error_code(std::errc::device_or_resource_busy), "register_buffers"};
+        }
+        if (buffers.empty() or buffers.size() > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+            throw std::system_error{std::make_error_code(std::errc::invalid_argument), "register_buffers"};
+        }
+        std::pmr::vector<::iovec> iovecs(allocator_);
+        iovecs.reserve(buffers.size());
+        std::pmr::vector<registered_buffer> table(allocator_);
+        table.reserve(buffers.size());
+        for (const auto& buffer : buffers) {
+            iovecs.push_back({.iov_base = buffer.data(), .iov_len = buffer.size()});
+            table.push_back({buffer.data(), buffer.data() + buffer.size(), static_cast<int>(table.size())});
+        }
+        if (const int ec = ::io_uring_register_buffers(&uring_, iovecs.data(), static_cast<unsigned>(iovecs.size())); ec < 0) {
+            throw std::system_error{-ec, std::system_category(), "io_uring_register_buffers"};
+        }
+        std::ranges::sort(table, {}, &registered_buffer::begin);
+        registered_buffers_ = std::move(table);
+        // the table never changes again, so readers only need to see it published
+        buffers_registered_.store(true, std::memory_order_release);
+    }
+
+    auto uring_context::find_registered_buffer(std::span<const std::byte> buffer) const noexcept -> int {
+        if (buffer.empty() or not buffers_registered_.load(std::memory_order_acquire)) return -1;
+        // registrations may overlap: any of those starting at or before `buffer` may be the one holding all of it
+        const auto end = buffer.data() + buffer.size();
+        auto it = std::ranges::upper_bound(registered_buffers_, buffer.data(), {}, &registered_buffer::begin);
+        while (it != registered_buffers_.begin()) {
+            --it;
+            if (end <= it->end) return it->index;
+        }
+        return -1;
+    }
+
+    auto uring_context::recycle_buffer(std::uint16_t id) noexcept -> void {
+        multishot_node* starved = nullptr;
+        bool hand_over = false;
+        {
+            std::scoped_lock _{buf_ring_mtx_};
+            ::io_uring_buf_ring_add(
+                buf_ring_,
+                buf_ring_storage_ + std::size_t(id) * buf_ring_buffer_size_,
+                static_cast<unsigned>(buf_ring_buffer_size_),
+                id,
+                ::io_uring_buf_ring_mask(buf_ring_entries_),
+                0
+            );
+            ::io_uring_buf_ring_advance(buf_ring_, 1);
+            ++buffers_recycled_;
+            if (not starved_streams_.empty() and foreign_issuer()) {
+                // re-arming submits, leave it to the issuer thread
+                hand_over = not std::exchange(replenish_pending_, true);
+            }
+            else {
+                starved = starved_streams_.release();
+            }
+        }
+        if (hand_over) interrupt();
+        while (starved) {
+            const auto next = std::exchange(starved->starved_next_, nullptr);
+            starved->replenish();
+            starved = next;
+        }
+    }
+
+    auto uring_context::starve(multishot_node& stream) noexcept -> bool {
+        std::scoped_lock _{buf_ring_mtx_};
+        if (buffers_recycled_ != stream.recycled_) return false;
+        starved_streams_.push_back(stream);
+        return true;
+    }
+
+    auto uring_context::unstarve(multishot_node& stream) noexcept -> bool {
+        std::scoped_lock _{buf_ring_mtx_};
+        return starved_streams_.erase(stream);
+    }
+
+    auto uring_context::take_remote_requests() -> void {
+        if (not uring_mtx_.single_issuer) return;
+        multishot_node* starved = nullptr;
+        {
+            std::scoped_lock _{buf_ring_mtx_};
+            if (std::exchange(replenish_pending_, false)) starved = starved_streams_.release();
+        }
+        while (starved) {
+            const auto next = std::exchange(starved->starved_next_, nullptr);
+            starved->replenish();
+            starved = next;
+        }
+
+        std::scoped_lock _{remote_mtx_};
+        while (const auto op = remote_cancels_.pop_front()) {
+            op->remote_cancel_ = false;
+            op->do_cancel();
+        }
+        for (const int fd : remote_fd_cancels_) {
+            if (std::ranges::find(deferred_fd_cancels_, fd) == deferred_fd_cancels_.end()) {
+                deferred_fd_cancels_.push_back(fd); // submitted by `drain_overflow`
+            }
+        }
+        remote_fd_cancels_.clear();
+    }
+
+    auto uring_context::acquire_splice_pipe(splice_pipe& pipe) noexcept -> int {
+        {
+            std::scoped_lock _{splice_pipes_mtx_};
+            if (not splice_pipes_.empty()) {
+                pipe = splice_pipes_.back();
+                splice_pipes_.pop_back();
+                return 0;
+            }
+        }
+        int fds[2];
+        if (::pipe2(fds, O_CLOEXEC) == -1) [[unlikely]] return errno;
+        (void)::fcntl(fds[1], F_SETPIPE_SZ, splice_pipe_size);
+        const int capacity = ::fcntl(fds[1], F_GETPIPE_SZ);
+        pipe = {fds[0], fds[1], capacity > 0 ? std::size_t(capacity) : std::size_t{65536}};
+        return 0;
+    }
+
+    auto uring_context::release_splice_pipe(splice_pipe& pipe, bool reusable) noexcept -> void {
+        if (pipe.read_end == -1) return;
+        if (reusable) {
+            std::scoped_lock _{splice_pipes_mtx_};
+            if (splice_pipes_.size() < max_idle_splice_pipes) {
+                splice_pipes_.push_back(std::exchange(pipe, {}));
+                return;
+            }
+        }
+        // a pipe still holding data would hand it to the next transfer
+        ::close(pipe.read_end);
+        ::close(pipe.write_end);
+        pipe = {};
+    }
+
+    auto uring_context::arm_wakeup() noexcept -> bool {
+        auto sqe = allocate_sqe();
+        if (sqe == nullptr) [[unlikely]] return false;
+        ::io_uring_prep_poll_multishot(sqe, wakeup_fd_, POLLIN);
+        ::io_uring_sqe_set_data(sqe, &wakeup_fd_);
+        submit_sqes();
+        wakeup_armed_ = true;
+        return true;
+    }
+
+    auto uring_context::drain_wakeup() noexcept -> void {
+        ::eventfd_t value;
+        (void)::eventfd_read(wakeup_fd_, &value);
+    }
+
     auto uring_context::interrupt() -> void {
+        if (wakeup_fd_ != -1) {
+            (void)::eventfd_write(wakeup_fd_, 1);
+            return;
+        }
         std::scoped_lock _{uring_mtx_};
         auto sqe = allocate_sqe();
         if (sqe == nullptr) [[unlikely]] {
-            sqe_exhuasted();
+            // without SQ polling a ring stays full only while the kernel holds back completions,
+            // so the consumer is about to wake anyway
+            return;
         }
         ::io_uring_prep_nop(sqe);
         ::io_uring_sqe_set_data(sqe, this);
@@ -273,12 +868,24 @@ namespace coio {
     }
 
     namespace detail {
+        auto uring_buffer_lease::reset() noexcept -> void {
+            if (context_ == nullptr) return;
+            std::exchange(context_, nullptr)->recycle_buffer(id_);
+            data_ = {};
+        }
+
+
         /// async_read_some
         auto uring_state_base_for<read_some_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
-            ::io_uring_prep_read(sqe, fd, buffer_.data(), buffer_.size(), -1);
+            if (const int index = context_.find_registered_buffer(buffer_); index != -1) {
+                ::io_uring_prep_read_fixed(sqe, fd, buffer_.data(), buffer_.size(), -1, index);
+            }
+            else {
+                ::io_uring_prep_read(sqe, fd, buffer_.data(), buffer_.size(), -1);
+            }
         }
 
-        auto uring_state_base_for<read_some_tag>::complete(int cqe_res) noexcept -> void {
+        auto uring_state_base_for<read_some_tag>::complete(int cqe_res, std::uint32_t) noexcept -> void {
             if (cqe_res < 0) {
                 const std::error_code ec{-cqe_res, std::system_category()};
                 if (ec == std::errc::operation_canceled) {
@@ -301,16 +908,68 @@ namespace coio {
 
         /// async_write_some
         auto uring_state_base_for<write_some_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
-            ::io_uring_prep_write(sqe, fd, buffer_.data(), buffer_.size(), -1);
+            if (const int index = context_.find_registered_buffer(buffer_); index != -1) {
+                ::io_uring_prep_write_fixed(sqe, fd, buffer_.data(), buffer_.size(), -1, index);
+            }
+            else {
+                ::io_uring_prep_write(sqe, fd, buffer_.data(), buffer_.size(), -1);
+            }
+        }
+
+
+        /// async_read_some (scatter), async_receive (scatter)
+        auto uring_state_base_for<read_some_vectored_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            ::io_uring_prep_readv(sqe, fd, buffers_.data(), static_cast<unsigned>(buffers_.count()), -1);
+        }
+
+        auto uring_state_base_for<read_some_vectored_tag>::try_complete() noexcept -> bool {
+            if (buffers_.overflowed()) [[unlikely]] {
+                result.set_error(std::make_error_code(std::errc::message_size));
+                return true;
+            }
+            if (not eof_on_zero_ or buffers_.total() != 0) return false;
+            result.set_value(0);
+            return true;
+        }
+
+        auto uring_state_base_for<read_some_vectored_tag>::complete(int cqe_res, std::uint32_t) noexcept -> void {
+            if (cqe_res < 0) {
+                const std::error_code ec{-cqe_res, std::system_category()};
+                if (ec == std::errc::operation_canceled) {
+                    result.set_stopped();
+                }
+                else {
+                    result.set_error(ec);
+                }
+            }
+            else {
+                if (eof_on_zero_ and cqe_res == 0) [[unlikely]] {
+                    result.set_error(error::eof);
+                }
+                else {
+                    result.set_value(cqe_res);
+                }
+            }
+        }
+
+
+        /// async_write_some (gather)
+        auto uring_state_base_for<write_some_vectored_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            ::io_uring_prep_writev(sqe, fd, buffers_.data(), static_cast<unsigned>(buffers_.count()), -1);
         }
 
 
         /// async_read_some_at
         auto uring_state_base_for<read_some_at_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
-            ::io_uring_prep_read(sqe, fd, buffer_.data(), buffer_.size(), offset_);
+            if (const int index = context_.find_registered_buffer(buffer_); index != -1) {
+                ::io_uring_prep_read_fixed(sqe, fd, buffer_.data(), buffer_.size(), offset_, index);
+            }
+            else {
+                ::io_uring_prep_read(sqe, fd, buffer_.data(), buffer_.size(), offset_);
+            }
         }
 
-        auto uring_state_base_for<read_some_at_tag>::complete(int cqe_res) noexcept -> void {
+        auto uring_state_base_for<read_some_at_tag>::complete(int cqe_res, std::uint32_t) noexcept -> void {
             if (cqe_res < 0) {
                 const std::error_code ec{-cqe_res, std::system_category()};
                 if (ec == std::errc::operation_canceled) {
@@ -332,7 +991,12 @@ namespace coio {
 
         /// async_write_some_at
         auto uring_state_base_for<write_some_at_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
-            ::io_uring_prep_write(sqe, fd, buffer_.data(), buffer_.size(), offset_);
+            if (const int index = context_.find_registered_buffer(buffer_); index != -1) {
+                ::io_uring_prep_write_fixed(sqe, fd, buffer_.data(), buffer_.size(), offset_, index);
+            }
+            else {
+                ::io_uring_prep_write(sqe, fd, buffer_.data(), buffer_.size(), offset_);
+            }
         }
 
 
@@ -347,7 +1011,7 @@ namespace coio {
             return true;
         }
 
-        auto uring_state_base_for<receive_tag>::complete(int cqe_res) noexcept -> void {
+        auto uring_state_base_for<receive_tag>::complete(int cqe_res, std::uint32_t) noexcept -> void {
             if (cqe_res < 0) {
                 const std::error_code ec{-cqe_res, std::system_category()};
                 if (ec == std::errc::operation_canceled) {
@@ -367,12 +1031,188 @@ namespace coio {
             }
         }
 
+        /// async_receive_buffered
+        auto uring_state_base_for<receive_buffered_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            ::io_uring_prep_recv(sqe, fd, nullptr, context_.buf_ring_buffer_size_, 0);
+            sqe->flags |= IOSQE_BUFFER_SELECT;
+            sqe->buf_group = provided_buffer_group;
+        }
+
+        auto uring_state_base_for<receive_buffered_tag>::try_complete() noexcept -> bool {
+            if (context_.buf_ring_ != nullptr) return false;
+            result.set_error(std::make_error_code(std::errc::operation_not_supported));
+            return true;
+        }
+
+        auto uring_state_base_for<receive_buffered_tag>::complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void {
+            // the kernel may pick a buffer even when the receive fails; the lease hands it back in any case
+            uring_buffer_lease lease;
+            if (cqe_flags & IORING_CQE_F_BUFFER) {
+                const auto id = static_cast<std::uint16_t>(cqe_flags >> IORING_CQE_BUFFER_SHIFT);
+                const auto data = context_.buf_ring_storage_ + std::size_t(id) * context_.buf_ring_buffer_size_;
+                lease = uring_buffer_lease{context_, id, {data, cqe_res > 0 ? std::size_t(cqe_res) : 0}};
+            }
+            if (cqe_res < 0) {
+                const std::error_code ec{-cqe_res, std::system_category()};
+                if (ec == std::errc::operation_canceled) {
+                    result.set_stopped();
+                }
+                else {
+                    result.set_error(ec);
+                }
+            }
+            else {
+                if (stream_oriented_ and cqe_res == 0) [[unlikely]] {
+                    result.set_error(error::eof);
+                }
+                else {
+                    result.set_value(std::move(lease));
+                }
+            }
+        }
+
         /// async_send
         auto uring_state_base_for<send_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
             ::io_uring_prep_send(sqe, fd, buffer_.data(), buffer_.size(), MSG_NOSIGNAL);
         }
 
 
+        /// async_send (gather)
+        uring_state_base_for<send_vectored_tag>::uring_state_base_for(int fd, uring_context& context, const iovec_buffers& buffers) noexcept :
+            uring_node_for(fd, context),
+            buffers_(buffers) {
+            msg_ = {
+                .msg_iov = buffers_.data(),
+                .msg_iovlen = buffers_.count()
+            };
+        }
+
+        auto uring_state_base_for<send_vectored_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            ::io_uring_prep_sendmsg(sqe, fd, &msg_, MSG_NOSIGNAL);
+        }
+
+        auto uring_state_base_for<send_vectored_tag>::try_complete() noexcept -> bool {
+            if (not buffers_.overflowed()) [[likely]] return false;
+            result.set_error(std::make_error_code(std::errc::message_size));
+            return true;
+        }
+
+
+        /// async_send_zc
+        auto uring_state_base_for<send_zc_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            if (not context_.send_zc_supported_) [[unlikely]] {
+                // before Linux 6.0: a copying send lets go of the buffer as soon as it completes, too
+                ::io_uring_prep_send(sqe, fd, buffer_.data(), buffer_.size(), MSG_NOSIGNAL);
+            }
+            else if (const int index = context_.find_registered_buffer(buffer_); index != -1) {
+                ::io_uring_prep_send_zc_fixed(sqe, fd, buffer_.data(), buffer_.size(), MSG_NOSIGNAL, 0, static_cast<unsigned>(index));
+            }
+            else {
+                ::io_uring_prep_send_zc(sqe, fd, buffer_.data(), buffer_.size(), MSG_NOSIGNAL, 0);
+            }
+        }
+
+        auto uring_state_base_for<send_zc_tag>::complete(int cqe_res, std::uint32_t cqe_flags) noexcept -> void {
+            // the notification: the kernel doesn't reference the buffer anymore
+            if (cqe_flags & IORING_CQE_F_NOTIF) {
+                publish();
+                return;
+            }
+            if (cqe_res < 0) {
+                const std::error_code ec{-cqe_res, std::system_category()};
+                if (ec == std::errc::operation_canceled) {
+                    result.set_stopped();
+                }
+                else {
+                    result.set_error(ec);
+                }
+            }
+            else {
+                result.set_value(static_cast<std::size_t>(cqe_res));
+            }
+            // without `F_MORE` no notification follows
+            if (not (cqe_flags & IORING_CQE_F_MORE)) publish();
+        }
+
+
+        /// async_sendfile
+        auto uring_state_base_for<sendfile_tag>::try_complete() noexcept -> bool {
+            if (count_ == 0) [[unlikely]] {
+                result.set_value(0);
+                return true;
+            }
+            if (const int ec = context_.acquire_splice_pipe(pipe_); ec != 0) [[unlikely]] {
+                result.set_error(std::error_code{ec, std::system_category()});
+                return true;
+            }
+            return false;
+        }
+
+        auto uring_state_base_for<sendfile_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            if (file_index != -1) socket_index_ = std::exchange(file_index, -1);
+            if (in_pipe_ == 0) {
+                const auto n = std::min(count_ - sent_, pipe_.capacity);
+                ::io_uring_prep_splice(sqe, file_, static_cast<std::int64_t>(offset_ + sent_), pipe_.write_end, -1, static_cast<unsigned>(n), SPLICE_F_MOVE);
+            }
+            else {
+                ::io_uring_prep_splice(sqe, pipe_.read_end, -1, fd, -1, static_cast<unsigned>(in_pipe_), SPLICE_F_MOVE);
+                if (socket_index_ != -1) {
+                    sqe->fd = socket_index_;
+                    sqe->flags |= IOSQE_FIXED_FILE;
+                }
+            }
+        }
+
+        auto uring_state_base_for<sendfile_tag>::do_cancel() -> void {
+            // between two splices there is no request to cancel, the flag stops the next one
+            cancelled_.store(true);
+            uring_node_for::do_cancel();
+        }
+
+        auto uring_state_base_for<sendfile_tag>::resubmit() noexcept -> bool {
+            std::scoped_lock _{context_.uring_mtx_};
+            if (cancelled_.load()) return false;
+            auto sqe = context_.allocate_sqe();
+            if (sqe == nullptr) [[unlikely]] {
+                context_.defer(*this, uring_context::overflow_state::start);
+                return true;
+            }
+            prepare(sqe);
+            ::io_uring_sqe_set_data(sqe, static_cast<uring_node*>(this));
+            COIO_TSAN_RELEASE(static_cast<uring_node*>(this));
+            context_.post_submit_sqes();
+            return true;
+        }
+
+        auto uring_state_base_for<sendfile_tag>::complete(int cqe_res, std::uint32_t) noexcept -> void {
+            if (cqe_res > 0) {
+                if (in_pipe_ == 0) {
+                    in_pipe_ = static_cast<std::size_t>(cqe_res);
+                }
+                else {
+                    in_pipe_ -= static_cast<std::size_t>(cqe_res);
+                    sent_ += static_cast<std::size_t>(cqe_res);
+                }
+                if ((in_pipe_ > 0 or sent_ < count_) and resubmit()) return;
+            }
+            // done: everything was sent, the file ended, or a splice failed or was cancelled
+            context_.release_splice_pipe(pipe_, in_pipe_ == 0);
+            if (sent_ > 0) {
+                result.set_value(sent_);
+            }
+            else if (cqe_res == -ECANCELED or cancelled_.load()) {
+                result.set_stopped();
+            }
+            else if (cqe_res < 0) {
+                result.set_error(std::error_code{-cqe_res, std::system_category()});
+            }
+            else {
+                result.set_error(error::eof); // the file ends before `offset_`
+            }
+            publish();
+        }
+
+
         /// async_receive_from
         uring_state_base_for<receive_from_tag>::uring_state_base_for(int fd, uring_context& context, std::span<std::byte> buffer) noexcept :
             uring_node_for(fd, context) {
@@ -392,7 +1232,7 @@ namespace coio {
             ::io_uring_prep_recvmsg(sqe, fd, &msg_, 0);
         }
 
-        auto uring_state_base_for<receive_from_tag>::complete(int cqe_res) noexcept -> void {
+        auto uring_state_base_for<receive_from_tag>::complete(int cqe_res, std::uint32_t) noexcept -> void {
             if (cqe_res < 0) {
                 const std::error_code ec{-cqe_res, std::system_category()};
                 if (ec == std::errc::operation_canceled) {
@@ -430,12 +1270,202 @@ namespace coio {
         }
 
 
+        /// async_receive_many
+        auto uring_state_base_for<receive_many_tag>::receive() noexcept -> bool {
+            const int n = ::recvmmsg(fd, batch_.data(), batch_.count(), MSG_DONTWAIT, nullptr);
+            if (n == -1) {
+                if (is_blocking_errno(errno)) return false;
+                result.set_error(std::error_code{errno, std::system_category()});
+                return true;
+            }
+            batch_.finish_receive(slots_, n);
+            result.set_value(n);
+            return true;
+        }
+
+        auto uring_state_base_for<receive_many_tag>::try_complete() noexcept -> bool {
+            if (batch_.count() == 0) [[unlikely]] {
+                result.set_value(0);
+                return true;
+            }
+            return receive();
+        }
+
+        auto uring_state_base_for<receive_many_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            ::io_uring_prep_poll_add(sqe, fd, POLLIN);
+        }
+
+        auto uring_state_base_for<receive_many_tag>::do_cancel() -> void {
+            // between two polls there is no request to cancel, the flag stops the next one
+            cancelled_.store(true);
+            uring_node_for::do_cancel();
+        }
+
+        auto uring_state_base_for<receive_many_tag>::resubmit() noexcept -> bool {
+            std::scoped_lock _{context_.uring_mtx_};
+            if (cancelled_.load()) return false;
+            auto sqe = context_.allocate_sqe();
+            if (sqe == nullptr) [[unlikely]] {
+                context_.defer(*this, uring_context::overflow_state::start);
+                return true;
+            }
+            prepare(sqe);
+            use_fixed_file(sqe);
+            ::io_uring_sqe_set_data(sqe, static_cast<uring_node*>(this));
+            COIO_TSAN_RELEASE(static_cast<uring_node*>(this));
+            context_.post_submit_sqes();
+            return true;
+        }
+
+        auto uring_state_base_for<receive_many_tag>::complete(int cqe_res, std::uint32_t) noexcept -> void {
+            if (cqe_res >= 0) {
+                if (receive()) {
+                    publish();
+                    return;
+                }
+                if (resubmit()) return; // another reader took the datagrams
+            }
+            if (cqe_res == -ECANCELED or cancelled_.load()) {
+                result.set_stopped();
+            }
+            else {
+                result.set_error(std::error_code{-cqe_res, std::system_category()});
+            }
+            publish();
+        }
+
+
+        /// async_send_many
+        auto uring_state_base_for<send_many_tag>::send() noexcept -> bool {
+            const int n = ::sendmmsg(fd, batch_.data(), batch_.count(), MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n == -1) {
+                if (is_blocking_errno(errno)) return false;
+                result.set_error(std::error_code{errno, std::system_category()});
+                return true;
+            }
+            result.set_value(n);
+            return true;
+        }
+
+        auto uring_state_base_for<send_many_tag>::try_complete() noexcept -> bool {
+            if (batch_.count() == 0) [[unlikely]] {
+                result.set_value(0);
+                return true;
+            }
+            return send();
+        }
+
+        auto uring_state_base_for<send_many_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            ::io_uring_prep_poll_add(sqe, fd, POLLOUT);
+        }
+
+        auto uring_state_base_for<send_many_tag>::do_cancel() -> void {
+            // between two polls there is no request to cancel, the flag stops the next one
+            cancelled_.store(true);
+            uring_node_for::do_cancel();
+        }
+
+        auto uring_state_base_for<send_many_tag>::resubmit() noexcept -> bool {
+            std::scoped_lock _{context_.uring_mtx_};
+            if (cancelled_.load()) return false;
+            auto sqe = context_.allocate_sqe();
+            if (sqe == nullptr) [[unlikely]] {
+                context_.defer(*this, uring_context::overflow_state::start);
+                return true;
+            }
+            prepare(sqe);
+            use_fixed_file(sqe);
+            ::io_uring_sqe_set_data(sqe, static_cast<uring_node*>(this));
+            COIO_TSAN_RELEASE(static_cast<uring_node*>(this));
+            context_.post_submit_sqes();
+            return true;
+        }
+
+        auto uring_state_base_for<send_many_tag>::complete(int cqe_res, std::uint32_t) noexcept -> void {
+            if (cqe_res >= 0) {
+                if (send()) {
+                    publish();
+                    return;
+                }
+                if (resubmit()) return; // the send buffer filled up again
+            }
+            if (cqe_res == -ECANCELED or cancelled_.load()) {
+                result.set_stopped();
+            }
+            else {
+                result.set_error(std::error_code{-cqe_res, std::system_category()});
+            }
+            publish();
+        }
+
+
         /// async_accept
         auto uring_state_base_for<accept_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
             ::io_uring_prep_accept(sqe, fd, nullptr, nullptr, 0);
         }
 
 
+        /// async_sync_all, async_sync_data
+        auto uring_state_base_for<sync_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            ::io_uring_prep_fsync(sqe, fd, data_only_ ? IORING_FSYNC_DATASYNC : 0);
+        }
+
+
+        /// async_allocate
+        auto uring_state_base_for<allocate_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            ::io_uring_prep_fallocate(sqe, fd, mode_, offset_, length_);
+        }
+
+
+        /// async_stat
+        auto uring_state_base_for<stat_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            ::io_uring_prep_statx(sqe, fd, "", AT_EMPTY_PATH, mask_, &stx_);
+        }
+
+        auto uring_state_base_for<stat_tag>::complete(int cqe_res, std::uint32_t) noexcept -> void {
+            if (cqe_res < 0) {
+                const std::error_code ec{-cqe_res, std::system_category()};
+                if (ec == std::errc::operation_canceled) {
+                    result.set_stopped();
+                }
+                else {
+                    result.set_error(ec);
+                }
+            }
+            else {
+                result.set_value(stx_);
+            }
+        }
+
+
+        /// scheduler::async_open
+        auto uring_state_base_for<open_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            ::io_uring_prep_openat(sqe, fd, path_.c_str(), native_open_flags(mode_), 0777);
+        }
+
+        auto uring_state_base_for<open_tag>::complete(int cqe_res, std::uint32_t) noexcept -> void {
+            if (cqe_res < 0) {
+                const std::error_code ec{-cqe_res, std::system_category()};
+                if (ec == std::errc::operation_canceled) {
+                    result.set_stopped();
+                }
+                else {
+                    result.set_error(ec);
+                }
+            }
+            else {
+                if (random_access_) ::posix_fadvise(cqe_res, 0, 0, POSIX_FADV_RANDOM);
+                result.set_value(cqe_res);
+            }
+        }
+
+
+        /// async_close
+        auto uring_state_base_for<close_tag>::prepare(::io_uring_sqe* sqe) noexcept -> void {
+            ::io_uring_prep_close(sqe, fd);
+        }
+
+
         /// async_connect
         uring_state_base_for<connect_tag>::uring_state_base_for(int fd, uring_context& context, const endpoint& peer) noexcept :
             uring_node_for(fd, context),
@@ -1,10 +1,15 @@
 #include <cstdio>
+#include <cstring>
 #include <memory>
+#include <vector>
+#include <linux/filter.h>
 #include <netinet/tcp.h>
+#include <netinet/udp.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <coio/utils/utility.h>
 #include <coio/net/socket.h>
+#include <coio/detail/mmsg_batch.h>
 #include "../common.h"
 
 namespace coio::detail::socket {
@@ -84,6 +89,10 @@ namespace coio::detail::socket {
         return IPPROTO_TCP;
     }
 
+    auto ipproto_udp_v() noexcept -> int {
+        return IPPROTO_UDP;
+    }
+
     auto sock_option_traits<::linger>::from_value(const ::linger& value) noexcept -> linger_storage {
         return std::bit_cast<linger_storage>(value);
     }
@@ -144,6 +153,43 @@ namespace coio::detail::socket {
         return TCP_NODELAY;
     }
 
+    auto udp_segment_size::name() noexcept -> int {
+        return UDP_SEGMENT;
+    }
+
+    auto reuse_port::name() noexcept -> int {
+        return SO_REUSEPORT;
+    }
+
+    auto incoming_cpu::name() noexcept -> int {
+        return SO_INCOMING_CPU;
+    }
+
+    auto attach_reuseport_cpu_steering(socket_native_handle_type handle, std::span<const unsigned> cpus) -> void {
+        check_fd(handle);
+        // A = cpu; for each i: if A == cpus[i] return i; otherwise return an out-of-range index,
+        // which makes the kernel fall back to hashing
+        if (cpus.size() > (BPF_MAXINSNS - 2) / 2) {
+            throw std::system_error{std::make_error_code(std::errc::invalid_argument), "attach_reuseport_cpu_steering"};
+        }
+        std::vector<::sock_filter> code;
+        code.reserve(cpus.size() * 2 + 2);
+        code.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<::__u32>(SKF_AD_OFF + SKF_AD_CPU)));
+        for (std::size_t i = 0; i < cpus.size(); ++i) {
+            code.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, cpus[i], 0, 1));
+            code.push_back(BPF_STMT(BPF_RET | BPF_K, static_cast<::__u32>(i)));
+        }
+        code.push_back(BPF_STMT(BPF_RET | BPF_K, 0xffffffffu));
+        const ::sock_fprog program{
+            .len = static_cast<unsigned short>(code.size()),
+            .filter = code.data()
+        };
+        throw_last_error(
+            ::setsockopt(handle, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)),
+            "setsockopt(SO_ATTACH_REUSEPORT_CBPF)"
+        );
+    }
+
     auto open(int family, int type, int protocol_id) -> socket_native_handle_type {
         const int fd = ::socket(family, type, protocol_id);
         if (fd == -1) [[unlikely]] {
@@ -258,3 +304,46 @@ namespace coio::detail::socket {
         }
     }
 }
+
+
+namespace coio::detail {
+    mmsg_batch::mmsg_batch(std::span<datagram_receive_slot> slots) noexcept {
+        for (auto& slot : slots) {
+            if (count_ == max_count) break;
+            iov_[count_] = {slot.buffer.data(), slot.buffer.size()};
+            msgs_[count_].msg_hdr = {
+                .msg_name = &peers_[count_],
+                .msg_namelen = sizeof(::sockaddr_in6),
+                .msg_iov = &iov_[count_],
+                .msg_iovlen = 1
+            };
+            ++count_;
+        }
+    }
+
+    mmsg_batch::mmsg_batch(std::span<const datagram_send_slot> slots) noexcept {
+        for (const auto& slot : slots) {
+            if (count_ == max_count) break;
+            auto sa = endpoint_to_sockaddr_in(slot.peer);
+            auto [psa, len] = to_sockaddr(sa);
+            std::memcpy(&peers_[count_], psa, len);
+            iov_[count_] = {const_cast<std::byte*>(slot.buffer.data()), slot.buffer.size()};
+            msgs_[count_].msg_hdr = {
+                .msg_name = &peers_[count_],
+                .msg_namelen = len,
+                .msg_iov = &iov_[count_],
+                .msg_iovlen = 1
+            };
+            ++count_;
+        }
+    }
+
+    auto mmsg_batch::finish_receive(std::span<datagram_receive_slot> slots, std::size_t n) noexcept -> void {
+        for (std::size_t i = 0; i < n; ++i) {
+            auto& slot = slots[i];
+            slot.peer = sockaddr_to_endpoint(reinterpret_cast<::sockaddr*>(&peers_[i]));
+            slot.size = msgs_[i].msg_len;
+            slot.truncated = (msgs_[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#include <system_error>
+#include <pthread.h>
+#include <sched.h>
+#include <coio/detail/thread_affinity.h>
+#include "../common.h"
+
+namespace coio::detail {
+    auto allowed_cpus() -> std::vector<unsigned> {
+        ::cpu_set_t set;
+        CPU_ZERO(&set);
+        throw_last_error(::sched_getaffinity(0, sizeof(set), &set), "sched_getaffinity");
+        std::vector<unsigned> cpus;
+        cpus.reserve(static_cast<std::size_t>(CPU_COUNT(&set)));
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    auto pin_thread(std::thread::native_handle_type thread, unsigned cpu) -> void {
+        ::cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        // pthread functions return the error instead of setting errno
+        if (const int ec = ::pthread_setaffinity_np(thread, sizeof(set), &set); ec != 0) {
+            throw std::system_error(ec, std::system_category(), "pthread_setaffinity_np");
+        }
+    }
+}
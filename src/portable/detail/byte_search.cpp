@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <coio/detail/byte_search.h>
+
+#if defined(__x86_64__) or defined(_M_X64) or (defined(__i386__) and defined(__SSE2__))
+#define COIO_BYTE_SEARCH_X86 1
+#include <immintrin.h>
+#if COIO_CXX_COMPILER_MSVC
+#include <intrin.h>
+#define COIO_TARGET_AVX2
+#else
+#define COIO_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define COIO_BYTE_SEARCH_X86 0
+#endif
+
+namespace coio::detail {
+    namespace {
+        // candidates are found by their first byte, then checked on their last byte before comparing the rest
+        auto find_substring_scalar(const char* first, const char* last, std::string_view needle) noexcept -> const char* {
+            const std::size_t m = needle.size();
+            if (static_cast<std::size_t>(last - first) < m) return last;
+            const char* const stop = last - m + 1;
+            for (const char* p = first; (p = find_byte(p, stop, needle.front())) != stop; ++p) {
+                if (p[m - 1] == needle.back() and std::memcmp(p + 1, needle.data() + 1, m - 2) == 0) return p;
+            }
+            return last;
+        }
+
+        auto find_any_byte_scalar(const char* first, const char* last, std::string_view set) noexcept -> const char* {
+            std::array<bool, 256> table{};
+            for (char c : set) table[static_cast<unsigned char>(c)] = true;
+            for (; first != last; ++first) {
+                if (table[static_cast<unsigned char>(*first)]) return first;
+            }
+            return last;
+        }
+
+#if COIO_BYTE_SEARCH_X86
+        auto has_avx2() noexcept -> bool {
+#if COIO_CXX_COMPILER_MSVC
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+            __cpuid(info, 1);
+            constexpr int osxsave = 1 << 27, avx = 1 << 28;
+            if ((info[2] & (osxsave | avx)) != (osxsave | avx) or (_xgetbv(0) & 0b110) != 0b110) return false;
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+
+        // a search made during static initialization, before this is set, sees `false` and takes the SSE2 kernels
+        const bool use_avx2 = has_avx2();
+
+        auto find_substring_sse2(const char* first, const char* last, std::string_view needle) noexcept -> const char* {
+            const std::size_t m = needle.size();
+            const __m128i front = _mm_set1_epi8(needle.front());
+            const __m128i back = _mm_set1_epi8(needle.back());
+            const char* p = first;
+            // both loads, at `p` and at `p + m - 1`, stay within the range
+            for (; static_cast<std::size_t>(last - p) >= m + 15; p += 16) {
+                const __m128i at_front = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                const __m128i at_back = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + m - 1));
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+                    _mm_and_si128(_mm_cmpeq_epi8(at_front, front), _mm_cmpeq_epi8(at_back, back))
+                ));
+                for (; mask != 0; mask &= mask - 1) {
+                    const char* candidate = p + std::countr_zero(mask);
+                    if (std::memcmp(candidate + 1, needle.data() + 1, m - 2) == 0) return candidate;
+                }
+            }
+            return find_substring_scalar(p, last, needle);
+        }
+
+        COIO_TARGET_AVX2
+        auto find_substring_avx2(const char* first, const char* last, std::string_view needle) noexcept -> const char* {
+            const std::size_t m = needle.size();
+            const __m256i front = _mm256_set1_epi8(needle.front());
+            const __m256i back = _mm256_set1_epi8(needle.back());
+            const char* p = first;
+            for (; static_cast<std::size_t>(last - p) >= m + 31; p += 32) {
+                const __m256i at_front = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                const __m256i at_back = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + m - 1));
+                auto mask = static_cast<unsigned>(_mm256_movemask_epi8(
+                    _mm256_and_si256(_mm256_cmpeq_epi8(at_front, front), _mm256_cmpeq_epi8(at_back, back))
+                ));
+                for (; mask != 0; mask &= mask - 1) {
+                    const char* candidate = p + std::countr_zero(mask);
+                    if (std::memcmp(candidate + 1, needle.data() + 1, m - 2) == 0) return candidate;
+                }
+            }
+            return find_substring_sse2(p, last, needle);
+        }
+
+        // `set` holds one to four bytes, repeated up to four
+        auto find_any_byte_sse2(const char* first, const char* last, const std::array<char, 4>& set) noexcept -> const char* {
+            const __m128i c0 = _mm_set1_epi8(set[0]), c1 = _mm_set1_epi8(set[1]);
+            const __m128i c2 = _mm_set1_epi8(set[2]), c3 = _mm_set1_epi8(set[3]);
+            const char* p = first;
+            for (; last - p >= 16; p += 16) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                const __m128i eq = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(v, c0), _mm_cmpeq_epi8(v, c1)),
+                    _mm_or_si128(_mm_cmpeq_epi8(v, c2), _mm_cmpeq_epi8(v, c3))
+                );
+                if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(eq)); mask != 0) {
+                    return p + std::countr_zero(mask);
+                }
+            }
+            for (; p != last; ++p) {
+                if (*p == set[0] or *p == set[1] or *p == set[2] or *p == set[3]) return p;
+            }
+            return last;
+        }
+
+        COIO_TARGET_AVX2
+        auto find_any_byte_avx2(const char* first, const char* last, const std::array<char, 4>& set) noexcept -> const char* {
+            const __m256i c0 = _mm256_set1_epi8(set[0]), c1 = _mm256_set1_epi8(set[1]);
+            const __m256i c2 = _mm256_set1_epi8(set[2]), c3 = _mm256_set1_epi8(set[3]);
+            const char* p = first;
+            for (; last - p >= 32; p += 32) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                const __m256i eq = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(v, c0), _mm256_cmpeq_epi8(v, c1)),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(v, c2), _mm256_cmpeq_epi8(v, c3))
+                );
+                if (const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(eq)); mask != 0) {
+                    return p + std::countr_zero(mask);
+                }
+            }
+            return find_any_byte_sse2(p, last, set);
+        }
+#endif
+    }
+
+    auto find_substring(const char* first, const char* last, std::string_view needle) noexcept -> const char* {
+        COIO_ASSERT(needle.size() >= 2);
+#if COIO_BYTE_SEARCH_X86
+        if (use_avx2) return find_substring_avx2(first, last, needle);
+        return find_substring_sse2(first, last, needle);
+#else
+        return find_substring_scalar(first, last, needle);
+#endif
+    }
+
+    auto find_any_byte(const char* first, const char* last, std::string_view set) noexcept -> const char* {
+        if (set.empty()) return last;
+        if (set.size() == 1) return find_byte(first, last, set.front());
+#if COIO_BYTE_SEARCH_X86
+        if (set.size() <= 4) {
+            std::array<char, 4> padded;
+            padded.fill(set.front());
+            std::ranges::copy(set, padded.begin());
+            if (use_avx2) return find_any_byte_avx2(first, last, padded);
+            return find_any_byte_sse2(first, last, padded);
+        }
+#endif
+        return find_any_byte_scalar(first, last, set);
+    }
+}
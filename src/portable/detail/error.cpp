@@ -21,10 +21,43 @@ namespace coio::error {
                 }
             }
         };
+
+        struct dns_category_t : std::error_category {
+            auto name() const noexcept -> const char* override {
+                return "coio.error.dns";
+            }
+
+            auto message(int ec) const -> std::string override {
+                switch (static_cast<dns_errc>(ec)) {
+                case dns_errc::host_not_found:
+                    return "host not found";
+                case dns_errc::no_data:
+                    return "no address for the host";
+                case dns_errc::server_failure:
+                    return "name server failure";
+                case dns_errc::refused:
+                    return "name server refused the query";
+                case dns_errc::timed_out:
+                    return "name server timed out";
+                case dns_errc::no_name_servers:
+                    return "no name servers configured";
+                case dns_errc::invalid_name:
+                    return "invalid domain name";
+                case dns_errc::malformed_response:
+                    return "malformed name server response";
+                default: unreachable();
+                }
+            }
+        };
     }
 
     auto misc_category() noexcept -> const std::error_category& {
         static misc_category_t instance;
         return instance;
     }
+
+    auto dns_category() noexcept -> const std::error_category& {
+        static dns_category_t instance;
+        return instance;
+    }
 }
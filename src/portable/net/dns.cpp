@@ -0,0 +1,494 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <coio/net/dns.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio {
+    namespace detail {
+        namespace {
+            constexpr std::uint16_t dns_flag_response = 0x8000;
+            constexpr std::uint16_t dns_flag_truncated = 0x0200;
+            constexpr std::uint16_t dns_flag_recursion_desired = 0x0100;
+            constexpr std::uint16_t dns_class_in = 1;
+            constexpr std::size_t dns_header_size = 12;
+            constexpr std::size_t dns_max_name_size = 255;
+            constexpr std::size_t dns_max_label_size = 63;
+            constexpr int dns_max_cname_hops = 16;
+
+            [[noreturn]]
+            auto throw_malformed() -> void {
+                throw std::system_error{error::dns_errc::malformed_response, "async_resolve"};
+            }
+
+            class dns_reader {
+            public:
+                explicit dns_reader(std::span<const std::byte> message) noexcept : message_(message) {}
+
+                auto u8() -> std::uint8_t {
+                    need(1);
+                    return std::to_integer<std::uint8_t>(message_[pos_++]);
+                }
+
+                auto u16() -> std::uint16_t {
+                    const auto high = u8();
+                    return static_cast<std::uint16_t>(high << 8 | u8());
+                }
+
+                auto u32() -> std::uint32_t {
+                    const auto high = u16();
+                    return std::uint32_t{high} << 16 | u16();
+                }
+
+                auto skip(std::size_t n) -> void {
+                    need(n);
+                    pos_ += n;
+                }
+
+                [[nodiscard]]
+                auto bytes(std::size_t n) -> std::span<const std::byte> {
+                    need(n);
+                    return message_.subspan(std::exchange(pos_, pos_ + n), n);
+                }
+
+                // a possibly compressed name, lower-cased and without the trailing dot
+                auto name() -> std::string {
+                    std::string result;
+                    std::size_t pos = pos_;
+                    bool jumped = false;
+                    for (int jumps = 0; ; ) {
+                        if (pos >= message_.size()) throw_malformed();
+                        const auto length = std::to_integer<std::uint8_t>(message_[pos]);
+                        if ((length & 0xc0) == 0xc0) {
+                            if (pos + 1 >= message_.size() or ++jumps > 64) throw_malformed();
+                            const std::size_t target = (length & 0x3fu) << 8 | std::to_integer<std::uint8_t>(message_[pos + 1]);
+                            if (not jumped) pos_ = pos + 2;
+                            jumped = true;
+                            pos = target;
+                            continue;
+                        }
+                        if (length & 0xc0) throw_malformed(); // reserved label types
+                        ++pos;
+                        if (length == 0) break;
+                        if (pos + length > message_.size()) throw_malformed();
+                        if (not result.empty()) result.push_back('.');
+                        for (std::size_t i = 0; i < length; ++i) {
+                            result.push_back(static_cast<char>(std::tolower(std::to_integer<unsigned char>(message_[pos + i]))));
+                        }
+                        if (result.size() > dns_max_name_size) throw_malformed();
+                        pos += length;
+                    }
+                    if (not jumped) pos_ = pos;
+                    return result;
+                }
+
+                [[nodiscard]]
+                auto position() const noexcept -> std::size_t {
+                    return pos_;
+                }
+
+                auto seek(std::size_t pos) noexcept -> void {
+                    pos_ = pos;
+                }
+
+            private:
+                auto need(std::size_t n) const -> void {
+                    if (message_.size() - pos_ < n) throw_malformed();
+                }
+
+            private:
+                std::span<const std::byte> message_;
+                std::size_t pos_ = 0;
+            };
+
+            struct dns_record {
+                std::string owner;
+                dns_record_type type;
+                std::uint32_t ttl;
+                std::size_t rdata;
+                std::uint16_t rdlength;
+            };
+
+            auto read_record(dns_reader& reader) -> dns_record {
+                dns_record record;
+                record.owner = reader.name();
+                record.type = static_cast<dns_record_type>(reader.u16());
+                static_cast<void>(reader.u16()); // class
+                record.ttl = reader.u32();
+                record.rdlength = reader.u16();
+                record.rdata = reader.position();
+                reader.skip(record.rdlength);
+                return record;
+            }
+
+            auto trim(std::string_view text) noexcept -> std::string_view {
+                constexpr std::string_view blanks = " \t\r\n";
+                const auto first = text.find_first_not_of(blanks);
+                if (first == std::string_view::npos) return {};
+                return text.substr(first, text.find_last_not_of(blanks) - first + 1);
+            }
+
+            // calls `fn` with the blank-separated words of every line, comments removed
+            template<typename Fn>
+            auto for_each_line(std::string_view text, std::string_view comment_chars, Fn fn) -> void {
+                while (not text.empty()) {
+                    const auto eol = text.find('\n');
+                    auto line = text.substr(0, eol);
+                    text = eol == std::string_view::npos ? std::string_view{} : text.substr(eol + 1);
+                    line = trim(line.substr(0, line.find_first_of(comment_chars)));
+                    std::vector<std::string_view> words;
+                    while (not line.empty()) {
+                        const auto end = line.find_first_of(" \t");
+                        words.push_back(line.substr(0, end));
+                        line = end == std::string_view::npos ? std::string_view{} : trim(line.substr(end));
+                    }
+                    if (not words.empty()) fn(std::span<const std::string_view>{words});
+                }
+            }
+
+            auto parse_unsigned(std::string_view text) noexcept -> std::optional<unsigned> {
+                if (text.empty() or text.size() > 9) return {};
+                unsigned result = 0;
+                for (const char c : text) {
+                    if (c < '0' or c > '9') return {};
+                    result = result * 10 + static_cast<unsigned>(c - '0');
+                }
+                return result;
+            }
+
+            auto read_file(const std::filesystem::path& path) -> std::optional<std::string> {
+                std::ifstream file{path, std::ios::binary};
+                if (not file) return {};
+                std::ostringstream content;
+                content << file.rdbuf();
+                return std::move(content).str();
+            }
+        }
+
+        auto dns_normalize_name(std::string_view name) -> std::string {
+            if (name.ends_with('.')) name.remove_suffix(1);
+            std::string result{name};
+            for (char& c : result) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            return result;
+        }
+
+        auto dns_encode_query(std::uint16_t id, std::string_view name, dns_record_type type) -> std::vector<std::byte> {
+            if (name.empty() or name.size() + 2 > dns_max_name_size) {
+                throw std::system_error{error::dns_errc::invalid_name, "async_resolve"};
+            }
+            std::vector<std::byte> message;
+            message.reserve(dns_header_size + name.size() + 2 + 4);
+            auto put16 = [&message](std::uint16_t value) {
+                message.push_back(static_cast<std::byte>(value >> 8));
+                message.push_back(static_cast<std::byte>(value & 0xff));
+            };
+            put16(id);
+            put16(dns_flag_recursion_desired);
+            put16(1); // one question
+            put16(0);
+            put16(0);
+            put16(0);
+            while (true) {
+                const auto dot = name.find('.');
+                const auto label = name.substr(0, dot);
+                if (label.empty() or label.size() > dns_max_label_size) {
+                    throw std::system_error{error::dns_errc::invalid_name, "async_resolve"};
+                }
+                message.push_back(static_cast<std::byte>(label.size()));
+                for (const char c : label) message.push_back(static_cast<std::byte>(c));
+                if (dot == std::string_view::npos) break;
+                name.remove_prefix(dot + 1);
+            }
+            message.push_back(std::byte{0});
+            put16(static_cast<std::uint16_t>(type));
+            put16(dns_class_in);
+            return message;
+        }
+
+        auto dns_message_id(std::span<const std::byte> message) noexcept -> std::optional<std::uint16_t> {
+            if (message.size() < dns_header_size) return {};
+            return static_cast<std::uint16_t>(std::to_integer<std::uint16_t>(message[0]) << 8 | std::to_integer<std::uint16_t>(message[1]));
+        }
+
+        auto dns_parse_response(std::span<const std::byte> message, std::string_view name, dns_record_type type) -> dns_response {
+            dns_reader reader{message};
+            static_cast<void>(reader.u16()); // id, checked by the caller
+            const std::uint16_t flags = reader.u16();
+            const std::uint16_t question_count = reader.u16();
+            const std::uint16_t answer_count = reader.u16();
+            const std::uint16_t authority_count = reader.u16();
+            static_cast<void>(reader.u16()); // additional records: not used
+            if (not (flags & dns_flag_response)) throw_malformed();
+
+            dns_response response;
+            response.truncated = flags & dns_flag_truncated;
+            response.rcode = static_cast<std::uint8_t>(flags & 0x000f);
+            if (response.truncated) return response; // asked again over TCP
+
+            // it must answer our question, not someone else's, or none at all
+            if (question_count != 1) throw_malformed();
+            const auto question = reader.name();
+            const auto question_type = static_cast<dns_record_type>(reader.u16());
+            static_cast<void>(reader.u16()); // class
+            if (question != name or question_type != type) throw_malformed();
+
+            std::vector<dns_record> answers;
+            answers.reserve(answer_count);
+            for (std::uint16_t i = 0; i < answer_count; ++i) answers.push_back(read_record(reader));
+            const std::size_t authority = reader.position();
+
+            // follow the CNAME chain from `name`, it may come in any order
+            std::string current{name};
+            std::uint32_t ttl = std::numeric_limits<std::uint32_t>::max();
+            for (int hops = 0; hops < dns_max_cname_hops; ++hops) {
+                const auto alias = std::ranges::find_if(answers, [&](const dns_record& record) {
+                    return record.type == dns_record_type::cname and record.owner == current;
+                });
+                if (alias == answers.end()) break;
+                reader.seek(alias->rdata);
+                current = reader.name();
+                ttl = std::min(ttl, alias->ttl);
+                response.answer.canonical_name = current;
+            }
+            for (const dns_record& record : answers) {
+                if (record.type != type or record.owner != current) continue;
+                reader.seek(record.rdata);
+                if (type == dns_record_type::a and record.rdlength == 4) {
+                    response.answer.addresses.emplace_back(ipv4_address{reader.u32()});
+                }
+                else if (type == dns_record_type::aaaa and record.rdlength == 16) {
+                    std::array<std::byte, 16> bytes;
+                    std::ranges::copy(reader.bytes(16), bytes.begin());
+                    response.answer.addresses.emplace_back(std::bit_cast<ipv6_address>(bytes));
+                }
+                else {
+                    throw_malformed();
+                }
+                ttl = std::min(ttl, record.ttl);
+            }
+            if (not response.answer.addresses.empty()) {
+                response.answer.ttl = std::chrono::seconds{ttl};
+                return response;
+            }
+
+            // no address: how long to remember that is in the SOA record of the authority section
+            reader.seek(authority);
+            for (std::uint16_t i = 0; i < authority_count; ++i) {
+                const dns_record record = read_record(reader);
+                if (record.type != dns_record_type::soa) continue;
+                const auto after = reader.position();
+                reader.seek(record.rdata);
+                static_cast<void>(reader.name()); // primary name server
+                static_cast<void>(reader.name()); // responsible mailbox
+                reader.skip(4 * 4);               // serial, refresh, retry, expire
+                const std::uint32_t minimum = reader.u32();
+                response.negative_ttl = std::chrono::seconds{std::min(record.ttl, minimum)};
+                reader.seek(after);
+                break;
+            }
+            return response;
+        }
+
+        auto dns_numeric_address(std::string_view name) -> std::optional<ip_address> {
+            if (name.empty()) return {};
+            try {
+                if (name.find(':') != std::string_view::npos) return ipv6_address{std::string{name}};
+                if (std::ranges::all_of(name, [](char c) { return c == '.' or (c >= '0' and c <= '9'); })) {
+                    return ipv4_address{std::string{name}};
+                }
+            }
+            catch (const std::invalid_argument&) {}
+            return {};
+        }
+
+        struct dns_cache::shard {
+            struct key {
+                std::string name;
+                dns_record_type type;
+
+                friend auto operator== (const key&, const key&) -> bool = default;
+            };
+
+            struct key_hash {
+                auto operator() (const key& k) const noexcept -> std::size_t {
+                    return std::hash<std::string>{}(k.name) ^ static_cast<std::size_t>(k.type);
+                }
+            };
+
+            struct entry {
+                dns_answer answer;
+                std::error_code error;
+                clock::time_point expiry;
+            };
+
+            std::mutex mtx;
+            std::unordered_map<key, entry, key_hash> entries;
+            std::unordered_map<key, std::shared_ptr<dns_flight>, key_hash> flights;
+        };
+
+        dns_cache::dns_cache(std::size_t shard_count, std::size_t capacity) :
+            shards_(std::make_unique<shard[]>(std::max<std::size_t>(shard_count, 1))),
+            shard_count_(std::max<std::size_t>(shard_count, 1)),
+            shard_capacity_(std::max<std::size_t>(capacity / std::max<std::size_t>(shard_count, 1), 1)) {}
+
+        dns_cache::~dns_cache() = default;
+
+        auto dns_cache::shard_of(const std::string& name, dns_record_type type) const noexcept -> shard& {
+            return shards_[shard::key_hash{}(shard::key{name, type}) % shard_count_];
+        }
+
+        auto dns_cache::probe(const std::string& name, dns_record_type type, clock::time_point now) -> probe_result {
+            auto& part = shard_of(name, type);
+            shard::key key{name, type};
+            probe_result result;
+            std::scoped_lock _{part.mtx};
+            if (const auto it = part.entries.find(key); it != part.entries.end()) {
+                if (it->second.expiry > now) {
+                    result.hit = true;
+                    result.answer = it->second.answer;
+                    result.error = it->second.error;
+                    return result;
+                }
+                part.entries.erase(it);
+            }
+            auto& flight = part.flights[std::move(key)];
+            result.leader = flight == nullptr;
+            if (result.leader) flight = std::make_shared<dns_flight>();
+            result.flight = flight;
+            return result;
+        }
+
+        auto dns_cache::settle(
+            const std::string& name,
+            dns_record_type type,
+            const std::shared_ptr<dns_flight>& flight,
+            dns_answer answer,
+            std::error_code error,
+            std::optional<clock::time_point> expiry
+        ) noexcept -> void {
+            auto& part = shard_of(name, type);
+            try {
+                shard::key key{name, type};
+                std::scoped_lock _{part.mtx};
+                if (const auto it = part.flights.find(key); it != part.flights.end() and it->second == flight) {
+                    part.flights.erase(it);
+                }
+                const auto now = clock::now();
+                if (expiry and *expiry > now) {
+                    if (part.entries.size() >= shard_capacity_ and not part.entries.contains(key)) {
+                        std::erase_if(part.entries, [now](const auto& item) { return item.second.expiry <= now; });
+                        if (part.entries.size() >= shard_capacity_) part.entries.erase(part.entries.begin());
+                    }
+                    part.entries.insert_or_assign(std::move(key), shard::entry{answer, error, *expiry});
+                }
+            }
+            catch (...) {} // caching is best effort, the waiters get the outcome regardless
+            flight->answer = std::move(answer);
+            flight->error = error;
+            flight->done.count_down();
+        }
+
+        auto dns_cache::clear() -> void {
+            for (std::size_t i = 0; i < shard_count_; ++i) {
+                std::scoped_lock _{shards_[i].mtx};
+                shards_[i].entries.clear();
+            }
+        }
+
+        auto dns_cache::size() const -> std::size_t {
+            std::size_t result = 0;
+            for (std::size_t i = 0; i < shard_count_; ++i) {
+                std::scoped_lock _{shards_[i].mtx};
+                result += shards_[i].entries.size();
+            }
+            return result;
+        }
+
+        dns_resolver_state::dns_resolver_state(dns_config config) :
+            config_(std::move(config)),
+            cache_(config_.cache_shards, config_.cache_capacity),
+            id_state_((std::uint64_t{std::random_device{}()} << 32) | std::random_device{}()) {}
+
+        auto dns_resolver_state::next_id() -> std::uint16_t {
+            std::scoped_lock _{id_mtx_};
+            // splitmix64
+            std::uint64_t z = (id_state_ += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return static_cast<std::uint16_t>(z ^ (z >> 31));
+        }
+
+        auto dns_resolver_state::local_answer(const std::string& name, dns_record_type type) const -> std::optional<dns_answer> {
+            const auto wanted = [type](const ip_address& address) {
+                return address.is_v4() == (type == dns_record_type::a);
+            };
+            if (const auto numeric = dns_numeric_address(name)) {
+                dns_answer answer;
+                if (wanted(*numeric)) answer.addresses.push_back(*numeric);
+                return answer;
+            }
+            const auto [first, last] = config_.hosts.equal_range(name);
+            if (first == last) return {};
+            dns_answer answer;
+            for (auto it = first; it != last; ++it) {
+                if (wanted(it->second)) answer.addresses.push_back(it->second);
+            }
+            return answer;
+        }
+
+        auto dns_resolver_state::expiry_of(std::chrono::seconds ttl) const noexcept -> dns_cache::clock::time_point {
+            return dns_cache::clock::now() + std::min(ttl, config_.max_ttl);
+        }
+    }
+
+    auto dns_config::from_system() -> dns_config {
+        auto config = from_files("/etc/resolv.conf", "/etc/hosts");
+        if (config.name_servers.empty()) config.name_servers.emplace_back(ipv4_address::loopback(), 53);
+        return config;
+    }
+
+    auto dns_config::from_files(const std::filesystem::path& resolv_conf, const std::filesystem::path& hosts) -> dns_config {
+        dns_config config;
+        if (const auto text = detail::read_file(resolv_conf)) config.parse_resolv_conf(*text);
+        if (const auto text = detail::read_file(hosts)) config.parse_hosts(*text);
+        return config;
+    }
+
+    auto dns_config::parse_resolv_conf(std::string_view text) -> void {
+        detail::for_each_line(text, "#;", [this](std::span<const std::string_view> words) {
+            if (words[0] == "nameserver" and words.size() >= 2) {
+                // a scoped IPv6 address (`fe80::1%eth0`) can't be represented, skip it
+                if (const auto address = detail::dns_numeric_address(words[1])) {
+                    name_servers.push_back(address->is_v4() ? endpoint{address->v4(), 53} : endpoint{address->v6(), 53});
+                }
+            }
+            else if (words[0] == "options") {
+                for (const auto option : words.subspan(1)) {
+                    if (option.starts_with("timeout:")) {
+                        if (const auto n = detail::parse_unsigned(option.substr(8))) timeout = std::chrono::seconds{*n};
+                    }
+                    else if (option.starts_with("attempts:")) {
+                        if (const auto n = detail::parse_unsigned(option.substr(9))) attempts = *n;
+                    }
+                }
+            }
+        });
+    }
+
+    auto dns_config::parse_hosts(std::string_view text) -> void {
+        detail::for_each_line(text, "#", [this](std::span<const std::string_view> words) {
+            const auto address = detail::dns_numeric_address(words[0]);
+            if (not address) return;
+            for (const auto name : words.subspan(1)) hosts.emplace(detail::dns_normalize_name(name), *address);
+        });
+    }
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
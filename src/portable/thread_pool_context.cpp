@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <coio/thread_pool_context.h>
+
+namespace coio {
+    namespace {
+        // a busy worker looks at the injection queue and the timers once per this many operations,
+        // so work that isn't in its own deque can't starve
+        constexpr std::uint32_t fairness_interval = 61;
+
+        COIO_ALWAYS_INLINE auto next_random(std::uint32_t& seed) noexcept -> std::uint32_t {
+            // xorshift32
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            return seed;
+        }
+    }
+
+    thread_pool_context::thread_pool_context(std::size_t thread_count, std::pmr::memory_resource& resource) : loop_base(resource) {
+        if (thread_count == 0) {
+            thread_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        }
+        workers_ = std::make_unique<worker[]>(thread_count);
+        worker_count_ = thread_count;
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            workers_[i].pool = this;
+            workers_[i].seed = static_cast<std::uint32_t>(i) * 2654435761u + 1;
+        }
+        try {
+            for (std::size_t i = 0; i < thread_count; ++i) {
+                auto& self = workers_[i];
+                self.thread = std::thread{[this, &self] { work(self); }};
+            }
+        }
+        catch (...) {
+            stop_workers();
+            throw;
+        }
+    }
+
+    thread_pool_context::~thread_pool_context() {
+        stop_workers();
+    }
+
+    auto thread_pool_context::stop_workers() noexcept -> void {
+        stopping_.store(true);
+        for (std::size_t i = 0; i < worker_count_; ++i) {
+            static_cast<void>(wake(workers_[i]));
+        }
+        for (std::size_t i = 0; i < worker_count_; ++i) {
+            if (workers_[i].thread.joinable()) workers_[i].thread.join();
+        }
+    }
+
+    auto thread_pool_context::inject(node& op) noexcept -> void {
+        // counted first: a worker that sees the count but not yet the node retries instead of sleeping
+        injected_count_.fetch_add(1);
+        injected_.enqueue(op);
+    }
+
+    auto thread_pool_context::interrupt() -> void {
+        // called when a timer became the earliest, but also when the work count drops to zero:
+        // only wake the timer keeper if it would otherwise sleep past the new earliest timer
+        const auto earliest = timer_queue_.earliest();
+        if (not earliest) return;
+        if (auto keeper = timer_keeper_.load()) {
+            if (*earliest < keeper->deadline.load()) static_cast<void>(wake(*keeper));
+        }
+        else {
+            wake_one();
+        }
+    }
+
+    auto thread_pool_context::work(worker& self) -> void {
+        current_worker_ = &self;
+        const auto previous_pool = buffer_pool::set_current(&buffer_pool_);
+        while (true) {
+            if (node* op = next_op(self)) {
+                op->finish();
+                continue;
+            }
+            if (stopping_.load()) break;
+            sleep(self);
+        }
+        buffer_pool::set_current(previous_pool);
+        current_worker_ = nullptr;
+    }
+
+    auto thread_pool_context::next_op(worker& self) -> node* {
+        if (++self.tick % fairness_interval == 0) {
+            if (timer_keeper_.load(std::memory_order_relaxed) == nullptr) fire_timers();
+            if (node* op = take_injected()) return op;
+        }
+        if (node* op = self.queue.pop()) return op;
+        if (node* op = take_injected()) return op;
+        return steal(self);
+    }
+
+    auto thread_pool_context::take_injected() noexcept -> node* {
+        if (injected_count_.load(std::memory_order_relaxed) == 0) return nullptr;
+        std::unique_lock lock{injected_mtx_, std::try_to_lock};
+        if (not lock) return nullptr; // another worker is taking one, `has_work` keeps this one awake
+        node* op = injected_.dequeue();
+        if (op) injected_count_.fetch_sub(1);
+        return op;
+    }
+
+    auto thread_pool_context::steal(worker& self) noexcept -> node* {
+        const std::size_t start = next_random(self.seed) % worker_count_;
+        for (std::size_t i = 0; i < worker_count_; ++i) {
+            auto& victim = workers_[(start + i) % worker_count_];
+            if (&victim == &self) continue;
+            if (node* op = victim.queue.steal()) return op;
+        }
+        return nullptr;
+    }
+
+    auto thread_pool_context::fire_timers() -> void {
+        detail::intrusive_list<node> ready_time_ops{&node::next_};
+        timer_queue_.take_ready_timers(ready_time_ops);
+        publish_pending(ready_time_ops.release());
+    }
+
+    auto thread_pool_context::has_work() const noexcept -> bool {
+        if (injected_count_.load() != 0) return true;
+        for (std::size_t i = 0; i < worker_count_; ++i) {
+            if (not workers_[i].queue.empty()) return true;
+        }
+        return false;
+    }
+
+    auto thread_pool_context::sleep(worker& self) -> void {
+        // the first worker to go idle keeps the timers: it sleeps until the earliest one, the others until woken
+        worker* no_keeper = nullptr;
+        const bool keeper = timer_keeper_.compare_exchange_strong(no_keeper, &self);
+        if (keeper) self.deadline.store(std::chrono::steady_clock::time_point::max());
+
+        // announce the sleep before the last look at the queues: a poster either sees it, or its work is seen here
+        self.sleeping.store(true);
+        idle_count_.fetch_add(1);
+        if (has_work() or stopping_.load()) {
+            cancel_sleep(self);
+        }
+        else if (const auto deadline = keeper ? timer_queue_.earliest() : std::nullopt) {
+            self.deadline.store(*deadline);
+            if (not self.sema.try_acquire_until(*deadline)) cancel_sleep(self);
+        }
+        else {
+            self.sema.acquire();
+        }
+
+        if (keeper) {
+            timer_keeper_.store(nullptr);
+            fire_timers();
+            // this worker may stay busy for a while, hand the remaining timers to an idle one
+            if (timer_queue_.earliest()) wake_one();
+        }
+    }
+
+    auto thread_pool_context::cancel_sleep(worker& self) noexcept -> void {
+        if (self.sleeping.exchange(false)) {
+            idle_count_.fetch_sub(1);
+        }
+        else {
+            self.sema.acquire(); // a waker got here first, take its token
+        }
+    }
+
+    auto thread_pool_context::wake(worker& target) noexcept -> bool {
+        if (not target.sleeping.load() or not target.sleeping.exchange(false)) return false;
+        idle_count_.fetch_sub(1);
+        target.sema.release();
+        return true;
+    }
+
+    auto thread_pool_context::wake_one() noexcept -> void {
+        const std::size_t start = next_wake_.fetch_add(1, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < worker_count_; ++i) {
+            if (wake(workers_[(start + i) % worker_count_])) return;
+        }
+    }
+}
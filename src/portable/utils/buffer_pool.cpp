@@ -0,0 +1,33 @@
+#include <coio/utils/buffer_pool.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio {
+    namespace {
+        // the default `frame_pool_resource` options suit coroutine frames; buffers run larger
+        constexpr frame_pool_resource::options buffer_options{
+            .max_block_size = 64 * 1024,
+            .slab_size = 512 * 1024
+        };
+
+        thread_local buffer_pool* current_pool = nullptr;
+    }
+
+    buffer_pool::buffer_pool() : frame_pool_resource(buffer_options) {}
+
+    buffer_pool::buffer_pool(std::pmr::memory_resource& upstream) : frame_pool_resource(buffer_options, upstream) {}
+
+    buffer_pool::buffer_pool(const options& opts, std::pmr::memory_resource& upstream) : frame_pool_resource(opts, upstream) {}
+
+    auto buffer_pool::current() noexcept -> buffer_pool& {
+        if (current_pool != nullptr) return *current_pool;
+        // never destroyed: buffers drawn from it may be freed during static destruction
+        static buffer_pool* const process_pool = new buffer_pool;
+        return *process_pool;
+    }
+
+    auto buffer_pool::set_current(buffer_pool* pool) noexcept -> buffer_pool* {
+        return std::exchange(current_pool, pool);
+    }
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
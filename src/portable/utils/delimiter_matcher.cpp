@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <coio/utils/delimiter_matcher.h>
+#include <coio/detail/byte_search.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio {
+    delimiter_matcher::delimiter_matcher(std::initializer_list<std::string_view> delimiters) :
+        delimiter_matcher(std::span{delimiters.begin(), delimiters.size()}) {}
+
+    delimiter_matcher::delimiter_matcher(std::span<const std::string_view> delimiters) {
+        std::size_t total = 0;
+        for (std::string_view d : delimiters) {
+            if (d.empty()) throw std::invalid_argument{"coio::delimiter_matcher: empty delimiter"};
+            total += d.size();
+        }
+        if (total > std::numeric_limits<std::uint32_t>::max()) throw std::invalid_argument{"coio::delimiter_matcher: delimiters too long"};
+
+        bytes_.reserve(total);
+        entries_.reserve(delimiters.size());
+        for (std::size_t i = 0; i < delimiters.size(); ++i) {
+            const std::string_view d = delimiters[i];
+            entries_.push_back({static_cast<std::uint32_t>(bytes_.size()), static_cast<std::uint32_t>(d.size()), static_cast<std::uint32_t>(i)});
+            bytes_.append(d);
+            max_length_ = std::max(max_length_, d.size());
+        }
+
+        const auto first_byte = [this](const entry& e) noexcept { return static_cast<unsigned char>(bytes_[e.offset]); };
+        std::ranges::stable_sort(entries_, [&](const entry& a, const entry& b) noexcept {
+            if (first_byte(a) != first_byte(b)) return first_byte(a) < first_byte(b);
+            return a.size > b.size;
+        });
+        for (const entry& e : entries_) ++groups_[first_byte(e) + 1];
+        for (std::size_t b = 0; b < 256; ++b) {
+            if (groups_[b + 1] != 0) first_bytes_.push_back(static_cast<char>(b));
+            groups_[b + 1] += groups_[b];
+        }
+    }
+
+    auto delimiter_matcher::find(std::span<const std::byte> data, std::size_t from) const noexcept -> std::optional<match> {
+        if (entries_.empty() or from >= data.size()) return std::nullopt;
+        const auto begin = reinterpret_cast<const char*>(data.data());
+        const auto end = begin + data.size();
+
+        if (entries_.size() == 1) {
+            const entry& only = entries_.front();
+            const std::string_view d = view(only);
+            const char* found = d.size() == 1 ? detail::find_byte(begin + from, end, d.front()) : detail::find_substring(begin + from, end, d);
+            if (found == end) return std::nullopt;
+            return match{static_cast<std::size_t>(found - begin), only.size, only.index};
+        }
+
+        // up to four first bytes are looked for with SIMD, more through the group table
+        const bool vectorized = first_bytes_.size() <= 4;
+        for (const char* p = begin + from; p != end; ++p) {
+            if (vectorized) {
+                p = detail::find_any_byte(p, end, first_bytes_);
+                if (p == end) break;
+            }
+            const auto b = static_cast<unsigned char>(*p);
+            const auto available = static_cast<std::size_t>(end - p);
+            for (std::uint32_t i = groups_[b]; i != groups_[b + 1]; ++i) {
+                const entry& e = entries_[i];
+                if (e.size <= available and std::memcmp(p, bytes_.data() + e.offset, e.size) == 0) {
+                    return match{static_cast<std::size_t>(p - begin), e.size, e.index};
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    auto delimiter_matcher::find(std::span<const std::span<const std::byte>> data, std::size_t from) const noexcept -> std::optional<match> {
+        if (entries_.empty()) return std::nullopt;
+        std::size_t base = 0;
+        for (std::size_t i = 0; i < data.size(); base += data[i].size(), ++i) {
+            const auto segment = data[i];
+            if (base + segment.size() <= from) continue;
+            const std::size_t local_from = from > base ? from - base : 0;
+            const auto found = find(segment, local_from);
+
+            // a delimiter running into the next segments starts in the last `max_length_ - 1` bytes; it wins
+            // over the one found within the segment if it starts earlier, or at the same place, being longer
+            const std::size_t tail = segment.size() > max_length_ - 1 ? segment.size() - (max_length_ - 1) : 0;
+            const std::size_t stop = found ? found->position + 1 : segment.size();
+            for (std::size_t p = std::max(local_from, tail); p < stop; ++p) {
+                const auto b = static_cast<unsigned char>(segment[p]);
+                for (std::uint32_t k = groups_[b]; k != groups_[b + 1]; ++k) {
+                    const entry& e = entries_[k];
+                    if (e.size > segment.size() - p and detail::starts_with_across(data, i, p, view(e))) {
+                        return match{base + p, e.size, e.index};
+                    }
+                }
+            }
+            if (found) return match{base + found->position, found->size, found->index};
+        }
+        return std::nullopt;
+    }
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <new>
+#include <unordered_set>
+#include <coio/utils/frame_pool_resource.h>
+#include <coio/detail/atomic_intrusive_stack.h>
+#include <coio/utils/scope_exit.h>
+#include <coio/detail/suppress_push.h> // IWYU pragma: keep
+
+namespace coio {
+    namespace {
+        constexpr std::size_t granule = alignof(std::max_align_t);
+        constexpr std::size_t min_slab_size = 4096;
+        constexpr std::size_t slab_header_size = 64; // blocks start a cache line into their slab
+
+        // up to 128 bytes, one class per granule; beyond, four per doubling: 160, 192, 224, 256, 320, ...
+        constexpr std::size_t linear_classes = 128 / granule;
+
+        COIO_ALWAYS_INLINE constexpr auto class_of(std::size_t bytes) noexcept -> std::size_t {
+            if (bytes <= 128) return bytes == 0 ? 0 : (bytes - 1) / granule;
+            const auto k = static_cast<std::size_t>(std::bit_width(bytes - 1)) - 1; // 2^k < bytes <= 2^(k+1)
+            return linear_classes + (k - 7) * 4 + ((bytes - 1 - (std::size_t{1} << k)) >> (k - 2));
+        }
+
+        COIO_ALWAYS_INLINE constexpr auto class_size(std::size_t size_class) noexcept -> std::size_t {
+            if (size_class < linear_classes) return (size_class + 1) * granule;
+            const std::size_t k = 7 + (size_class - linear_classes) / 4;
+            const std::size_t step = (size_class - linear_classes) % 4 + 1;
+            return (std::size_t{1} << k) + step * (std::size_t{1} << (k - 2));
+        }
+
+        static_assert(class_of(1) == 0 and class_of(16) == 0 and class_of(17) == 1 and class_of(128) == 7);
+        static_assert(class_of(129) == 8 and class_of(160) == 8 and class_of(161) == 9 and class_of(256) == 11);
+        static_assert(class_size(8) == 160 and class_size(11) == 256 and class_size(12) == 320);
+        static_assert(class_size(class_of(16 * 1024)) == 16 * 1024);
+
+        // only the thread owning the counter writes it; the others just read it
+        COIO_ALWAYS_INLINE auto bump(std::atomic<std::size_t>& counter) noexcept -> void {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        // the live resources, so a thread exiting doesn't hand its caches back to a destroyed one
+        struct live_resources {
+            std::mutex mtx;
+            std::unordered_set<std::uint64_t> ids;
+            std::uint64_t next_id = 1;
+        };
+
+        auto get_live_resources() -> live_resources& {
+            static live_resources instance;
+            return instance;
+        }
+    }
+
+    struct frame_pool_resource::slab_header {
+        thread_cache* owner;
+        slab_header* next;
+    };
+
+    static_assert(sizeof(void*) * 2 <= slab_header_size);
+
+    struct frame_pool_resource::thread_cache {
+        struct free_block {
+            free_block* next;
+        };
+
+        struct size_class {
+            free_block* free = nullptr;
+            std::byte* bump = nullptr; // the part of the current slab never handed out yet
+            std::byte* end = nullptr;
+        };
+
+        // blocks freed by other threads; apart from `classes`, which only the owner touches
+        struct alignas(64) return_list {
+            detail::atomic_intrusive_stack<free_block> blocks{&free_block::next};
+        };
+
+        explicit thread_cache(std::size_t class_count) :
+            classes(std::make_unique<size_class[]>(class_count)),
+            returned(std::make_unique<return_list[]>(class_count)) {}
+
+        std::unique_ptr<size_class[]> classes;
+        std::unique_ptr<return_list[]> returned;
+        std::atomic<std::size_t> allocations{0};
+        std::atomic<std::size_t> deallocations{0};
+        std::atomic<std::size_t> remote_deallocations{0};
+    };
+
+    // the caches of the calling thread, one per resource it has allocated from
+    struct frame_pool_resource::thread_registry {
+        struct entry {
+            std::uint64_t id;
+            frame_pool_resource* resource;
+            thread_cache* cache;
+        };
+
+        thread_registry() = default;
+
+        thread_registry(const thread_registry&) = delete;
+
+        ~thread_registry() {
+            this_thread_registry() = nullptr;
+            registry_closed = true;
+            auto& live = get_live_resources();
+            std::scoped_lock _{live.mtx};
+            for (const entry& e : entries) {
+                if (live.ids.contains(e.id)) e.resource->abandon(*e.cache);
+            }
+        }
+
+        auto operator= (const thread_registry&) -> thread_registry& = delete;
+
+        [[nodiscard]]
+        COIO_ALWAYS_INLINE auto find(std::uint64_t id) noexcept -> thread_cache* {
+            if (last.id == id) return last.cache;
+            for (const entry& e : entries) {
+                if (e.id == id) {
+                    last = e;
+                    return e.cache;
+                }
+            }
+            return nullptr;
+        }
+
+        std::vector<entry> entries;
+        entry last{0, nullptr, nullptr};
+        static thread_local bool registry_closed;
+    };
+
+    thread_local bool frame_pool_resource::thread_registry::registry_closed = false;
+
+    frame_pool_resource::frame_pool_resource() : frame_pool_resource(options{}) {}
+
+    frame_pool_resource::frame_pool_resource(std::pmr::memory_resource& upstream) : frame_pool_resource(options{}, upstream) {}
+
+    frame_pool_resource::frame_pool_resource(const options& opts, std::pmr::memory_resource& upstream) : upstream_(&upstream) {
+        slab_size_ = std::bit_ceil(std::max(opts.slab_size, min_slab_size));
+        max_block_size_ = std::clamp<std::size_t>(opts.max_block_size, granule, slab_size_ / 8);
+        class_count_ = class_of(max_block_size_) + 1;
+        max_block_size_ = class_size(class_count_ - 1);
+        auto& live = get_live_resources();
+        std::scoped_lock _{live.mtx};
+        id_ = live.next_id++;
+        live.ids.insert(id_);
+    }
+
+    frame_pool_resource::~frame_pool_resource() {
+        {
+            auto& live = get_live_resources();
+            std::scoped_lock _{live.mtx};
+            live.ids.erase(id_);
+        }
+        while (slabs_ != nullptr) {
+            slab_header* slab = std::exchange(slabs_, slabs_->next);
+            upstream_->deallocate(slab, slab_size_, slab_size_);
+        }
+        for (thread_cache* cache : caches_) delete cache;
+    }
+
+    auto frame_pool_resource::stats() const -> statistics {
+        statistics result;
+        std::scoped_lock _{mtx_};
+        for (const thread_cache* cache : caches_) {
+            result.allocations += cache->allocations.load(std::memory_order_relaxed);
+            result.deallocations += cache->deallocations.load(std::memory_order_relaxed);
+            result.remote_deallocations += cache->remote_deallocations.load(std::memory_order_relaxed);
+        }
+        result.upstream_allocations = upstream_allocations_.load(std::memory_order_relaxed);
+        result.slabs = slab_count_;
+        result.thread_caches = caches_.size();
+        return result;
+    }
+
+    auto frame_pool_resource::this_thread_registry() noexcept -> thread_registry*& {
+        thread_local thread_registry* registry = nullptr;
+        return registry;
+    }
+
+    auto frame_pool_resource::do_allocate(std::size_t bytes, std::size_t alignment) -> void* {
+        if (not pooled(bytes, alignment)) [[unlikely]] {
+            upstream_allocations_.fetch_add(1, std::memory_order_relaxed);
+            std::scoped_lock _{mtx_};
+            return upstream_->allocate(bytes, alignment);
+        }
+        if (thread_cache* cache = local_cache()) [[likely]] return allocate_from(*cache, bytes);
+
+        // the thread is exiting and has given its caches back: borrow one for this block
+        thread_cache& borrowed = take_cache();
+        scope_exit _{[&]() noexcept { abandon(borrowed); }};
+        return allocate_from(borrowed, bytes);
+    }
+
+    auto frame_pool_resource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) -> void {
+        if (not pooled(bytes, alignment)) [[unlikely]] {
+            std::scoped_lock _{mtx_};
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+        const auto slab = reinterpret_cast<slab_header*>(reinterpret_cast<std::uintptr_t>(p) & ~(slab_size_ - 1));
+        thread_cache* owner = slab->owner;
+        const std::size_t size_class = class_of(bytes);
+        auto block = ::new(p) thread_cache::free_block{nullptr};
+        if (thread_registry* registry = this_thread_registry(); registry != nullptr and registry->find(id_) == owner) {
+            block->next = std::exchange(owner->classes[size_class].free, block);
+            bump(owner->deallocations);
+        }
+        else {
+            static_cast<void>(owner->returned[size_class].blocks.push(*block));
+            owner->remote_deallocations.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    auto frame_pool_resource::allocate_from(thread_cache& cache, std::size_t bytes) -> void* {
+        const std::size_t size_class = class_of(bytes);
+        auto& slot = cache.classes[size_class];
+        if (slot.free == nullptr) {
+            // take over what other threads gave back, all at once
+            if (auto& returned = cache.returned[size_class].blocks; not returned.empty()) slot.free = returned.pop_all();
+        }
+        void* result;
+        if (slot.free != nullptr) {
+            result = std::exchange(slot.free, slot.free->next);
+        }
+        else if (slot.bump != slot.end) {
+            result = std::exchange(slot.bump, slot.bump + class_size(size_class));
+        }
+        else {
+            result = refill(cache, size_class);
+        }
+        bump(cache.allocations);
+        return result;
+    }
+
+    // the calling thread's cache, adopting an idle one or creating one if it has none;
+    // null if the thread is exiting and has given its caches back
+    auto frame_pool_resource::local_cache() -> thread_cache* {
+        thread_registry* registry = this_thread_registry();
+        if (registry != nullptr) {
+            if (thread_cache* cache = registry->find(id_)) [[likely]] return cache;
+        }
+        else if (thread_registry::registry_closed) {
+            return nullptr;
+        }
+        else {
+            thread_local thread_registry instance;
+            registry = this_thread_registry() = &instance;
+        }
+
+        thread_cache& cache = take_cache();
+        {
+            // forget the resources destroyed since, their ids are never reused
+            auto& live = get_live_resources();
+            std::scoped_lock _{live.mtx};
+            std::erase_if(registry->entries, [&](const thread_registry::entry& e) { return not live.ids.contains(e.id); });
+        }
+        try {
+            registry->entries.push_back({id_, this, &cache});
+        }
+        catch (...) {
+            abandon(cache);
+            throw;
+        }
+        registry->last = registry->entries.back();
+        return &cache;
+    }
+
+    auto frame_pool_resource::take_cache() -> thread_cache& {
+        std::scoped_lock _{mtx_};
+        if (not idle_caches_.empty()) {
+            thread_cache* cache = idle_caches_.back();
+            idle_caches_.pop_back();
+            return *cache;
+        }
+        caches_.reserve(caches_.size() + 1);
+        idle_caches_.reserve(caches_.size() + 1); // so that `abandon` can't fail
+        auto cache = std::make_unique<thread_cache>(class_count_);
+        caches_.push_back(cache.get());
+        return *cache.release();
+    }
+
+    auto frame_pool_resource::refill(thread_cache& cache, std::size_t size_class) -> void* {
+        void* memory;
+        {
+            std::scoped_lock _{mtx_};
+            memory = upstream_->allocate(slab_size_, slab_size_);
+            slabs_ = ::new(memory) slab_header{&cache, slabs_};
+            ++slab_count_;
+        }
+        auto& slot = cache.classes[size_class];
+        const std::size_t block_size = class_size(size_class);
+        std::byte* first = static_cast<std::byte*>(memory) + slab_header_size;
+        slot.bump = first + block_size;
+        slot.end = first + (slab_size_ - slab_header_size) / block_size * block_size;
+        return first;
+    }
+
+    auto frame_pool_resource::abandon(thread_cache& cache) noexcept -> void {
+        std::scoped_lock _{mtx_};
+        idle_caches_.push_back(&cache); // within the capacity reserved when `cache` was created
+    }
+}
+
+#include <coio/detail/suppress_pop.h> // IWYU pragma: keep
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <bit>
 #include <coio/asyncio/file.h>
 #include <coio/utils/scope_exit.h>
@@ -16,6 +17,7 @@ namespace coio::detail {
             if (random_access) flags |= FILE_FLAG_RANDOM_ACCESS;
             else flags |= FILE_FLAG_SEQUENTIAL_SCAN;
             if (bool(mode & open_mode::sync_all_on_write)) flags |= FILE_FLAG_WRITE_THROUGH;
+            if (bool(mode & open_mode::direct)) flags |= FILE_FLAG_NO_BUFFERING;
             return {access, flags};
         }
 
@@ -167,6 +169,18 @@ namespace coio::detail {
         return static_cast<std::size_t>(sz.QuadPart);
     }
 
+    auto file_direct_io_alignment(file_native_handle_type handle) -> std::size_t {
+        if (handle == invalid_file_handle) {
+            throw std::system_error{std::make_error_code(std::errc::bad_file_descriptor), "direct_io_alignment"};
+        }
+        ::FILE_STORAGE_INFO info{};
+        if (not ::GetFileInformationByHandleEx(handle, ::FileStorageInfo, &info, sizeof(info))) {
+            throw std::system_error(to_error_code(::GetLastError()), "direct_io_alignment");
+        }
+        // unbuffered I/O must be aligned to the logical sector size, the physical one avoids read-modify-write cycles
+        return std::bit_ceil(std::max<std::size_t>(info.PhysicalBytesPerSectorForPerformance, info.LogicalBytesPerSector));
+    }
+
     auto file_sync_all(file_native_handle_type handle) -> void {
         if (handle == invalid_file_handle) {
             throw std::system_error{std::make_error_code(std::errc::bad_file_descriptor), "sync_all"};
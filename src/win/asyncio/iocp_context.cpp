@@ -255,8 +255,10 @@ namespace coio {
                 return true;
             }
 
-            long long timeout = infinite ? INFINITE : 0;
-            if (infinite) {
+            // a spent drain budget with ready operations left only peeks at the completions
+            const bool wait = infinite and not poll_due();
+            long long timeout = wait ? INFINITE : 0;
+            if (wait) {
                 if (const auto earliest = timer_queue_.earliest()) {
                     const auto duration = *earliest - std::chrono::steady_clock::now();
                     auto ms = std::chrono::ceil<std::chrono::milliseconds>(duration).count();
@@ -302,6 +304,7 @@ namespace coio {
 
             publish_pending(ready_time_ops.release());
             publish_pending(ready_io_ops.release());
+            polled();
 
             if (not infinite) {
                 return consume();
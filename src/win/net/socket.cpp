@@ -148,6 +148,10 @@ namespace coio::detail::socket {
         return IPPROTO_TCP;
     }
 
+    auto ipproto_udp_v() noexcept -> int {
+        return IPPROTO_UDP;
+    }
+
     auto sock_option_traits<::linger>::from_value(const ::linger& value) noexcept -> linger_storage {
         return std::bit_cast<linger_storage>(value);
     }
@@ -0,0 +1,21 @@
+#include <climits>
+#include <coio/detail/thread_affinity.h>
+#include "../common.h"
+
+namespace coio::detail {
+    // only the processor group the process runs in is considered
+    auto allowed_cpus() -> std::vector<unsigned> {
+        DWORD_PTR process_mask = 0;
+        DWORD_PTR system_mask = 0;
+        throw_win_error(::GetProcessAffinityMask(::GetCurrentProcess(), &process_mask, &system_mask), "GetProcessAffinityMask");
+        std::vector<unsigned> cpus;
+        for (unsigned cpu = 0; cpu < sizeof(DWORD_PTR) * CHAR_BIT; ++cpu) {
+            if (process_mask & (DWORD_PTR{1} << cpu)) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    auto pin_thread(std::thread::native_handle_type thread, unsigned cpu) -> void {
+        throw_win_error(::SetThreadAffinityMask(thread, DWORD_PTR{1} << cpu) != 0, "SetThreadAffinityMask");
+    }
+}
@@ -0,0 +1,95 @@
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <doctest/doctest.h>
+#include <coio/core.h>
+#include <coio/thread_pool_context.h>
+#include <coio/utils/buffer_pool.h>
+#include <coio/utils/flat_buffer.h>
+#include <coio/utils/streambuf.h>
+
+TEST_CASE("buffer_pool: a lease gives its block back for the next one") {
+    coio::buffer_pool pool;
+    std::byte* first = nullptr;
+    {
+        auto lease = pool.lease(1000);
+        REQUIRE_EQ(lease.size(), 1000);
+        CHECK_EQ(lease.pool(), &pool);
+        first = lease.data();
+        std::memset(lease.bytes().data(), 0x2a, lease.size());
+
+        auto moved = std::move(lease);
+        CHECK(lease.empty());
+        CHECK_EQ(lease.pool(), nullptr);
+        CHECK_EQ(moved.data(), first);
+    }
+    auto again = pool.lease(1000);
+    CHECK_EQ(again.data(), first);
+    again.reset();
+    CHECK(again.empty());
+
+    auto large = pool.lease(1 << 20); // beyond the largest size class
+    CHECK_EQ(large.size(), 1 << 20);
+    large.reset();
+
+    const auto stats = pool.stats();
+    CHECK_EQ(stats.allocations, 2);
+    CHECK_EQ(stats.deallocations, 2);
+    CHECK_EQ(stats.upstream_allocations, 1);
+}
+
+TEST_CASE("buffer_pool: a context's pool is current on the threads running it") {
+    coio::thread_pool_context context{1};
+    auto scheduler = context.get_scheduler();
+    CHECK_EQ(&coio::get_buffer_pool(scheduler), &context.get_buffer_pool());
+    CHECK_NE(&coio::buffer_pool::current(), &context.get_buffer_pool());
+
+    auto result = coio::this_thread::sync_wait(coio::starts_on(scheduler, coio::just() | coio::then([] {
+        return &coio::buffer_pool::current();
+    })));
+    REQUIRE(result.has_value());
+    CHECK_EQ(std::get<0>(*result), &context.get_buffer_pool());
+}
+
+TEST_CASE("buffer_pool: pooled buffers allocate nothing new once the pool has warmed up") {
+    coio::thread_pool_context context{1};
+    auto& pool = context.get_buffer_pool();
+
+    const auto handle_request = [&pool] {
+        coio::pooled_flat_buffer buffer;
+        CHECK_EQ(&buffer.get_allocator().pool(), &pool);
+        const std::string request = "GET / HTTP/1.1\r\n\r\n";
+        for (int i = 0; i < 100; ++i) { // grows the buffer through several size classes
+            auto target = buffer.prepare(request.size());
+            std::memcpy(target.data(), request.data(), request.size());
+            buffer.commit(request.size());
+        }
+
+        coio::pooled_streambuf response;
+        std::ostream{&response} << "HTTP/1.1 200 OK\r\nContent-Length: " << buffer.size() << "\r\n\r\n";
+        return response.size();
+    };
+
+    const auto serve = [&](int requests) {
+        auto result = coio::this_thread::sync_wait(coio::starts_on(context.get_scheduler(), coio::just() | coio::then([=] {
+            for (int i = 0; i < requests; ++i) static_cast<void>(handle_request());
+        })));
+        REQUIRE(result.has_value());
+    };
+
+    serve(1);
+    const auto warm = pool.stats();
+    CHECK_GT(warm.allocations, 0);
+    CHECK_EQ(warm.allocations, warm.deallocations + warm.remote_deallocations);
+
+    serve(1000);
+    const auto steady = pool.stats();
+    CHECK_EQ(steady.slabs, warm.slabs);
+    CHECK_EQ(steady.upstream_allocations, 0);
+    CHECK_EQ(steady.thread_caches, 1);
+    CHECK_EQ(steady.allocations, steady.deallocations + steady.remote_deallocations);
+}
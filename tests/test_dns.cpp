@@ -0,0 +1,553 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <doctest/doctest.h>
+#include <coio/core.h>
+#include <coio/asyncio/io.h>
+#include <coio/detail/config.h>
+#include <coio/detail/error.h>
+#include <coio/net/basic.h>
+#include <coio/net/dns.h>
+#include <coio/net/tcp.h>
+#include <coio/net/udp.h>
+
+#if COIO_OS_LINUX
+#include <coio/asyncio/epoll_context.h>
+#if COIO_HAS_IO_URING
+#include <coio/asyncio/uring_context.h>
+#endif
+#elif COIO_OS_WINDOWS
+#include <coio/asyncio/iocp_context.h>
+#endif
+
+// Register readable type names so templated test-case names embed the context type
+// (needed for doctest's --test-case-exclude, e.g. excluding "*uring_context*" under TSan).
+#if COIO_OS_LINUX
+TYPE_TO_STRING(coio::epoll_context);
+#if COIO_HAS_IO_URING
+TYPE_TO_STRING(coio::uring_context);
+#endif
+#elif COIO_OS_WINDOWS
+TYPE_TO_STRING(coio::iocp_context);
+#endif
+
+#if COIO_OS_LINUX and COIO_HAS_IO_URING
+#define COIO_TEST_CONTEXTS coio::epoll_context, coio::uring_context
+#elif COIO_OS_LINUX
+#define COIO_TEST_CONTEXTS coio::epoll_context
+#else
+#define COIO_TEST_CONTEXTS coio::iocp_context
+#endif
+
+using namespace std::chrono_literals;
+
+namespace {
+    using coio::detail::dns_record_type;
+
+    template<typename Context>
+    auto try_make_context(std::optional<Context>& context) -> bool {
+        try {
+            context.emplace();
+            return true;
+        }
+        catch (const std::system_error& e) {
+            MESSAGE("skipping: cannot construct context: " << e.what());
+            return false;
+        }
+    }
+
+    template<typename Context>
+    auto drive(Context& context) -> coio::task<> {
+        context.run();
+        co_return;
+    }
+
+    // --- a minimal authoritative server's message builder -------------------
+
+    auto put16(std::vector<std::byte>& out, std::uint16_t value) -> void {
+        out.push_back(static_cast<std::byte>(value >> 8));
+        out.push_back(static_cast<std::byte>(value & 0xff));
+    }
+
+    auto put32(std::vector<std::byte>& out, std::uint32_t value) -> void {
+        put16(out, static_cast<std::uint16_t>(value >> 16));
+        put16(out, static_cast<std::uint16_t>(value & 0xffff));
+    }
+
+    auto put_name(std::vector<std::byte>& out, std::string_view name) -> void {
+        while (not name.empty()) {
+            const auto dot = name.find('.');
+            const auto label = name.substr(0, dot);
+            out.push_back(static_cast<std::byte>(label.size()));
+            for (const char c : label) out.push_back(static_cast<std::byte>(c));
+            name = dot == std::string_view::npos ? std::string_view{} : name.substr(dot + 1);
+        }
+        out.push_back(std::byte{0});
+    }
+
+    struct question {
+        std::uint16_t id;
+        dns_record_type type;
+        std::size_t end; // one past the question section
+    };
+
+    auto read_question(std::span<const std::byte> query) -> question {
+        REQUIRE_GE(query.size(), 12 + 5);
+        std::size_t pos = 12;
+        while (query[pos] != std::byte{0}) pos += 1 + std::to_integer<std::size_t>(query[pos]);
+        ++pos;
+        const auto at = [&](std::size_t i) { return std::to_integer<std::uint16_t>(query[i]); };
+        return {
+            static_cast<std::uint16_t>(at(0) << 8 | at(1)),
+            static_cast<dns_record_type>(at(pos) << 8 | at(pos + 1)),
+            pos + 4
+        };
+    }
+
+    struct record {
+        std::string owner; // empty: the question's name, as a compression pointer
+        dns_record_type type;
+        std::uint32_t ttl;
+        std::vector<std::byte> rdata;
+    };
+
+    auto a_record(std::string owner, std::uint8_t last, std::uint32_t ttl = 300) -> record {
+        return {std::move(owner), dns_record_type::a, ttl, {std::byte{192}, std::byte{0}, std::byte{2}, std::byte{last}}};
+    }
+
+    auto aaaa_record(std::string owner, std::uint8_t last, std::uint32_t ttl = 300) -> record {
+        std::vector<std::byte> rdata(16);
+        rdata[0] = std::byte{0x20};
+        rdata[1] = std::byte{0x01};
+        rdata[2] = std::byte{0x0d};
+        rdata[3] = std::byte{0xb8};
+        rdata[15] = std::byte{last};
+        return {std::move(owner), dns_record_type::aaaa, ttl, std::move(rdata)};
+    }
+
+    auto cname_record(std::string owner, std::string_view target, std::uint32_t ttl = 300) -> record {
+        std::vector<std::byte> rdata;
+        put_name(rdata, target);
+        return {std::move(owner), dns_record_type::cname, ttl, std::move(rdata)};
+    }
+
+    auto soa_record(std::uint32_t ttl, std::uint32_t minimum) -> record {
+        std::vector<std::byte> rdata;
+        put_name(rdata, "ns.example.test");
+        put_name(rdata, "hostmaster.example.test");
+        for (int i = 0; i < 4; ++i) put32(rdata, 1);
+        put32(rdata, minimum);
+        return {"example.test", dns_record_type::soa, ttl, std::move(rdata)};
+    }
+
+    auto make_response(
+        std::span<const std::byte> query,
+        std::uint8_t rcode,
+        const std::vector<record>& answers,
+        const std::vector<record>& authority = {},
+        bool truncated = false
+    ) -> std::vector<std::byte> {
+        const auto q = read_question(query);
+        std::vector<std::byte> out;
+        put16(out, q.id);
+        put16(out, static_cast<std::uint16_t>(0x8180 | (truncated ? 0x0200 : 0) | rcode)); // QR, RD, RA
+        put16(out, 1);
+        put16(out, truncated ? 0 : static_cast<std::uint16_t>(answers.size()));
+        put16(out, truncated ? 0 : static_cast<std::uint16_t>(authority.size()));
+        put16(out, 0);
+        out.insert(out.end(), query.begin() + 12, query.begin() + static_cast<std::ptrdiff_t>(q.end));
+        if (truncated) return out;
+        for (const auto* section : {&answers, &authority}) {
+            for (const record& r : *section) {
+                if (r.owner.empty()) put16(out, 0xc00c); // the question's name
+                else put_name(out, r.owner);
+                put16(out, static_cast<std::uint16_t>(r.type));
+                put16(out, 1);
+                put32(out, r.ttl);
+                put16(out, static_cast<std::uint16_t>(r.rdata.size()));
+                out.insert(out.end(), r.rdata.begin(), r.rdata.end());
+            }
+        }
+        return out;
+    }
+
+    auto v4(std::uint8_t last) -> coio::ip_address {
+        return coio::ipv4_address{192, 0, 2, last};
+    }
+
+    // --- stub name servers -----------------------------------------------------
+
+    struct server_log {
+        int a_queries = 0;
+        int aaaa_queries = 0;
+        int tcp_queries = 0;
+    };
+
+    // answers `count` queries, after leaving the first `ignored` unanswered: A with 192.0.2.1, AAAA with 2001:db8::1,
+    // or NXDOMAIN for "missing.test"
+    template<typename Scheduler>
+    auto udp_name_server(coio::udp::socket<Scheduler>& socket, int count, server_log& log, bool truncate = false, int ignored = 0) -> coio::task<> {
+        std::byte buffer[512];
+        for (int i = 0; i < ignored + count; ++i) {
+            auto [peer, size] = co_await socket.async_receive_from(buffer);
+            const std::span query{buffer, size};
+            const auto q = read_question(query);
+            (q.type == dns_record_type::a ? log.a_queries : log.aaaa_queries) += 1;
+            if (i < ignored) continue;
+            const bool missing = std::string_view{reinterpret_cast<const char*>(buffer + 13), 7} == "missing";
+            std::vector<std::byte> response;
+            if (missing) response = make_response(query, 3, {}, {soa_record(600, 60)});
+            else if (q.type == dns_record_type::a) response = make_response(query, 0, {a_record("", 1)}, {}, truncate);
+            else response = make_response(query, 0, {aaaa_record("", 1)}, {}, truncate);
+            static_cast<void>(co_await socket.async_send_to(response, peer));
+        }
+    }
+
+    // answers one length-prefixed query with two A records
+    template<typename Scheduler>
+    auto tcp_name_server(coio::tcp::acceptor<Scheduler>& acceptor, server_log& log) -> coio::task<> {
+        auto peer = co_await acceptor.async_accept();
+        std::byte length[2];
+        auto [length_ec, length_n] = co_await coio::async_read(peer, std::span<std::byte>{length});
+        REQUIRE_FALSE(length_ec);
+        REQUIRE_EQ(length_n, 2);
+        std::vector<std::byte> query((std::to_integer<std::size_t>(length[0]) << 8) | std::to_integer<std::size_t>(length[1]));
+        auto [query_ec, query_n] = co_await coio::async_read(peer, std::span<std::byte>{query});
+        REQUIRE_FALSE(query_ec);
+        CHECK_EQ(query_n, query.size());
+        ++log.tcp_queries;
+        const auto body = make_response(query, 0, {a_record("", 1), a_record("", 2)});
+        std::vector<std::byte> framed;
+        put16(framed, static_cast<std::uint16_t>(body.size()));
+        framed.insert(framed.end(), body.begin(), body.end());
+        auto [write_ec, written] = co_await coio::async_write(peer, std::span<const std::byte>{framed});
+        CHECK_FALSE(write_ec);
+        CHECK_EQ(written, framed.size());
+    }
+
+    auto test_config(const coio::endpoint& server) -> coio::dns_config {
+        coio::dns_config config;
+        config.name_servers.push_back(server);
+        config.timeout = 2s;
+        config.attempts = 1;
+        return config;
+    }
+
+    template<typename Resolver>
+    auto resolve_twice_concurrently(Resolver& resolver, std::vector<coio::resolve_result_t>& first, std::vector<coio::resolve_result_t>& second) -> coio::task<> {
+        co_await coio::when_all(
+            resolver.async_resolve("WWW.Example.Test.", 80) | coio::then([&](auto results) { first = std::move(results); }),
+            resolver.async_resolve("www.example.test", 80) | coio::then([&](auto results) { second = std::move(results); })
+        );
+    }
+
+    // a lookup stopped while another one for the same name waits on its query
+    template<typename Resolver, typename Scheduler>
+    auto stop_leader_keep_follower(Resolver& resolver, Scheduler scheduler, std::vector<coio::resolve_result_t>& follower) -> coio::task<> {
+        int winner = 0;
+        co_await coio::when_all(
+            coio::when_any(
+                resolver.async_resolve("www.example.test", 80) | coio::then([](auto) { return 1; }),
+                scheduler.schedule_after(50ms) | coio::then([] { return 2; })
+            ) | coio::then([&winner](int w) { winner = w; }),
+            resolver.async_resolve("www.example.test", 80) | coio::then([&](auto results) { follower = std::move(results); })
+        );
+        CHECK_EQ(winner, 2);
+    }
+
+    template<typename Resolver>
+    auto resolve_error(Resolver& resolver, std::string name) -> coio::task<std::error_code> {
+        try {
+            static_cast<void>(co_await resolver.async_resolve(std::move(name)));
+        }
+        catch (const std::system_error& e) {
+            co_return e.code();
+        }
+        co_return std::error_code{};
+    }
+}
+
+TEST_CASE("dns: queries are encoded label by label with recursion desired") {
+    const auto query = coio::detail::dns_encode_query(0xbeef, coio::detail::dns_normalize_name("WWW.Example.com."), dns_record_type::aaaa);
+    std::vector<std::byte> expected;
+    put16(expected, 0xbeef);
+    put16(expected, 0x0100);
+    put16(expected, 1);
+    put16(expected, 0);
+    put16(expected, 0);
+    put16(expected, 0);
+    put_name(expected, "www.example.com");
+    put16(expected, 28);
+    put16(expected, 1);
+    CHECK(query == expected);
+    CHECK_EQ(coio::detail::dns_message_id(query), 0xbeef);
+
+    for (const std::string_view invalid : {"", "a..b", ".leading", "trailing.."}) {
+        CHECK_THROWS_AS(static_cast<void>(coio::detail::dns_encode_query(1, invalid, dns_record_type::a)), std::system_error);
+    }
+    CHECK_THROWS_AS(static_cast<void>(coio::detail::dns_encode_query(1, std::string(64, 'a'), dns_record_type::a)), std::system_error);
+}
+
+TEST_CASE("dns: responses are decoded along the CNAME chain with the smallest TTL") {
+    const auto query = coio::detail::dns_encode_query(7, "www.example.test", dns_record_type::a);
+    // the chain comes out of order, and unrelated records are ignored
+    const auto message = make_response(query, 0, {
+        a_record("edge.cdn.test", 1, 120),
+        cname_record("", "edge.cdn.test", 600),
+        a_record("unrelated.test", 9),
+        a_record("EDGE.cdn.test", 2, 900),
+    });
+    const auto response = coio::detail::dns_parse_response(message, "www.example.test", dns_record_type::a);
+    CHECK_FALSE(response.truncated);
+    CHECK_EQ(response.rcode, 0);
+    CHECK(response.answer.addresses == std::vector<coio::ip_address>{v4(1), v4(2)});
+    CHECK_EQ(response.answer.canonical_name, "edge.cdn.test");
+    CHECK_EQ(response.answer.ttl, 120s);
+
+    const auto v6_query = coio::detail::dns_encode_query(8, "www.example.test", dns_record_type::aaaa);
+    const auto v6 = coio::detail::dns_parse_response(make_response(v6_query, 0, {aaaa_record("", 1)}), "www.example.test", dns_record_type::aaaa);
+    REQUIRE_EQ(v6.answer.addresses.size(), 1);
+    CHECK_EQ(v6.answer.addresses[0], coio::ip_address{coio::ipv6_address{"2001:db8::1"}});
+}
+
+TEST_CASE("dns: negative answers carry the SOA's negative TTL") {
+    const auto query = coio::detail::dns_encode_query(7, "missing.example.test", dns_record_type::a);
+    const auto nxdomain = coio::detail::dns_parse_response(
+        make_response(query, 3, {}, {soa_record(600, 60)}), "missing.example.test", dns_record_type::a
+    );
+    CHECK_EQ(nxdomain.rcode, 3);
+    CHECK(nxdomain.answer.addresses.empty());
+    CHECK_EQ(nxdomain.negative_ttl, 60s);
+
+    const auto no_data = coio::detail::dns_parse_response(make_response(query, 0, {}), "missing.example.test", dns_record_type::a);
+    CHECK_EQ(no_data.rcode, 0);
+    CHECK_FALSE(no_data.negative_ttl.has_value());
+}
+
+TEST_CASE("dns: malformed or mismatched responses are rejected") {
+    const auto query = coio::detail::dns_encode_query(7, "www.example.test", dns_record_type::a);
+    const auto message = make_response(query, 0, {a_record("", 1)});
+    const auto parse = [](std::span<const std::byte> bytes, std::string_view name) {
+        static_cast<void>(coio::detail::dns_parse_response(bytes, name, dns_record_type::a));
+    };
+
+    CHECK_NOTHROW(parse(message, "www.example.test"));
+    CHECK_THROWS_AS(parse(std::span{message}.first(message.size() - 1), "www.example.test"), std::system_error);
+    CHECK_THROWS_AS(parse(message, "other.example.test"), std::system_error); // not our question
+    CHECK_THROWS_AS(parse(query, "www.example.test"), std::system_error);     // a query, not a response
+
+    auto looping = message;
+    looping[12] = std::byte{0xc0}; // the question's name points at itself
+    looping[13] = std::byte{0x0c};
+    try {
+        parse(looping, "www.example.test");
+        FAIL("expected a malformed response");
+    }
+    catch (const std::system_error& e) {
+        CHECK_EQ(e.code(), coio::error::dns_errc::malformed_response);
+    }
+
+    auto unquestioned = message; // answers to no question at all
+    unquestioned[5] = std::byte{0};
+    unquestioned.erase(unquestioned.begin() + 12, unquestioned.begin() + static_cast<std::ptrdiff_t>(read_question(query).end));
+    CHECK_THROWS_AS(parse(unquestioned, "www.example.test"), std::system_error);
+
+    auto truncated = make_response(query, 0, {}, {}, true);
+    CHECK(coio::detail::dns_parse_response(truncated, "www.example.test", dns_record_type::a).truncated);
+}
+
+TEST_CASE("dns: resolv.conf and hosts are parsed") {
+    coio::dns_config config;
+    config.parse_resolv_conf(
+        "# comment\n"
+        "search example.test\n"
+        "nameserver 192.0.2.53\n"
+        "nameserver 2001:db8::53 ; trailing comment\n"
+        "nameserver fe80::1%eth0\n"
+        "options ndots:2 timeout:3 attempts:4\n"
+    );
+    REQUIRE_EQ(config.name_servers.size(), 2);
+    CHECK(config.name_servers[0] == coio::endpoint{coio::ipv4_address{192, 0, 2, 53}, 53});
+    CHECK(config.name_servers[1] == coio::endpoint{coio::ipv6_address{"2001:db8::53"}, 53});
+    CHECK_EQ(config.timeout, 3s);
+    CHECK_EQ(config.attempts, 4);
+
+    config.parse_hosts(
+        "127.0.0.1 localhost\n"
+        "::1       localhost ip6-localhost # both families\n"
+        "192.0.2.7 Printer.Example.Test printer\n"
+        "not-an-address ignored\n"
+    );
+    CHECK_EQ(config.hosts.count("localhost"), 2);
+    CHECK_EQ(config.hosts.count("printer.example.test"), 1);
+    CHECK_EQ(config.hosts.count("printer"), 1);
+    CHECK_EQ(config.hosts.count("ignored"), 0);
+}
+
+TEST_CASE("dns: the cache coalesces lookups in flight and expires answers") {
+    coio::detail::dns_cache cache{4, 64};
+    const auto now = coio::detail::dns_cache::clock::now();
+    const std::string name = "www.example.test";
+
+    auto leader = cache.probe(name, dns_record_type::a, now);
+    CHECK_FALSE(leader.hit);
+    CHECK(leader.leader);
+    auto follower = cache.probe(name, dns_record_type::a, now);
+    CHECK_FALSE(follower.hit);
+    CHECK_FALSE(follower.leader);
+    CHECK_EQ(follower.flight, leader.flight); // waits for the same lookup
+    CHECK(cache.probe(name, dns_record_type::aaaa, now).leader); // another record type is another lookup
+
+    coio::detail::dns_answer answer{.addresses = {v4(1)}, .canonical_name = {}, .ttl = 60s};
+    cache.settle(name, dns_record_type::a, leader.flight, answer, {}, now + 60s);
+    CHECK(leader.flight->done.try_wait());
+    CHECK(leader.flight->answer.addresses == answer.addresses);
+
+    const auto hit = cache.probe(name, dns_record_type::a, now + 30s);
+    CHECK(hit.hit);
+    CHECK(hit.answer.addresses == answer.addresses);
+    CHECK(cache.probe(name, dns_record_type::a, now + 61s).leader); // expired
+}
+
+TEST_CASE("dns: numeric names and the hosts table never reach a name server") {
+    coio::dns_config config;
+    config.parse_hosts("192.0.2.7 printer\n");
+    coio::detail::dns_resolver_state state{config};
+
+    const auto numeric = state.local_answer("192.0.2.9", dns_record_type::a);
+    REQUIRE(numeric.has_value());
+    CHECK(numeric->addresses == std::vector<coio::ip_address>{v4(9)});
+    const auto numeric_v6 = state.local_answer("192.0.2.9", dns_record_type::aaaa);
+    REQUIRE(numeric_v6.has_value());
+    CHECK(numeric_v6->addresses.empty());
+
+    const auto host = state.local_answer("printer", dns_record_type::a);
+    REQUIRE(host.has_value());
+    CHECK(host->addresses == std::vector<coio::ip_address>{v4(7)});
+    CHECK_FALSE(state.local_answer("www.example.test", dns_record_type::a).has_value());
+}
+
+TEST_CASE_TEMPLATE("dns: async_resolve asks a stub server once for concurrent lookups and caches the answer", Context, COIO_TEST_CONTEXTS) {
+    std::optional<Context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using scheduler_t = typename Context::scheduler;
+
+    coio::udp::socket<scheduler_t> server{scheduler, coio::udp::v4()};
+    server.bind(coio::endpoint{coio::ipv4_address::loopback(), 0});
+    coio::basic_dns_resolver<scheduler_t> resolver{scheduler, test_config(server.local_endpoint())};
+
+    server_log log;
+    std::vector<coio::resolve_result_t> first, second;
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, udp_name_server(server, 2, log)),
+        coio::starts_on(scheduler, resolve_twice_concurrently(resolver, first, second)),
+        drive(*context)
+    ));
+    CHECK_EQ(log.a_queries, 1);
+    CHECK_EQ(log.aaaa_queries, 1);
+    REQUIRE_EQ(first.size(), 2);
+    CHECK(first[0].endpoint == coio::endpoint{coio::ipv4_address{192, 0, 2, 1}, 80});
+    CHECK(first[1].endpoint == coio::endpoint{coio::ipv6_address{"2001:db8::1"}, 80});
+    CHECK_EQ(second.size(), first.size());
+    CHECK_EQ(resolver.cache_size(), 2);
+
+    // the server is gone: only the cache can answer
+    std::vector<coio::resolve_result_t> cached;
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, resolver.async_resolve(coio::udp::v4(), "www.example.test", 443)
+            | coio::then([&](auto results) { cached = std::move(results); })),
+        drive(*context)
+    ));
+    REQUIRE_EQ(cached.size(), 1);
+    CHECK(cached[0].endpoint == coio::endpoint{coio::ipv4_address{192, 0, 2, 1}, 443});
+}
+
+TEST_CASE_TEMPLATE("dns: a truncated answer is fetched again over TCP", Context, COIO_TEST_CONTEXTS) {
+    std::optional<Context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using scheduler_t = typename Context::scheduler;
+
+    coio::udp::socket<scheduler_t> server{scheduler, coio::udp::v4()};
+    server.bind(coio::endpoint{coio::ipv4_address::loopback(), 0});
+    coio::tcp::acceptor<scheduler_t> acceptor{scheduler, server.local_endpoint()}; // same port, as name servers do
+    coio::basic_dns_resolver<scheduler_t> resolver{scheduler, test_config(server.local_endpoint())};
+
+    server_log log;
+    std::vector<coio::resolve_result_t> results;
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, udp_name_server(server, 1, log, true)),
+        coio::starts_on(scheduler, tcp_name_server(acceptor, log)),
+        coio::starts_on(scheduler, resolver.async_resolve(coio::tcp::v4(), "big.example.test", 80)
+            | coio::then([&](auto r) { results = std::move(r); })),
+        drive(*context)
+    ));
+    CHECK_EQ(log.a_queries, 1);
+    CHECK_EQ(log.tcp_queries, 1);
+    REQUIRE_EQ(results.size(), 2);
+    CHECK(results[1].endpoint == coio::endpoint{coio::ipv4_address{192, 0, 2, 2}, 80});
+}
+
+TEST_CASE_TEMPLATE("dns: a missing name is reported and cached, a silent server times out", Context, COIO_TEST_CONTEXTS) {
+    std::optional<Context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using scheduler_t = typename Context::scheduler;
+
+    coio::udp::socket<scheduler_t> server{scheduler, coio::udp::v4()};
+    server.bind(coio::endpoint{coio::ipv4_address::loopback(), 0});
+    auto config = test_config(server.local_endpoint());
+    config.timeout = 100ms;
+    coio::basic_dns_resolver<scheduler_t> resolver{scheduler, config};
+
+    server_log log;
+    auto [missing, _] = coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, resolve_error(resolver, "missing.example.test")),
+        coio::starts_on(scheduler, udp_name_server(server, 2, log)) | coio::then([] { return 0; }),
+        drive(*context)
+    )).value();
+    CHECK_EQ(missing, coio::error::dns_errc::host_not_found);
+
+    // cached for the SOA's negative TTL; the unanswered query for another name times out
+    auto [cached, silent] = coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, resolve_error(resolver, "missing.example.test")),
+        coio::starts_on(scheduler, resolve_error(resolver, "silent.example.test")),
+        drive(*context)
+    )).value();
+    CHECK_EQ(cached, coio::error::dns_errc::host_not_found);
+    CHECK_EQ(silent, coio::error::dns_errc::timed_out);
+    CHECK_EQ(log.a_queries + log.aaaa_queries, 2);
+}
+
+TEST_CASE_TEMPLATE("dns: a lookup waiting on a stopped one asks again instead of failing", Context, COIO_TEST_CONTEXTS) {
+    std::optional<Context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using scheduler_t = typename Context::scheduler;
+
+    coio::udp::socket<scheduler_t> server{scheduler, coio::udp::v4()};
+    server.bind(coio::endpoint{coio::ipv4_address::loopback(), 0});
+    coio::basic_dns_resolver<scheduler_t> resolver{scheduler, test_config(server.local_endpoint())};
+
+    // the stopped lookup's queries go unanswered, the follower's own are answered
+    server_log log;
+    std::vector<coio::resolve_result_t> follower;
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, udp_name_server(server, 2, log, false, 2)),
+        coio::starts_on(scheduler, stop_leader_keep_follower(resolver, scheduler, follower)),
+        drive(*context)
+    ));
+    CHECK_EQ(log.a_queries, 2);
+    CHECK_EQ(log.aaaa_queries, 2);
+    REQUIRE_EQ(follower.size(), 2);
+    CHECK(follower[0].endpoint == coio::endpoint{coio::ipv4_address{192, 0, 2, 1}, 80});
+    CHECK(follower[1].endpoint == coio::endpoint{coio::ipv6_address{"2001:db8::1"}, 80});
+}
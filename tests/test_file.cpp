@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <bit>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
@@ -7,10 +8,12 @@
 #include <optional>
 #include <random>
 #include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <system_error>
 #include <type_traits>
+#include <utility>
 #include <vector>
 #include <doctest/doctest.h>
 #include <coio/core.h>
@@ -22,7 +25,7 @@
 
 #if COIO_OS_LINUX
 #include <unistd.h>
-#include <coio/asyncio/epoll_context.h> // only for the regular-file rejection case below
+#include <coio/asyncio/epoll_context.h>
 #if COIO_HAS_IO_URING
 #include <coio/asyncio/uring_context.h>
 #endif
@@ -33,14 +36,20 @@
 
 // Register readable type names so templated test-case names embed the context type
 // (needed for doctest's --test-case-exclude, e.g. excluding "*uring_context*" under TSan).
-#if COIO_OS_LINUX and COIO_HAS_IO_URING
+#if COIO_OS_LINUX
+TYPE_TO_STRING(coio::epoll_context);
+#if COIO_HAS_IO_URING
 TYPE_TO_STRING(coio::uring_context);
+#endif
 #elif COIO_OS_WINDOWS
 TYPE_TO_STRING(coio::iocp_context);
 #endif
 
+// epoll_context runs file operations on its file threads, uring_context submits them to the ring
 #if COIO_OS_LINUX and COIO_HAS_IO_URING
-#define COIO_FILE_TEST_CONTEXTS coio::uring_context
+#define COIO_FILE_TEST_CONTEXTS coio::epoll_context, coio::uring_context
+#elif COIO_OS_LINUX
+#define COIO_FILE_TEST_CONTEXTS coio::epoll_context
 #elif COIO_OS_WINDOWS
 #define COIO_FILE_TEST_CONTEXTS coio::iocp_context
 #endif
@@ -430,13 +439,13 @@ TEST_CASE_TEMPLATE("file: opening an already-open file reports already_open", Co
 
 #if COIO_OS_LINUX
 
-TEST_CASE("file: epoll_context rejects regular files and directories") {
+TEST_CASE("file: epoll_context accepts regular files but rejects directories") {
     std::optional<coio::epoll_context> context;
     if (not try_make_context(context)) return;
     auto scheduler = context->get_scheduler();
     using file_t = stream_file_t<coio::epoll_context::scheduler>;
 
-    const auto path = unique_temp_path("epoll_reject", "epoll");
+    const auto path = unique_temp_path("epoll_regular", "epoll");
     const auto guard = remove_on_exit(path);
     {
         std::ofstream out{path};
@@ -446,21 +455,300 @@ TEST_CASE("file: epoll_context rejects regular files and directories") {
 
     file_t closed{scheduler}; // a closed wrapper on epoll is allowed
     CHECK_FALSE(closed.is_open());
+    CHECK_THROWS_AS(closed.set_queue_depth(1), std::system_error);
+
+    file_t file{scheduler, path.string(), file_t::read_only};
+    CHECK(file.is_open());
+    file.set_queue_depth(2);
 
     try {
-        file_t file{scheduler, path.string(), file_t::read_only};
-        FAIL("expected std::errc::operation_not_permitted: epoll cannot wait on regular files");
+        file_t dir{scheduler, std::filesystem::temp_directory_path().string(), file_t::read_only};
+        FAIL("expected std::errc::operation_not_permitted: epoll cannot wait on directories");
     }
     catch (const std::system_error& e) {
         CHECK_EQ(e.code(), std::errc::operation_not_permitted);
     }
+}
+
+TEST_CASE("file: epoll_context runs a file's operations in order at queue depth 1") {
+    std::optional<coio::epoll_context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using file_t = stream_file_t<coio::epoll_context::scheduler>;
+
+    const auto path = unique_temp_path("epoll_depth", "epoll");
+    const auto guard = remove_on_exit(path);
+
+    file_t file{scheduler, path.string(), file_t::read_write | file_t::create | file_t::truncate};
+    REQUIRE(file.is_open());
+    file.set_queue_depth(1);
+
+    // writes at the stream position only land back to back if they run one at a time, in order
+    constexpr std::size_t chunk = 64 * 1024;
+    const auto payload = make_payload(4 * chunk, 10);
+    const auto part = [&](std::size_t i) { return std::span{payload}.subspan(i * chunk, chunk); };
+    auto result = coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, coio::when_all(
+            file.async_write_some(part(0)),
+            file.async_write_some(part(1)),
+            file.async_write_some(part(2)),
+            file.async_write_some(part(3))
+        )),
+        drive(*context)
+    ));
+    REQUIRE(result.has_value());
+    const auto [n0, n1, n2, n3] = *result;
+    CHECK_EQ(n0 + n1 + n2 + n3, payload.size());
+
+    std::vector<std::byte> readback(payload.size());
+    CHECK_EQ(file.seek(0, file_t::seek_set), 0);
+    std::size_t total = 0;
+    while (total < readback.size()) {
+        total += file.read_some(std::span{readback}.subspan(total));
+    }
+    CHECK(std::ranges::equal(readback, payload));
+}
+
+TEST_CASE("file: epoll_context cancels file operations still waiting for a thread") {
+    std::optional<coio::epoll_context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using file_t = random_access_file_t<coio::epoll_context::scheduler>;
+
+    const auto path = unique_temp_path("epoll_cancel", "epoll");
+    const auto guard = remove_on_exit(path);
+
+    file_t file{scheduler, path.string(), file_t::read_write | file_t::create | file_t::truncate};
+    REQUIRE(file.is_open());
+    file.set_queue_depth(1);
+
+    constexpr std::size_t chunk = 4 * 1024 * 1024;
+    const auto payload = make_payload(chunk, 11);
+    constexpr auto stopped = std::size_t(-1);
+    const auto write_at = [&](std::size_t i) {
+        return file.async_write_some_at(i * chunk, payload) | coio::upon_stopped([] { return stopped; });
+    };
+    // the last write waits behind three large ones when `cancel` runs right after it started
+    auto result = coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, coio::when_all(
+            write_at(0),
+            write_at(1),
+            write_at(2),
+            write_at(3),
+            coio::just() | coio::then([&file] { file.cancel(); })
+        )),
+        drive(*context)
+    ));
+    REQUIRE(result.has_value());
+    const auto [n0, n1, n2, n3] = *result;
+    for (const std::size_t n : {n0, n1, n2}) {
+        CHECK((n == stopped or n == chunk));
+    }
+    CHECK_EQ(n3, stopped);
+}
 
+TEST_CASE("file: epoll_context close cancels waiting file operations and waits for running ones") {
+    std::optional<coio::epoll_context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using file_t = random_access_file_t<coio::epoll_context::scheduler>;
+
+    const auto path = unique_temp_path("epoll_close", "epoll");
+    const auto guard = remove_on_exit(path);
+
+    file_t file{scheduler, path.string(), file_t::read_write | file_t::create | file_t::truncate};
+    REQUIRE(file.is_open());
+    file.set_queue_depth(1);
+
+    constexpr std::size_t chunk = 4 * 1024 * 1024;
+    const auto payload = make_payload(chunk, 12);
+    constexpr auto stopped = std::size_t(-1);
+    const auto write_at = [&](std::size_t i) {
+        return file.async_write_some_at(i * chunk, payload) | coio::upon_stopped([] { return stopped; });
+    };
+    // a write a thread runs finishes before `close` returns, the last one never reaches the descriptor
+    auto result = coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, coio::when_all(
+            write_at(0),
+            write_at(1),
+            write_at(2),
+            coio::just() | coio::then([&file] { file.close(); })
+        )),
+        drive(*context)
+    ));
+    REQUIRE(result.has_value());
+    const auto [n0, n1, n2] = *result;
+    for (const std::size_t n : {n0, n1}) {
+        CHECK((n == stopped or n == chunk));
+    }
+    CHECK_EQ(n2, stopped);
+    CHECK_FALSE(file.is_open());
+}
+#endif // COIO_OS_LINUX
+
+#if COIO_OS_LINUX and COIO_HAS_IO_URING
+TEST_CASE("file: uring_context registered files and buffers roundtrip") {
+    std::optional<coio::uring_context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using file_t = random_access_file_t<coio::uring_context::scheduler>;
+
+    const auto path = unique_temp_path("registered", "uring");
+    const auto guard = remove_on_exit(path);
+
+    file_t file{scheduler, path.string(), file_t::read_write | file_t::create | file_t::truncate};
+    REQUIRE(file.is_open());
+
+    // without a table there is nothing to install the descriptor into
+    CHECK_THROWS_AS(file.register_file(), std::system_error);
+
+    // one registered region, split into a write half and a read half
+    std::vector<std::byte> region(8192);
+    const std::span<std::byte> regions[]{region};
     try {
-        file_t dir{scheduler, std::filesystem::temp_directory_path().string(), file_t::read_only};
-        FAIL("expected std::errc::operation_not_permitted: epoll cannot wait on directories");
+        context->register_file_table(4);
+        context->register_buffers(regions);
     }
     catch (const std::system_error& e) {
-        CHECK_EQ(e.code(), std::errc::operation_not_permitted);
+        MESSAGE("skipping: cannot register files or buffers: " << e.what());
+        return;
+    }
+    file.register_file();
+    CHECK(file.is_open());
+
+    const auto payload = make_payload(4096, 6);
+    std::ranges::copy(payload, region.begin());
+    const auto write_half = std::span{region}.first(4096);
+    const auto read_half = std::span{region}.last(4096);
+
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, [](file_t& file, std::span<const std::byte> src, std::span<std::byte> dest) -> coio::task<> {
+            auto [write_ec, written] = co_await coio::async_write_at(file, 0, src);
+            CHECK_FALSE(write_ec);
+            CHECK_EQ(written, src.size());
+            auto [read_ec, read_n] = co_await coio::async_read_at(file, 0, dest);
+            CHECK_FALSE(read_ec);
+            CHECK_EQ(read_n, dest.size());
+        }(file, write_half, read_half)),
+        drive(*context)
+    ));
+    CHECK(std::ranges::equal(read_half, payload));
+
+    // closing gives the slot back: four more files fit into the four-slot table
+    file.close();
+    std::vector<file_t> files;
+    for (int i = 0; i < 4; ++i) {
+        files.emplace_back(scheduler, path.string(), file_t::read_only);
+        files.back().register_file();
     }
 }
-#endif // COIO_OS_LINUX
+#endif
+
+TEST_CASE("file: aligned_buffer and the alignment helpers") {
+    static_assert(coio::align_up(0, 512) == 0);
+    static_assert(coio::align_up(1, 512) == 512);
+    static_assert(coio::align_up(4096, 4096) == 4096);
+    static_assert(coio::align_down(4097, 4096) == 4096);
+
+    coio::aligned_buffer buffer{1000, 512};
+    REQUIRE_EQ(buffer.size(), 1024);
+    CHECK_EQ(buffer.alignment(), 512);
+    CHECK(coio::is_aligned(buffer.bytes(), 0, 512));
+    CHECK(coio::is_aligned(buffer.bytes().first(512), 4096, 512));
+    CHECK_FALSE(coio::is_aligned(buffer.bytes().subspan(1, 512), 0, 512));
+    CHECK_FALSE(coio::is_aligned(buffer.bytes().first(100), 0, 512));
+    CHECK_FALSE(coio::is_aligned(buffer.bytes(), 100, 512));
+
+    auto moved = std::move(buffer);
+    CHECK(buffer.empty());
+    CHECK_EQ(moved.size(), 1024);
+
+    CHECK_THROWS_AS(coio::aligned_buffer(64, 48), std::invalid_argument);
+}
+
+#if COIO_OS_LINUX and COIO_HAS_IO_URING
+TEST_CASE("file: uring_context opens, allocates, syncs, stats and closes without blocking") {
+    std::optional<coio::uring_context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using file_t = random_access_file_t<coio::uring_context::scheduler>;
+
+    const auto path = unique_temp_path("async_ops", "uring");
+    const auto guard = remove_on_exit(path);
+    const std::string path_str = path.string();
+
+    file_t file{scheduler};
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, [](file_t& file, coio::zstring_view path) -> coio::task<> {
+            co_await file.async_open(path, file_t::read_write | file_t::create | file_t::truncate);
+            CHECK(file.is_open());
+            CHECK_THROWS_AS((void) file.async_open(path, file_t::read_only), std::system_error);
+
+            co_await file.async_allocate(0, 1 << 16);
+            CHECK_EQ(file.size(), 1 << 16);
+
+            const auto payload = make_payload(4096, 8);
+            auto [write_ec, written] = co_await coio::async_write_at(file, 4096, payload);
+            CHECK_FALSE(write_ec);
+            CHECK_EQ(written, payload.size());
+            co_await file.async_sync_data();
+            co_await file.async_sync_all();
+
+            auto object = file.get_io_scheduler().make_io_object(::dup(file.native_handle()));
+            const struct ::statx stx = co_await object.async_stat();
+            CHECK_EQ(stx.stx_size, 1 << 16);
+            CHECK(S_ISREG(stx.stx_mode));
+
+            static_cast<void>(file.async_close());
+            CHECK(file.is_open()); // nothing happens until the close starts
+
+            co_await file.async_close();
+            CHECK_FALSE(file.is_open());
+        }(file, path_str)),
+        drive(*context)
+    ));
+    CHECK_EQ(std::filesystem::file_size(path), 1 << 16);
+}
+
+TEST_CASE("file: uring_context direct I/O roundtrip with aligned buffers") {
+    std::optional<coio::uring_context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using file_t = random_access_file_t<coio::uring_context::scheduler>;
+
+    const auto path = unique_temp_path("direct", "uring");
+    const auto guard = remove_on_exit(path);
+
+    file_t file{scheduler};
+    try {
+        file.open(path.string(), file_t::read_write | file_t::create | file_t::truncate | file_t::direct);
+    }
+    catch (const std::system_error& e) {
+        // tmpfs and some overlay filesystems refuse O_DIRECT
+        MESSAGE("skipping: cannot open with O_DIRECT: " << e.what());
+        return;
+    }
+    const std::size_t alignment = file.direct_io_alignment();
+    REQUIRE(std::has_single_bit(alignment));
+
+    coio::aligned_buffer src{8192, alignment};
+    coio::aligned_buffer dest{8192, alignment};
+    const auto payload = make_payload(src.size(), 9);
+    std::ranges::copy(payload, src.data());
+    REQUIRE(coio::is_aligned(src.bytes(), src.size(), alignment));
+
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, [](file_t& file, std::span<const std::byte> src, std::span<std::byte> dest) -> coio::task<> {
+            auto [write_ec, written] = co_await coio::async_write_at(file, src.size(), src);
+            CHECK_FALSE(write_ec);
+            CHECK_EQ(written, src.size());
+            co_await file.async_sync_data();
+            auto [read_ec, read_n] = co_await coio::async_read_at(file, src.size(), dest);
+            CHECK_FALSE(read_ec);
+            CHECK_EQ(read_n, dest.size());
+        }(file, src.bytes(), dest.bytes())),
+        drive(*context)
+    ));
+    CHECK(std::ranges::equal(dest.bytes(), payload));
+}
+#endif
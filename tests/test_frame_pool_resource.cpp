@@ -0,0 +1,158 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include <coio/core.h>
+#include <coio/thread_pool_context.h>
+#include <coio/utils/frame_pool_resource.h>
+
+namespace {
+    // counts what reaches the upstream resource
+    class counting_resource : public std::pmr::memory_resource {
+    public:
+        std::size_t allocations = 0;
+        std::size_t deallocations = 0;
+
+    private:
+        auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        auto do_deallocate(void* p, std::size_t bytes, std::size_t alignment) -> void override {
+            ++deallocations;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override {
+            return this == &other;
+        }
+    };
+
+    using pmr_task = coio::thread_pool_context::task<void, std::pmr::polymorphic_allocator<std::byte>>;
+
+    auto count_up(std::allocator_arg_t, std::pmr::polymorphic_allocator<std::byte>, std::atomic<int>& count) -> pmr_task {
+        count.fetch_add(1, std::memory_order_relaxed);
+        co_return;
+    }
+
+    auto fan_out(
+        std::allocator_arg_t,
+        std::pmr::polymorphic_allocator<std::byte> alloc,
+        coio::thread_pool_context::scheduler scheduler,
+        std::atomic<int>& count,
+        int n
+    ) -> pmr_task {
+        coio::async_scope scope;
+        for (int i = 0; i < n; ++i) {
+            scope.spawn(coio::starts_on(scheduler, count_up(std::allocator_arg, alloc, count)));
+        }
+        co_await scope.join();
+    }
+}
+
+TEST_CASE("frame_pool_resource: freed blocks are reused by their size class") {
+    counting_resource upstream;
+    coio::frame_pool_resource pool{upstream};
+
+    void* a = pool.allocate(100, 16);
+    void* b = pool.allocate(100, 16);
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(a) % 16, 0);
+    CHECK_NE(a, b);
+    pool.deallocate(a, 100, 16);
+    CHECK_EQ(pool.allocate(112, 8), a); // the same 112-byte class, latest freed first
+    void* c = pool.allocate(120, 16);  // the next class up
+    CHECK_NE(c, a);
+    CHECK_NE(c, b);
+    pool.deallocate(a, 112, 8);
+    pool.deallocate(b, 100, 16);
+    pool.deallocate(c, 120, 16);
+
+    const auto stats = pool.stats();
+    CHECK_EQ(stats.allocations, 4);
+    CHECK_EQ(stats.deallocations, 4);
+    CHECK_EQ(stats.remote_deallocations, 0);
+    CHECK_EQ(stats.slabs, 2);
+    CHECK_EQ(stats.thread_caches, 1);
+    CHECK_EQ(upstream.allocations, 2); // a slab per class
+}
+
+TEST_CASE("frame_pool_resource: large or overaligned requests go upstream") {
+    counting_resource upstream;
+    coio::frame_pool_resource pool{{.max_block_size = 1024, .slab_size = 16 * 1024}, upstream};
+    CHECK_EQ(pool.get_options().max_block_size, 1024);
+
+    void* large = pool.allocate(1025, 16);
+    void* aligned = pool.allocate(64, 64);
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0);
+    CHECK_EQ(upstream.allocations, 2);
+    pool.deallocate(large, 1025, 16);
+    pool.deallocate(aligned, 64, 64);
+    CHECK_EQ(upstream.deallocations, 2);
+    CHECK_EQ(pool.stats().upstream_allocations, 2);
+    CHECK_EQ(pool.stats().allocations, 0);
+}
+
+TEST_CASE("frame_pool_resource: blocks freed on another thread return to their owner") {
+    counting_resource upstream;
+    coio::frame_pool_resource pool{upstream};
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 64; ++i) {
+        blocks.push_back(pool.allocate(256, 16));
+        std::memset(blocks.back(), i, 256);
+    }
+    std::thread{[&] {
+        for (void* p : blocks) pool.deallocate(p, 256, 16);
+    }}.join();
+
+    auto stats = pool.stats();
+    CHECK_EQ(stats.remote_deallocations, 64);
+    CHECK_EQ(stats.thread_caches, 1); // freeing alone doesn't give the other thread a cache
+
+    // the owner takes them back, last returned first, before carving anything new
+    void* reused = pool.allocate(256, 16);
+    CHECK_EQ(reused, blocks.back());
+    pool.deallocate(reused, 256, 16);
+    CHECK_EQ(pool.stats().slabs, stats.slabs);
+}
+
+TEST_CASE("frame_pool_resource: a new thread adopts the cache of one that exited") {
+    coio::frame_pool_resource pool;
+    void* first = nullptr;
+    std::thread{[&] {
+        first = pool.allocate(48, 16);
+        pool.deallocate(first, 48, 16);
+    }}.join();
+    void* second = nullptr;
+    std::thread{[&] {
+        second = pool.allocate(48, 16);
+        pool.deallocate(second, 48, 16);
+    }}.join();
+
+    CHECK_EQ(second, first);
+    CHECK_EQ(pool.stats().thread_caches, 1);
+    CHECK_EQ(pool.stats().slabs, 1);
+}
+
+TEST_CASE("frame_pool_resource: backs a context's coroutine frames") {
+    coio::frame_pool_resource pool;
+    std::atomic<int> count{0};
+    constexpr int n = 200;
+    {
+        coio::thread_pool_context context{2, pool};
+        auto scheduler = context.get_scheduler();
+        coio::this_thread::sync_wait(coio::starts_on(scheduler, fan_out(std::allocator_arg, context.get_allocator(), scheduler, count, n)));
+    }
+    CHECK_EQ(count.load(), n);
+
+    const auto stats = pool.stats();
+    CHECK_GE(stats.allocations, n + 1);
+    CHECK_EQ(stats.allocations, stats.deallocations + stats.remote_deallocations);
+    CHECK_EQ(stats.upstream_allocations, 0);
+}
@@ -0,0 +1,140 @@
+#include <cstddef>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include <coio/core.h>
+#include <coio/io_context_pool.h>
+#include <coio/net/basic.h>
+#include <coio/net/tcp.h>
+
+#if COIO_OS_LINUX
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <coio/asyncio/epoll_context.h>
+using io_context = coio::epoll_context;
+#elif COIO_OS_WINDOWS
+#include <coio/asyncio/iocp_context.h>
+using io_context = coio::iocp_context;
+#endif
+
+namespace {
+    using pool_t = coio::io_context_pool<io_context>;
+
+#if COIO_OS_LINUX
+    using tcp_socket = coio::tcp::socket<pool_t::scheduler>;
+    using tcp_acceptor = coio::tcp::acceptor<pool_t::scheduler>;
+
+    auto connect_clients(pool_t& pool, const coio::endpoint& server_endpoint, std::size_t n) -> std::vector<tcp_socket> {
+        std::vector<tcp_socket> clients;
+        clients.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            auto& client = clients.emplace_back(pool.get_scheduler(0), coio::tcp::v4());
+            client.connect(server_endpoint);
+        }
+        return clients;
+    }
+
+    // the workers aren't accepting: drain each acceptor's queue synchronously and count where the connections went
+    auto accepted_per_acceptor(std::vector<tcp_acceptor>& acceptors, std::size_t expected) -> std::vector<std::size_t> {
+        std::vector<std::size_t> counts(acceptors.size());
+        std::size_t total = 0;
+        while (total < expected) {
+            std::vector<::pollfd> fds;
+            for (auto& acceptor : acceptors) {
+                fds.push_back({.fd = acceptor.native_handle(), .events = POLLIN, .revents = 0});
+            }
+            if (::poll(fds.data(), fds.size(), 1000) <= 0) break;
+            for (std::size_t i = 0; i < acceptors.size(); ++i) {
+                if (fds[i].revents & POLLIN) {
+                    static_cast<void>(acceptors[i].accept());
+                    ++counts[i];
+                    ++total;
+                }
+            }
+        }
+        return counts;
+    }
+
+    auto sum(const std::vector<std::size_t>& counts) -> std::size_t {
+        std::size_t total = 0;
+        for (auto count : counts) total += count;
+        return total;
+    }
+#endif
+}
+
+TEST_CASE("io_context_pool: every context runs on its own thread") {
+    pool_t pool{3};
+    REQUIRE_EQ(pool.size(), 3);
+
+    std::set<std::thread::id> ids;
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+        coio::this_thread::sync_wait(pool.get_scheduler(i).schedule() | coio::then([&] { ids.insert(std::this_thread::get_id()); }));
+    }
+    CHECK_EQ(ids.size(), 3);
+    CHECK_FALSE(ids.contains(std::this_thread::get_id()));
+
+    // round-robin
+    for (std::size_t i = 0; i < 2 * pool.size(); ++i) {
+        CHECK(pool.pick_scheduler() == pool.get_scheduler(i % pool.size()));
+    }
+}
+
+#if COIO_OS_LINUX
+TEST_CASE("io_context_pool: pinned threads stay on their cpu") {
+    pool_t pool{coio::io_context_pool_options{.thread_count = 2, .pin_threads = true}};
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+        REQUIRE(pool.cpu(i).has_value());
+        auto [cpu] = coio::this_thread::sync_wait(pool.get_scheduler(i).schedule() | coio::then([] { return ::sched_getcpu(); })).value();
+        CHECK_EQ(static_cast<unsigned>(cpu), *pool.cpu(i));
+    }
+}
+
+TEST_CASE("io_context_pool: reuseport acceptors share the port and every connection reaches one of them") {
+    pool_t pool{coio::io_context_pool_options{.thread_count = 2, .pin_threads = true}};
+    constexpr std::size_t n = 32;
+    for (auto steering : {coio::reuseport_steering::hash, coio::reuseport_steering::incoming_cpu, coio::reuseport_steering::cpu_bpf}) {
+        CAPTURE(static_cast<int>(steering));
+        auto acceptors = pool.make_acceptors<coio::tcp>(coio::endpoint{coio::ipv4_address::loopback(), 0}, steering);
+        REQUIRE_EQ(acceptors.size(), pool.size());
+        const auto server_endpoint = acceptors[0].local_endpoint();
+        CHECK_NE(server_endpoint.port(), 0);
+        CHECK_EQ(acceptors[1].local_endpoint(), server_endpoint);
+
+        auto clients = connect_clients(pool, server_endpoint, n);
+        CHECK_EQ(sum(accepted_per_acceptor(acceptors, n)), n);
+    }
+}
+
+TEST_CASE("io_context_pool: cpu steering hands a connection to the acceptor pinned to the receiving cpu") {
+    if (coio::detail::allowed_cpus().size() < 2) {
+        MESSAGE("skipping: needs two cpus");
+        return;
+    }
+    pool_t pool{coio::io_context_pool_options{.thread_count = 2, .pin_threads = true}};
+    auto acceptors = pool.make_acceptors<coio::tcp>(coio::endpoint{coio::ipv4_address::loopback(), 0}, coio::reuseport_steering::cpu_bpf);
+
+    // on loopback, the connection is received on the cpu that connects
+    constexpr std::size_t n = 16;
+    std::vector<tcp_socket> clients;
+    std::thread{[&] {
+        coio::detail::pin_thread(::pthread_self(), *pool.cpu(1));
+        clients = connect_clients(pool, acceptors[0].local_endpoint(), n);
+    }}.join();
+
+    const auto counts = accepted_per_acceptor(acceptors, n);
+    CHECK_EQ(counts[0], 0);
+    CHECK_EQ(counts[1], n);
+}
+
+TEST_CASE("io_context_pool: cpu steering needs pinned threads") {
+    pool_t pool{1};
+    CHECK_THROWS_AS(
+        static_cast<void>(pool.make_acceptors<coio::tcp>(coio::endpoint{coio::ipv4_address::loopback(), 0}, coio::reuseport_steering::cpu_bpf)),
+        std::invalid_argument
+    );
+}
+#endif
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <set>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include <coio/detail/object_pool.h>
+
+namespace {
+    std::atomic<int> live_items{0};
+
+    struct item {
+        item() noexcept {
+            live_items.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        item(const item&) = delete;
+
+        ~item() {
+            live_items.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        item* next = nullptr;
+        int value = 0;
+    };
+
+    using item_pool = coio::detail::object_pool<item, &item::next>;
+}
+
+TEST_CASE("object_pool reuses the most recently released object") {
+    {
+        item_pool pool;
+        item* a = pool.acquire();
+        item* b = pool.acquire();
+        CHECK_NE(a, b);
+        CHECK_EQ(live_items.load(), 2);
+
+        pool.release(*a);
+        CHECK_EQ(pool.acquire(), a);
+        pool.release(*b);
+        pool.release(*a);
+        CHECK_EQ(pool.acquire(), a);
+        CHECK_EQ(pool.acquire(), b);
+        CHECK_EQ(live_items.load(), 2);
+        pool.release(*a);
+        pool.release(*b);
+    }
+    CHECK_EQ(live_items.load(), 0); // freed only with the pool
+}
+
+TEST_CASE("object_pool hands released objects over to other threads") {
+    {
+        item_pool pool;
+        constexpr std::size_t n = 4 * item_pool::magazine_size;
+        std::vector<item*> items;
+        for (std::size_t i = 0; i < n; ++i) items.push_back(pool.acquire());
+        for (item* it : items) pool.release(*it);
+        // this thread keeps a magazine's worth, the rest is up for grabs
+        std::set<item*> taken;
+        std::thread{[&] {
+            for (std::size_t i = 0; i < n - item_pool::magazine_size; ++i) taken.insert(pool.acquire());
+            for (item* it : taken) pool.release(*it);
+        }}.join();
+
+        CHECK_EQ(taken.size(), n - item_pool::magazine_size);
+        CHECK_EQ(live_items.load(), static_cast<int>(n)); // none of them newly made
+        for (item* it : taken) CHECK(std::find(items.begin(), items.end(), it) != items.end());
+    }
+    CHECK_EQ(live_items.load(), 0);
+}
+
+TEST_CASE("object_pool survives objects acquired on one thread and released on another") {
+    {
+        item_pool pool;
+        constexpr int rounds = 2000;
+        std::atomic<item*> slot{nullptr};
+        std::thread consumer{[&] {
+            for (int i = 0; i < rounds; ++i) {
+                item* it;
+                while ((it = slot.exchange(nullptr, std::memory_order_acquire)) == nullptr) std::this_thread::yield();
+                CHECK_EQ(it->value, i);
+                pool.release(*it);
+            }
+        }};
+        for (int i = 0; i < rounds; ++i) {
+            item* it = pool.acquire();
+            it->value = i;
+            while (slot.load(std::memory_order_relaxed) != nullptr) std::this_thread::yield();
+            slot.store(it, std::memory_order_release);
+        }
+        consumer.join();
+        // the consumer's releases come back to the producer instead of it allocating anew each time
+        CHECK_LT(live_items.load(), rounds / 4);
+    }
+    CHECK_EQ(live_items.load(), 0);
+}
+
+TEST_CASE("object_pool takes releases from thread_local destructors once the thread's index is given back") {
+    {
+        item_pool pool;
+        struct holder {
+            ~holder() {
+                *index = coio::detail::thread_index::current();
+                pool->release(*it);
+            }
+
+            item_pool* pool = nullptr;
+            item* it = nullptr;
+            std::size_t* index = nullptr;
+        };
+        std::size_t index = 0;
+        item* released = nullptr;
+        std::thread{[&] {
+            // constructed before the thread's index, so destroyed after it was given back
+            thread_local holder h;
+            h.pool = &pool;
+            h.it = released = pool.acquire();
+            h.index = &index;
+        }}.join();
+        CHECK_EQ(index, coio::detail::thread_index::none);
+
+        // the release went to the shared stack rather than to the magazine of the index's next owner
+        item* reacquired = nullptr;
+        std::thread{[&] {
+            reacquired = pool.acquire();
+            pool.release(*reacquired);
+        }}.join();
+        CHECK_EQ(reacquired, released);
+    }
+    CHECK_EQ(live_items.load(), 0);
+}
+
+TEST_CASE("object_pool serves threads without a magazine from the shared stack") {
+    {
+        item_pool pool;
+        constexpr std::size_t n = 2 * item_pool::magazine_size;
+        std::vector<item*> items;
+        for (std::size_t i = 0; i < n; ++i) items.push_back(pool.acquire());
+        for (item* it : items) pool.release(*it); // hands `magazine_size` of them to the shared stack
+
+        // occupy every magazine index, so that one more thread goes without
+        std::atomic<bool> done{false};
+        std::atomic<std::size_t> parked{0};
+        std::vector<std::thread> holders;
+        for (std::size_t i = 0; i < item_pool::max_magazines; ++i) {
+            holders.emplace_back([&] {
+                static_cast<void>(coio::detail::thread_index::current());
+                parked.fetch_add(1);
+                while (not done.load()) std::this_thread::yield();
+            });
+        }
+        while (parked.load() != item_pool::max_magazines) std::this_thread::yield();
+
+        std::set<item*> taken;
+        std::thread{[&] {
+            CHECK_GE(coio::detail::thread_index::current(), item_pool::max_magazines);
+            for (std::size_t i = 0; i < item_pool::magazine_size; ++i) taken.insert(pool.acquire());
+            for (item* it : taken) pool.release(*it);
+        }}.join();
+        done.store(true);
+        for (auto& t : holders) t.join();
+
+        CHECK_EQ(taken.size(), item_pool::magazine_size);
+        CHECK_EQ(live_items.load(), static_cast<int>(n)); // none of them newly made
+    }
+    CHECK_EQ(live_items.load(), 0);
+}
@@ -1,11 +1,13 @@
 #include <algorithm>
 #include <chrono>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <span>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <vector>
 #include <doctest/doctest.h>
 #include <coio/core.h>
@@ -180,6 +182,103 @@ namespace {
         CHECK_EQ(winner, 2); // the timer won: the pending read was stopped
     }
 
+    // Each round arms a read while another thread writes one byte after a short delay. Rounds alternate
+    // between a timer that loses (the read must see the byte) and one that races the write (either may win,
+    // but a byte read must be counted exactly once). The bytes left over are drained at the end.
+    template<typename Scheduler>
+    auto reads_racing_writer_thread(pipe_reader_t<Scheduler>& reader, pipe_writer_t<Scheduler>& writer, Scheduler scheduler) -> coio::task<> {
+        constexpr std::size_t rounds = 200;
+        std::size_t received = 0;
+        for (std::size_t i = 0; i < rounds; ++i) {
+            const auto delay = std::chrono::microseconds{i % 7 * 20};
+            std::thread writer_thread{[&writer, delay] {
+                std::this_thread::sleep_for(delay);
+                const std::byte one{0x01};
+                static_cast<void>(writer.write_some(std::span{&one, 1}));
+            }};
+            const bool racing = i % 2 == 1;
+            char buffer[16];
+            const int winner = co_await coio::when_any(
+                reader.async_read_some(coio::as_writable_bytes(buffer)) | coio::then([&](std::size_t n) {
+                    received += n;
+                    return 1;
+                }),
+                scheduler.schedule_after(racing ? std::chrono::microseconds{60} : std::chrono::microseconds{5s}) | coio::then([] { return 2; })
+            );
+            writer_thread.join();
+            if (not racing) CHECK_EQ(winner, 1);
+        }
+        char buffer[16];
+        while (received < rounds) {
+            received += co_await reader.async_read_some(coio::as_writable_bytes(buffer));
+        }
+        CHECK_EQ(received, rounds);
+    }
+
+    // --- inline completion helpers -------------------------------------------
+
+    template<typename Scheduler>
+    auto read_one_by_one(pipe_reader_t<Scheduler>& reader, std::size_t n) -> coio::task<> {
+        std::byte byte;
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t got = co_await reader.async_read_some(std::span{&byte, 1});
+            CHECK_EQ(got, 1);
+        }
+    }
+
+    // how many ready operations the consumer ran to read `n` buffered bytes one at a time
+    template<typename Context>
+    auto queued_completions(Context& context, std::size_t n) -> std::size_t {
+        auto scheduler = context.get_scheduler();
+        auto [reader, writer] = coio::make_pipe(scheduler);
+        const std::vector<std::byte> payload(n, std::byte{0x2a});
+        REQUIRE_EQ(writer.write_some(payload), n);
+
+        std::size_t handled = 0;
+        coio::this_thread::sync_wait(coio::when_all(
+            coio::starts_on(scheduler, read_one_by_one(reader, n)),
+            coio::just() | coio::then([&] { handled = context.run(); })
+        ));
+        return handled;
+    }
+
+    // --- drain budget helpers ---------------------------------------------------
+
+    // keeps the ready queue busy until `done`, or gives up at `give_up`
+    template<typename Scheduler>
+    auto flood(Scheduler scheduler, const bool& done, std::chrono::steady_clock::time_point give_up) -> coio::task<> {
+        while (not done and std::chrono::steady_clock::now() < give_up) {
+            co_await scheduler.schedule();
+        }
+    }
+
+    template<typename Scheduler>
+    auto read_one(pipe_reader_t<Scheduler>& reader, bool& done) -> coio::task<> {
+        std::byte byte;
+        CHECK_EQ(co_await reader.async_read_some(std::span{&byte, 1}), 1);
+        done = true;
+    }
+
+    // how long a read waits for a byte written while ready continuations flood the consumer
+    template<typename Context>
+    auto read_latency_under_flood(Context& context) -> std::chrono::steady_clock::duration {
+        auto scheduler = context.get_scheduler();
+        auto [reader, writer] = coio::make_pipe(scheduler);
+        bool done = false;
+        const auto written_at = std::chrono::steady_clock::now() + 20ms;
+        std::jthread writer_thread{[&writer, written_at] {
+            std::this_thread::sleep_until(written_at);
+            const std::byte one{0x01};
+            static_cast<void>(writer.write_some(std::span{&one, 1}));
+        }};
+        coio::this_thread::sync_wait(coio::when_all(
+            coio::starts_on(scheduler, flood(scheduler, done, written_at + 5s)),
+            coio::starts_on(scheduler, read_one(reader, done)),
+            coio::just() | coio::then([&] { context.run(); })
+        ));
+        return std::chrono::steady_clock::now() - written_at;
+    }
+
     // --- zero-length helper ----------------------------------------------------
 
     template<typename Scheduler>
@@ -200,6 +299,33 @@ namespace {
         CHECK_EQ(written, 0);
     }
 
+    // --- submission backpressure helpers ----------------------------------------
+
+    // a read the writer feeds once a timer fires
+    template<typename Scheduler>
+    auto fed_read(pipe_reader_t<Scheduler>& reader, pipe_writer_t<Scheduler>& writer, Scheduler scheduler, std::size_t& received) -> coio::task<> {
+        std::byte byte{};
+        co_await coio::when_all(
+            reader.async_read_some(std::span{&byte, 1}) | coio::then([&received](std::size_t n) { received += n; }),
+            scheduler.schedule_after(1ms) | coio::then([&writer] {
+                const std::byte one{0x01};
+                static_cast<void>(writer.write_some(std::span{&one, 1}));
+            })
+        );
+    }
+
+    // a read on a silent pipe, which a timer cancels
+    template<typename Scheduler>
+    auto cancelled_read(pipe_reader_t<Scheduler>& reader, Scheduler scheduler, std::size_t& stopped) -> coio::task<> {
+        std::byte byte{};
+        const int winner = co_await coio::when_any(
+            reader.async_read_some(std::span{&byte, 1}) | coio::then([](std::size_t) { return 1; }),
+            scheduler.schedule_after(2ms) | coio::then([] { return 2; })
+        );
+        CHECK_EQ(winner, 2);
+        if (winner == 2) ++stopped;
+    }
+
     // --- make_pipe overload helper ---------------------------------------------
 
     // one byte through the pair, synchronously (sync members never touch the completion
@@ -308,6 +434,85 @@ TEST_CASE_TEMPLATE("pipe: pending read on an empty pipe is cancelled by a timer
     ));
 } // context must destruct cleanly here: the raced read completed (stopped)
 
+TEST_CASE_TEMPLATE("pipe: reads armed against a writer thread neither lose an edge nor a byte when cancelled", Context, COIO_TEST_CONTEXTS) {
+    std::optional<Context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+
+    auto [reader, writer] = coio::make_pipe(scheduler);
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, reads_racing_writer_thread(reader, writer, scheduler)),
+        drive(*context)
+    ));
+}
+
+TEST_CASE_TEMPLATE("pipe: inline completion skips the ready queue, up to the depth limit", Context, COIO_TEST_CONTEXTS) {
+    constexpr std::size_t n = 1000;
+    std::optional<Context> queued;
+    if (not try_make_context(queued)) return;
+    const std::size_t queued_count = queued_completions(*queued, n);
+    CHECK_GE(queued_count, n);
+
+    std::optional<Context> inlined;
+    if (not try_make_context(inlined)) return;
+    inlined->set_inline_completion_depth(8);
+    const std::size_t inlined_count = queued_completions(*inlined, n);
+    CHECK_LE(inlined_count, queued_count);
+#if COIO_OS_LINUX
+    if constexpr (std::same_as<Context, coio::epoll_context>) {
+        // every read finds its byte buffered: only one completion in every nine goes through the queue
+        CHECK_LT(inlined_count, n / 4);
+    }
+#endif
+}
+
+TEST_CASE_TEMPLATE("pipe: a drain budget lets a read through a flood of ready continuations", Context, COIO_TEST_CONTEXTS) {
+    SUBCASE("by count") {
+        std::optional<Context> context;
+        if (not try_make_context(context)) return;
+        context->set_drain_budget(64);
+        CHECK_LT(read_latency_under_flood(*context), 2s);
+    }
+    SUBCASE("by time") {
+        std::optional<Context> context;
+        if (not try_make_context(context)) return;
+        context->set_drain_budget(0, 1ms);
+        CHECK_LT(read_latency_under_flood(*context), 2s);
+    }
+}
+
+TEST_CASE_TEMPLATE("pipe: timers with slack share a wakeup and never fire early", Context, COIO_TEST_CONTEXTS) {
+    std::optional<Context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    context->set_timer_slack(200ms);
+
+    std::chrono::steady_clock::time_point relaxed_at, tight_at, precise_at;
+    const auto start = std::chrono::steady_clock::now();
+    coio::this_thread::sync_wait(coio::when_all(
+        scheduler.schedule_after(10ms) | coio::then([&] { relaxed_at = std::chrono::steady_clock::now(); }),
+        scheduler.schedule_after(30ms, 0ms) | coio::then([&] { tight_at = std::chrono::steady_clock::now(); }),
+        coio::just() | coio::then([&] { context->run(); })
+    ));
+    CHECK_GE(tight_at - start, 30ms);
+    // the default slack let the earlier timer wait for the wakeup of the tight one
+    CHECK_GE(relaxed_at - start, 30ms);
+    CHECK_LT(relaxed_at - start, 200ms);
+
+    // without slack a timer isn't rounded up to the next millisecond
+    std::size_t late = 0;
+    for (int i = 0; i < 20; ++i) {
+        const auto deadline = std::chrono::steady_clock::now() + 300us;
+        coio::this_thread::sync_wait(coio::when_all(
+            scheduler.schedule_at(deadline, 0ns) | coio::then([&] { precise_at = std::chrono::steady_clock::now(); }),
+            coio::just() | coio::then([&] { context->run(); })
+        ));
+        CHECK_GE(precise_at, deadline);
+        late += precise_at - deadline >= 700us ? 1 : 0;
+    }
+    CHECK_LT(late, 10); // tolerate a loaded machine, not systematic millisecond rounding
+}
+
 TEST_CASE_TEMPLATE("pipe: zero-length reads and writes complete immediately with 0", Context, COIO_TEST_CONTEXTS) {
     std::optional<Context> context;
     if (not try_make_context(context)) return;
@@ -357,3 +562,36 @@ TEST_CASE_TEMPLATE("pipe: every make_pipe overload builds a working pair", Conte
         one_byte_through(reader, writer);
     }
 }
+
+#if COIO_OS_LINUX and COIO_HAS_IO_URING
+TEST_CASE("pipe: uring_context queues what doesn't fit a tiny ring and loses no operation") {
+    std::optional<coio::uring_context> context;
+    try {
+        context.emplace(coio::uring_context::options{.entries = 4});
+    }
+    catch (const std::system_error& e) {
+        MESSAGE("skipping: cannot construct context: " << e.what());
+        return;
+    }
+    auto scheduler = context->get_scheduler();
+    using scheduler_t = coio::uring_context::scheduler;
+
+    // many times more reads, and cancellations of reads, than the ring has entries, all started at once
+    constexpr std::size_t pipe_count = 64;
+    std::vector<decltype(coio::make_pipe(scheduler))> pipes;
+    for (std::size_t i = 0; i < pipe_count; ++i) pipes.push_back(coio::make_pipe(scheduler));
+
+    std::size_t received = 0;
+    std::size_t stopped = 0;
+    coio::async_scope scope;
+    for (std::size_t i = 0; i < pipe_count; ++i) {
+        auto& [reader, writer] = pipes[i];
+        if (i % 2 == 0) scope.spawn_on(scheduler, fed_read<scheduler_t>(reader, writer, scheduler, received));
+        else scope.spawn_on(scheduler, cancelled_read<scheduler_t>(reader, scheduler, stopped));
+    }
+    coio::this_thread::sync_wait(coio::when_all(scope.join(), drive(*context)));
+
+    CHECK_EQ(received, pipe_count / 2);
+    CHECK_EQ(stopped, pipe_count / 2);
+} // every operation completed: the context destructs without outstanding work
+#endif
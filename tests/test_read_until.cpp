@@ -2,6 +2,7 @@
 #include <cstddef>
 #include <cstring>
 #include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <system_error>
@@ -10,6 +11,7 @@
 #include <coio/core.h>
 #include <coio/asyncio/io.h>
 #include <coio/detail/error.h>
+#include <coio/utils/delimiter_matcher.h>
 #include <coio/utils/flat_buffer.h>
 
 namespace {
@@ -219,3 +221,63 @@ TEST_CASE("async_read_until with an empty string delimiter completes with 0") {
     CHECK_EQ(n, 0);
     CHECK_EQ(buffer.size(), 0);
 }
+
+TEST_CASE("read_until finds a delimiter far into a long buffer") {
+    // long enough for the vectorized search, with near misses on either side of each block
+    std::string head(300, 'x');
+    for (std::size_t i = 0; i < head.size(); i += 37) head[i] = '\r';
+    for (std::size_t i = 5; i < head.size(); i += 41) head.replace(i, 3, "\r\n\r");
+    scripted_device device{{head.substr(0, 150), head.substr(150) + "\r\n\r", "\nbody"}};
+    coio::flat_buffer buffer;
+    CHECK_EQ(coio::read_until(device, buffer, std::string_view{"\r\n\r\n"}), head.size() + 4);
+    CHECK_EQ(as_string(buffer.data()).substr(head.size()), "\r\n\r\nbody");
+}
+
+TEST_CASE("delimiter_matcher finds the earliest, then the longest, delimiter") {
+    const coio::delimiter_matcher matcher{"\n", "\r\n", "--"};
+    CHECK_EQ(matcher.size(), 3);
+    CHECK_EQ(matcher.max_length(), 2);
+
+    const std::string_view text = "ab-c\r\nd\n--";
+    auto found = matcher.find(coio::as_bytes(text));
+    REQUIRE(found.has_value());
+    CHECK_EQ(found->position, 4);
+    CHECK_EQ(found->size, 2);
+    CHECK_EQ(found->index, 1);
+
+    found = matcher.find(coio::as_bytes(text), 6);
+    REQUIRE(found.has_value());
+    CHECK_EQ(found->position, 7);
+    CHECK_EQ(found->index, 0);
+
+    CHECK_FALSE(matcher.find(coio::as_bytes(text.substr(0, 4))).has_value());
+    CHECK_THROWS_AS(coio::delimiter_matcher({"a", ""}), std::invalid_argument);
+}
+
+TEST_CASE("read_until with a delimiter_matcher stops at whichever delimiter comes first") {
+    const coio::delimiter_matcher matcher{"\r\n\r\n", "\n\n"};
+    SUBCASE("synchronous") {
+        scripted_device device{{"GET / HTTP/1.1\r\nHost: a\r\n\r", "\nbody"}};
+        coio::flat_buffer buffer;
+        CHECK_EQ(coio::read_until(device, buffer, matcher), 27);
+        CHECK_EQ(as_string(buffer.data()), "GET / HTTP/1.1\r\nHost: a\r\n\r\nbody");
+    }
+    SUBCASE("asynchronous") {
+        scripted_device device{{"GET / HTTP/1.0\nHost: a\n", "\nbody"}};
+        coio::flat_buffer buffer;
+        auto result = coio::this_thread::sync_wait(coio::async_read_until(device, buffer, matcher));
+        REQUIRE(result.has_value());
+        auto [ec, n] = result.value();
+        CHECK_FALSE(ec);
+        CHECK_EQ(n, 24);
+    }
+    SUBCASE("not found") {
+        repeating_device device{'a'};
+        coio::flat_buffer buffer{8};
+        auto result = coio::this_thread::sync_wait(coio::async_read_until(device, buffer, matcher));
+        REQUIRE(result.has_value());
+        auto [ec, n] = result.value();
+        CHECK_EQ(ec, coio::error::not_found);
+        CHECK_EQ(n, 0);
+    }
+}
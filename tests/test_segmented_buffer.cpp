@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <doctest/doctest.h>
+#include <coio/core.h>
+#include <coio/asyncio/io.h>
+#include <coio/detail/error.h>
+#include <coio/utils/delimiter_matcher.h>
+#include <coio/utils/segmented_buffer.h>
+
+namespace {
+    // Serves a string, at most `chunk` bytes per read_some.
+    class string_device {
+    public:
+        string_device(std::string content, std::size_t chunk) : content_(std::move(content)), chunk_(chunk) {}
+
+        auto read_some(std::span<std::byte> buffer) -> std::size_t {
+            if (buffer.empty()) return 0;
+            if (offset_ == content_.size()) {
+                throw std::system_error{coio::error::eof, "read_some"};
+            }
+            const std::size_t n = std::min({buffer.size(), chunk_, content_.size() - offset_});
+            std::memcpy(buffer.data(), content_.data() + offset_, n);
+            offset_ += n;
+            return n;
+        }
+
+        auto async_read_some(std::span<std::byte> buffer) {
+            return coio::just(read_some(buffer));
+        }
+
+    private:
+        std::string content_;
+        std::size_t chunk_;
+        std::size_t offset_ = 0;
+    };
+
+    // Like string_device, but also reads into a buffer sequence at once.
+    class scatter_device : public string_device {
+    public:
+        using string_device::string_device;
+        using string_device::async_read_some;
+
+        std::size_t scatter_reads = 0;
+
+        auto async_read_some(std::span<const std::span<std::byte>> buffers) {
+            ++scatter_reads;
+            std::size_t total = 0;
+            for (auto buffer : buffers) {
+                const std::size_t n = read_some(buffer);
+                total += n;
+                if (n < buffer.size()) break;
+            }
+            return coio::just(total);
+        }
+    };
+
+    static_assert(coio::segmented_dynamic_buffer<coio::segmented_buffer>);
+    static_assert(not coio::dynamic_buffer<coio::segmented_buffer>);
+    static_assert(coio::async_scatter_input_stream_device<scatter_device>);
+
+    auto to_string(const coio::segmented_buffer& buffer) -> std::string {
+        std::string result;
+        for (auto segment : buffer.data()) {
+            result.append(reinterpret_cast<const char*>(segment.data()), segment.size());
+        }
+        return result;
+    }
+
+    auto append(coio::segmented_buffer& buffer, std::string_view text) -> void {
+        std::size_t copied = 0;
+        for (auto target : buffer.prepare(text.size())) {
+            std::memcpy(target.data(), text.data() + copied, target.size());
+            copied += target.size();
+        }
+        buffer.commit(text.size());
+    }
+}
+
+TEST_CASE("segmented_buffer spreads its bytes over blocks without moving them") {
+    coio::segmented_buffer buffer{1024, 8};
+    CHECK_EQ(buffer.block_size(), 8);
+    CHECK(buffer.empty());
+    CHECK(buffer.data().empty());
+
+    append(buffer, "0123456789abcdefghij");
+    CHECK_EQ(buffer.size(), 20);
+    CHECK_EQ(buffer.data().size(), 3);
+    const std::byte* second_block = buffer.data()[1].data();
+
+    buffer.consume(5);
+    CHECK_EQ(to_string(buffer), "56789abcdefghij");
+    CHECK_EQ(buffer.data()[1].data(), second_block);
+
+    auto prepared = buffer.prepare(6); // the rest of the third block, then a fourth
+    CHECK_EQ(prepared.size(), 2);
+    CHECK_EQ(prepared[0].size(), 4);
+    CHECK_EQ(prepared[1].size(), 2);
+    buffer.commit(3);
+    CHECK_EQ(buffer.size(), 18);
+
+    CHECK_THROWS_AS((void) buffer.prepare(1024), std::length_error);
+}
+
+TEST_CASE("segmented_buffer keeps data() valid until it is modified") {
+    coio::segmented_buffer buffer{1024, 8};
+    append(buffer, "0123456789");
+    const auto spans = buffer.data();
+    CHECK_EQ(buffer.data().data(), spans.data()); // another call leaves the first result alone
+    CHECK_EQ(spans.size(), 2);
+
+    append(buffer, "ab"); // grows the last span within its block
+    CHECK_EQ(buffer.data().size(), 2);
+    CHECK_EQ(to_string(buffer), "0123456789ab");
+
+    buffer.consume(9);
+    CHECK_EQ(buffer.data().size(), 1);
+    CHECK_EQ(to_string(buffer), "9ab");
+    buffer.consume(3);
+    CHECK(buffer.data().empty());
+}
+
+TEST_CASE("segmented_buffer recycles the blocks it has consumed") {
+    coio::segmented_buffer buffer{std::size_t(-1), 16};
+    const std::string line = "0123456789";
+    append(buffer, line);
+    for (int i = 0; i < 100; ++i) {
+        append(buffer, line);
+        buffer.consume(line.size());
+        CHECK_LE(buffer.capacity(), 3 * 16); // 20 bytes span three blocks at most
+    }
+    CHECK_EQ(to_string(buffer), line);
+
+    buffer.consume(line.size());
+    buffer.shrink_to_fit();
+    CHECK_EQ(buffer.capacity(), 0);
+}
+
+TEST_CASE("read_until finds a delimiter running from one block into the next") {
+    SUBCASE("synchronous") {
+        string_device device{"GET / HTTP/1.1\r\nHost: a\r\n\r\nbody", 5};
+        coio::segmented_buffer buffer{std::size_t(-1), 13}; // "\r\n\r\n" ends at 27, across the second block boundary
+        CHECK_EQ(coio::read_until(device, buffer, std::string_view{"\r\n\r\n"}), 27);
+        CHECK(to_string(buffer).starts_with("GET / HTTP/1.1\r\nHost: a\r\n\r\n"));
+    }
+    SUBCASE("asynchronous, with a matcher") {
+        const coio::delimiter_matcher matcher{"\r\n\r\n", "\n\n"};
+        scatter_device device{"GET / HTTP/1.0\nHost: a\n\nbody", 64};
+        coio::segmented_buffer buffer{std::size_t(-1), 23}; // the "\n\n" straddles the first two blocks
+        auto result = coio::this_thread::sync_wait(coio::async_read_until(device, buffer, matcher));
+        REQUIRE(result.has_value());
+        auto [ec, n] = result.value();
+        CHECK_FALSE(ec);
+        CHECK_EQ(n, 24);
+        CHECK_EQ(to_string(buffer), "GET / HTTP/1.0\nHost: a\n\nbody");
+        CHECK_GT(device.scatter_reads, 0);
+    }
+    SUBCASE("not found") {
+        string_device device{std::string(64, 'a'), 64};
+        coio::segmented_buffer buffer{16, 4};
+        CHECK_THROWS_AS((void) coio::read_until(device, buffer, '\n'), std::system_error);
+        CHECK_EQ(buffer.size(), 16);
+    }
+}
+
+TEST_CASE("async_read fills a segmented_buffer") {
+    const std::string body(100, 'x');
+    SUBCASE("with scatter reads") {
+        scatter_device device{body, 1000};
+        coio::segmented_buffer buffer{std::size_t(-1), 32};
+        auto result = coio::this_thread::sync_wait(coio::async_read(device, buffer, body.size()));
+        REQUIRE(result.has_value());
+        auto [ec, n] = result.value();
+        CHECK_FALSE(ec);
+        CHECK_EQ(n, body.size());
+        CHECK_EQ(device.scatter_reads, 1);
+        CHECK_EQ(to_string(buffer), body);
+    }
+    SUBCASE("one block at a time") {
+        string_device device{body, 1000};
+        coio::segmented_buffer buffer{std::size_t(-1), 32};
+        auto result = coio::this_thread::sync_wait(coio::async_read(device, buffer, body.size()));
+        REQUIRE(result.has_value());
+        auto [ec, n] = result.value();
+        CHECK_FALSE(ec);
+        CHECK_EQ(n, body.size());
+        CHECK_EQ(to_string(buffer), body);
+    }
+}
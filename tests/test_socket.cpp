@@ -1,10 +1,16 @@
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <optional>
 #include <span>
+#include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <vector>
 #include <doctest/doctest.h>
 #include <coio/core.h>
@@ -15,6 +21,7 @@
 #include <coio/net/socket.h>
 #include <coio/net/tcp.h>
 #include <coio/net/udp.h>
+#include <coio/utils/scope_exit.h>
 
 #if COIO_OS_LINUX
 #include <coio/asyncio/epoll_context.h>
@@ -36,6 +43,11 @@ TYPE_TO_STRING(coio::uring_context);
 TYPE_TO_STRING(coio::iocp_context);
 #endif
 
+#if COIO_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #if COIO_OS_LINUX and COIO_HAS_IO_URING
 #define COIO_TEST_CONTEXTS coio::epoll_context, coio::uring_context
 #elif COIO_OS_LINUX
@@ -142,6 +154,90 @@ namespace {
         CHECK_EQ(n, src.size());
     }
 
+    template<typename Scheduler>
+    auto zero_copy_client(Scheduler scheduler, coio::endpoint server_endpoint, std::span<const std::byte> src) -> coio::task<> {
+        tcp_socket_t<Scheduler> socket{scheduler};
+        co_await socket.async_connect(server_endpoint);
+        std::size_t sent = 0;
+        while (sent < src.size()) {
+            const std::size_t n = co_await socket.async_send_zc(src.subspan(sent));
+            CHECK_GT(n, 0);
+            sent += n;
+        }
+        CHECK_EQ(sent, src.size());
+    }
+
+    // splits `bytes` into `count` pieces of uneven sizes, some of them empty
+    template<typename Byte>
+    auto split_unevenly(std::span<Byte> bytes, std::size_t count) -> std::vector<std::span<Byte>> {
+        std::vector<std::span<Byte>> pieces;
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i + 1 < count; ++i) {
+            const std::size_t n = std::min(bytes.size() - offset, (i % 5) * (bytes.size() / count) / 4);
+            pieces.push_back(bytes.subspan(offset, n));
+            offset += n;
+        }
+        pieces.push_back(bytes.subspan(offset));
+        return pieces;
+    }
+
+    template<typename Scheduler>
+    auto scatter_server(tcp_acceptor_t<Scheduler>& acceptor, std::span<std::byte> dest) -> coio::task<> {
+        auto peer = co_await acceptor.async_accept();
+        const auto pieces = split_unevenly(dest, 37);
+        auto [ec, n] = co_await coio::async_read(peer, std::span{pieces});
+        CHECK_FALSE(ec);
+        CHECK_EQ(n, dest.size());
+    }
+
+    template<typename Scheduler>
+    auto gather_client(Scheduler scheduler, coio::endpoint server_endpoint, std::span<const std::byte> src) -> coio::task<> {
+        tcp_socket_t<Scheduler> socket{scheduler};
+        co_await socket.async_connect(server_endpoint);
+        const auto pieces = split_unevenly(src, 23);
+        auto [ec, n] = co_await coio::async_write(socket, std::span{pieces});
+        CHECK_FALSE(ec);
+        CHECK_EQ(n, src.size());
+    }
+
+#if COIO_OS_LINUX
+    template<typename Scheduler>
+    auto sendfile_client(Scheduler scheduler, coio::endpoint server_endpoint, int file,
+                         std::size_t offset, std::size_t count, std::size_t file_size) -> coio::task<> {
+        tcp_socket_t<Scheduler> socket{scheduler};
+        co_await socket.async_connect(server_endpoint);
+        auto [ec, n] = co_await coio::async_sendfile(socket, file, offset, count);
+        CHECK_FALSE(ec);
+        CHECK_EQ(n, count);
+        auto [eof, none] = co_await coio::async_sendfile(socket, file, file_size, 1);
+        CHECK_EQ(eof, coio::error::eof);
+        CHECK_EQ(none, 0);
+    }
+#endif
+
+    // --- accept stream helpers -----------------------------------------------
+
+    template<typename Scheduler>
+    auto stream_accept_server(tcp_acceptor_t<Scheduler>& acceptor, std::size_t connections) -> coio::task<> {
+        auto stream = acceptor.async_accept_stream();
+        for (std::size_t i = 0; i < connections; ++i) {
+            auto peer = co_await stream.next();
+            char byte{};
+            const std::size_t n = co_await peer.async_read_some(coio::as_writable_bytes(std::span{&byte, 1}));
+            CHECK_EQ(n, 1);
+            CHECK_EQ(byte, '!');
+        }
+    } // ~stream disarms the accept request, so the context can run out of work
+
+    template<typename Scheduler>
+    auto one_byte_client(Scheduler scheduler, coio::endpoint server_endpoint) -> coio::task<> {
+        tcp_socket_t<Scheduler> socket{scheduler};
+        co_await socket.async_connect(server_endpoint);
+        auto [ec, n] = co_await coio::async_write(socket, coio::as_bytes(std::string_view{"!"}));
+        CHECK_FALSE(ec);
+        CHECK_EQ(n, 1);
+    }
+
     // --- shutdown/EOF helpers ------------------------------------------------
 
     template<typename Scheduler>
@@ -212,6 +308,62 @@ namespace {
         CHECK_EQ(n, payload.size());
     }
 
+    template<typename Scheduler>
+    auto batch_receiver(udp_socket_t<Scheduler>& socket, std::span<coio::datagram_receive_slot> slots) -> coio::task<> {
+        std::size_t received = 0;
+        while (received < slots.size()) {
+            const std::size_t n = co_await socket.async_receive_many(slots.subspan(received));
+            CHECK_GT(n, 0);
+            received += n;
+        }
+    }
+
+    template<typename Scheduler>
+    auto batch_sender(udp_socket_t<Scheduler>& socket, std::span<const coio::datagram_send_slot> slots) -> coio::task<> {
+        std::size_t sent = 0;
+        while (sent < slots.size()) {
+            const std::size_t n = co_await socket.async_send_many(slots.subspan(sent));
+            CHECK_GT(n, 0);
+            sent += n;
+        }
+    }
+
+    // a datagram can't be left half sent for the next call: one spread over more buffers than a single
+    // operation takes must fail instead of being truncated
+    template<typename Scheduler>
+    auto datagram_buffer_limit(udp_socket_t<Scheduler>& sender, udp_socket_t<Scheduler>& receiver) -> coio::task<> {
+        constexpr std::size_t count = 17;
+        std::array<std::byte, count> payload{};
+        std::array<std::byte, count> received{};
+        for (std::size_t i = 0; i < count; ++i) payload[i] = static_cast<std::byte>(i + 1);
+        std::vector<std::span<const std::byte>> out;
+        std::vector<std::span<std::byte>> in;
+        for (std::size_t i = 0; i < count; ++i) {
+            out.push_back(std::span{payload}.subspan(i, 1));
+            in.push_back(std::span{received}.subspan(i, 1));
+        }
+
+        try {
+            (void) co_await sender.async_send(std::span{out});
+            FAIL("expected std::errc::message_size for a datagram spread over 17 buffers");
+        }
+        catch (const std::system_error& e) {
+            CHECK_EQ(e.code(), std::errc::message_size);
+        }
+        try {
+            (void) co_await receiver.async_receive(std::span{in});
+            FAIL("expected std::errc::message_size for a datagram spread over 17 buffers");
+        }
+        catch (const std::system_error& e) {
+            CHECK_EQ(e.code(), std::errc::message_size);
+        }
+
+        // 16 still travel whole, and nothing of the failed send arrived ahead of them
+        CHECK_EQ(co_await sender.async_send(std::span{out}.first(16)), 16);
+        CHECK_EQ(co_await receiver.async_receive(std::span{in}.first(16)), 16);
+        CHECK(std::ranges::equal(std::span{received}.first(16), std::span{payload}.first(16)));
+    }
+
     // --- zero-length helpers -------------------------------------------------
 
     // asio parity: zero-length operations on datagram sockets are REAL — an empty send
@@ -385,6 +537,119 @@ TEST_CASE_TEMPLATE("socket: tcp large transfer loops over short reads/writes", C
     CHECK(received == payload);
 }
 
+TEST_CASE_TEMPLATE("socket: scatter/gather transfer resumes inside partially transferred buffers", Context, COIO_TEST_CONTEXTS) {
+    std::optional<Context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using scheduler_t = typename Context::scheduler;
+
+    tcp_acceptor_t<scheduler_t> acceptor{scheduler, coio::endpoint{coio::ipv4_address::loopback(), 0}};
+    const coio::endpoint server_endpoint = acceptor.local_endpoint();
+
+    constexpr std::size_t total = std::size_t{1} << 20; // 1 MiB, more than a socket buffer takes at once
+    std::vector<std::byte> payload(total);
+    for (std::size_t i = 0; i < total; ++i) {
+        payload[i] = static_cast<std::byte>((i * 17 + 3) & 0xff);
+    }
+    std::vector<std::byte> received(total);
+
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, scatter_server(acceptor, received)),
+        coio::starts_on(scheduler, gather_client(scheduler, server_endpoint, std::span<const std::byte>{payload})),
+        drive(*context)
+    ));
+
+    CHECK(received == payload);
+}
+
+#if COIO_OS_LINUX
+TEST_CASE_TEMPLATE("socket: sendfile transfers a file range", Context, COIO_TEST_CONTEXTS) {
+    std::optional<Context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using scheduler_t = typename Context::scheduler;
+
+    tcp_acceptor_t<scheduler_t> acceptor{scheduler, coio::endpoint{coio::ipv4_address::loopback(), 0}};
+    const coio::endpoint server_endpoint = acceptor.local_endpoint();
+
+    constexpr std::size_t file_size = (std::size_t{3} << 20) + 123; // several rounds through a splice pipe
+    std::vector<std::byte> contents(file_size);
+    for (std::size_t i = 0; i < file_size; ++i) {
+        contents[i] = static_cast<std::byte>((i * 29 + 11) & 0xff);
+    }
+    const auto path = std::filesystem::temp_directory_path()
+        / ("coio_test_sendfile_" + std::to_string(::getpid()) + "_" + std::to_string(server_endpoint.port()) + ".bin");
+    {
+        std::ofstream out{path, std::ios::binary};
+        out.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+    }
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    coio::scope_exit cleanup{[&]() noexcept {
+        if (file != -1) ::close(file);
+        std::error_code discard;
+        std::filesystem::remove(path, discard);
+    }};
+    REQUIRE_NE(file, -1);
+
+    constexpr std::size_t offset = 1000;
+    constexpr std::size_t count = file_size - 2 * offset;
+    std::vector<std::byte> received(count);
+
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, sink_server(acceptor, received)),
+        coio::starts_on(scheduler, sendfile_client(scheduler, server_endpoint, file, offset, count, file_size)),
+        drive(*context)
+    ));
+
+    CHECK(std::ranges::equal(received, std::span{contents}.subspan(offset, count)));
+}
+#endif
+
+TEST_CASE_TEMPLATE("socket: zero-copy send delivers the whole payload", Context, COIO_TEST_CONTEXTS) {
+    using scheduler_t = typename Context::scheduler;
+    if constexpr (requires (tcp_socket_t<scheduler_t>& socket, std::span<const std::byte> buffer) { socket.async_send_zc(buffer); }) {
+        std::optional<Context> context;
+        if (not try_make_context(context)) return;
+        auto scheduler = context->get_scheduler();
+
+        tcp_acceptor_t<scheduler_t> acceptor{scheduler, coio::endpoint{coio::ipv4_address::loopback(), 0}};
+        const coio::endpoint server_endpoint = acceptor.local_endpoint();
+
+        constexpr std::size_t total = std::size_t{1} << 20; // 1 MiB
+        std::vector<std::byte> payload(total);
+        for (std::size_t i = 0; i < total; ++i) {
+            payload[i] = static_cast<std::byte>((i * 13 + 5) & 0xff);
+        }
+        std::vector<std::byte> received(total);
+
+        coio::this_thread::sync_wait(coio::when_all(
+            coio::starts_on(scheduler, sink_server(acceptor, received)),
+            coio::starts_on(scheduler, zero_copy_client(scheduler, server_endpoint, payload)),
+            drive(*context)
+        ));
+
+        CHECK(received == payload);
+    }
+}
+
+TEST_CASE_TEMPLATE("socket: accept stream yields every connection", Context, COIO_TEST_CONTEXTS) {
+    std::optional<Context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+    using scheduler_t = typename Context::scheduler;
+
+    tcp_acceptor_t<scheduler_t> acceptor{scheduler, coio::endpoint{coio::ipv4_address::loopback(), 0}};
+    const coio::endpoint server_endpoint = acceptor.local_endpoint();
+
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, stream_accept_server(acceptor, 3)),
+        coio::starts_on(scheduler, one_byte_client(scheduler, server_endpoint)),
+        coio::starts_on(scheduler, one_byte_client(scheduler, server_endpoint)),
+        coio::starts_on(scheduler, one_byte_client(scheduler, server_endpoint)),
+        drive(*context)
+    ));
+}
+
 TEST_CASE_TEMPLATE("socket: orderly shutdown surfaces eof", Context, COIO_TEST_CONTEXTS) {
     std::optional<Context> context;
     if (not try_make_context(context)) return;
@@ -436,6 +701,72 @@ TEST_CASE_TEMPLATE("socket: udp datagram exchange reports the sender endpoint",
     ));
 }
 
+TEST_CASE_TEMPLATE("socket: batched udp receive/send moves every datagram in order", Context, COIO_TEST_CONTEXTS) {
+    using scheduler_t = typename Context::scheduler;
+    if constexpr (requires (udp_socket_t<scheduler_t>& socket, std::span<coio::datagram_receive_slot> slots) { socket.async_receive_many(slots); }) {
+        std::optional<Context> context;
+        if (not try_make_context(context)) return;
+        auto scheduler = context->get_scheduler();
+
+        udp_socket_t<scheduler_t> alice{scheduler, coio::udp::v4()};
+        alice.bind(coio::endpoint{coio::ipv4_address::loopback(), 0});
+        udp_socket_t<scheduler_t> bob{scheduler, coio::udp::v4()};
+        bob.bind(coio::endpoint{coio::ipv4_address::loopback(), 0});
+        const coio::endpoint alice_endpoint = alice.local_endpoint();
+        const coio::endpoint bob_endpoint = bob.local_endpoint();
+
+        // more datagrams than one batch holds, the last one larger than its slot
+        constexpr std::size_t count = 40;
+        constexpr std::size_t slot_size = 64;
+        std::vector<std::vector<std::byte>> payloads(count);
+        std::vector<coio::datagram_send_slot> send_slots;
+        for (std::size_t i = 0; i < count; ++i) {
+            payloads[i].resize(i + 1 == count ? slot_size + 10 : i % slot_size);
+            for (auto& b : payloads[i]) b = static_cast<std::byte>(i);
+            send_slots.push_back({payloads[i], bob_endpoint});
+        }
+        std::vector<std::vector<std::byte>> buffers(count, std::vector<std::byte>(slot_size));
+        std::vector<coio::datagram_receive_slot> receive_slots;
+        for (auto& buffer : buffers) receive_slots.push_back({.buffer = buffer});
+
+        coio::this_thread::sync_wait(coio::when_all(
+            coio::starts_on(scheduler, batch_receiver(bob, receive_slots)),
+            coio::starts_on(scheduler, batch_sender(alice, send_slots)),
+            drive(*context)
+        ));
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& slot = receive_slots[i];
+            CHECK_EQ(slot.peer, alice_endpoint);
+            const std::size_t expected = std::min(payloads[i].size(), slot_size);
+            CHECK_EQ(slot.size, expected);
+            CHECK_EQ(slot.truncated, payloads[i].size() > slot_size);
+            CHECK(std::ranges::equal(std::span{buffers[i]}.first(expected), std::span{payloads[i]}.first(expected)));
+        }
+    }
+}
+
+TEST_CASE_TEMPLATE("socket: udp scatter/gather rejects more buffers than one datagram operation takes", Context, COIO_TEST_CONTEXTS) {
+    using scheduler_t = typename Context::scheduler;
+    if constexpr (requires (udp_socket_t<scheduler_t>& socket, std::span<const std::span<std::byte>> buffers) { socket.async_receive(buffers); }) {
+        std::optional<Context> context;
+        if (not try_make_context(context)) return;
+        auto scheduler = context->get_scheduler();
+
+        udp_socket_t<scheduler_t> alice{scheduler, coio::udp::v4()};
+        alice.bind(coio::endpoint{coio::ipv4_address::loopback(), 0});
+        udp_socket_t<scheduler_t> bob{scheduler, coio::udp::v4()};
+        bob.bind(coio::endpoint{coio::ipv4_address::loopback(), 0});
+        alice.connect(bob.local_endpoint());
+        bob.connect(alice.local_endpoint());
+
+        coio::this_thread::sync_wait(coio::when_all(
+            coio::starts_on(scheduler, datagram_buffer_limit(alice, bob)),
+            drive(*context)
+        ));
+    }
+}
+
 TEST_CASE_TEMPLATE("socket: zero-length ops are no-ops on streams but real on datagram sockets", Context, COIO_TEST_CONTEXTS) {
     std::optional<Context> context;
     if (not try_make_context(context)) return;
@@ -644,3 +975,212 @@ TEST_CASE_TEMPLATE("socket: async_resolve performs the lookup on the scheduler",
     CHECK_GE(count, 1);
     CHECK(gai_failure);
 }
+
+#if COIO_OS_LINUX and COIO_HAS_IO_URING
+namespace {
+    auto buffered_receive_server(tcp_acceptor_t<coio::uring_context::scheduler>& acceptor, std::string_view expect) -> coio::task<> {
+        auto peer = co_await acceptor.async_accept();
+        std::string received;
+        while (received.size() < expect.size()) {
+            coio::uring_context::buffer_lease lease = co_await peer.async_receive_buffered();
+            CHECK_FALSE(lease.empty());
+            CHECK_LE(lease.size(), 64);
+            received.append(reinterpret_cast<const char*>(lease.data().data()), lease.size());
+        } // ~lease gives the buffer back to the ring, so two buffers are enough for any payload
+        CHECK_EQ(received, expect);
+        try {
+            (void) co_await peer.async_receive_buffered();
+            FAIL("expected coio::error::eof after the client closed the connection");
+        }
+        catch (const std::system_error& e) {
+            CHECK_EQ(e.code(), coio::error::eof);
+        }
+    }
+
+    auto stream_receive_server(tcp_acceptor_t<coio::uring_context::scheduler>& acceptor, std::string_view expect) -> coio::task<> {
+        auto peer = co_await acceptor.async_accept();
+        auto stream = peer.async_receive_stream();
+        std::string received;
+        try {
+            while (received.size() < expect.size()) {
+                coio::uring_context::buffer_lease lease = co_await stream.next();
+                CHECK_FALSE(lease.empty());
+                received.append(reinterpret_cast<const char*>(lease.data().data()), lease.size());
+            }
+            CHECK_EQ(received, expect);
+            (void) co_await stream.next();
+            FAIL("expected coio::error::eof after the client closed the connection");
+        }
+        catch (const std::system_error& e) {
+            if (received.empty() and e.code() == std::errc::invalid_argument) {
+                MESSAGE("skipping: multishot receive needs Linux 6.0 or newer");
+                co_return;
+            }
+            CHECK_EQ(e.code(), coio::error::eof);
+        }
+    }
+
+    // holds every lease of the ring before giving them back, so the multishot receive runs out of buffers
+    auto starving_stream_receive_server(tcp_acceptor_t<coio::uring_context::scheduler>& acceptor, std::string_view expect, std::size_t ring_size) -> coio::task<> {
+        auto peer = co_await acceptor.async_accept();
+        auto stream = peer.async_receive_stream();
+        std::string received;
+        std::vector<coio::uring_context::buffer_lease> held;
+        try {
+            while (received.size() < expect.size()) {
+                held.push_back(co_await stream.next());
+                received.append(reinterpret_cast<const char*>(held.back().data().data()), held.back().size());
+                if (held.size() == ring_size) held.clear();
+            }
+            CHECK_EQ(received, expect);
+        }
+        catch (const std::system_error& e) {
+            if (received.empty() and e.code() == std::errc::invalid_argument) {
+                MESSAGE("skipping: multishot receive needs Linux 6.0 or newer");
+                co_return;
+            }
+            FAIL("the receive stream ended early: " << e.what());
+        }
+    }
+
+    auto unregistered_buffered_receive(coio::uring_context::scheduler scheduler) -> coio::task<> {
+        tcp_socket_t<coio::uring_context::scheduler> socket{scheduler, coio::tcp::v4()};
+        try {
+            (void) co_await socket.async_receive_buffered();
+            FAIL("expected std::errc::operation_not_supported");
+        }
+        catch (const std::system_error& e) {
+            CHECK_EQ(e.code(), std::errc::operation_not_supported);
+        }
+    }
+
+    auto buffered_send_client(coio::uring_context::scheduler scheduler, coio::endpoint server_endpoint, std::string_view payload) -> coio::task<> {
+        tcp_socket_t<coio::uring_context::scheduler> socket{scheduler};
+        co_await socket.async_connect(server_endpoint);
+        auto [ec, n] = co_await coio::async_write(socket, coio::as_bytes(payload));
+        CHECK_FALSE(ec);
+        CHECK_EQ(n, payload.size());
+    }
+
+    auto read_all_server(tcp_acceptor_t<coio::uring_context::scheduler>& acceptor, std::string_view expect) -> coio::task<> {
+        auto peer = co_await acceptor.async_accept();
+        std::string received(expect.size(), '\0');
+        auto [ec, n] = co_await coio::async_read(peer, coio::as_writable_bytes(received));
+        CHECK_FALSE(ec);
+        CHECK_EQ(n, expect.size());
+        CHECK_EQ(received, expect);
+    }
+
+    // leaves the context for a foreign thread, then comes back: the way back has to wake the
+    // context without touching its ring
+    auto foreign_thread_round_trip(coio::uring_context& context, coio::execution::run_loop& loop) -> coio::task<> {
+        const auto owner = std::this_thread::get_id();
+        coio::work_guard guard{context};
+        co_await coio::execution::schedule(loop.get_scheduler());
+        CHECK_NE(std::this_thread::get_id(), owner);
+        co_await coio::execution::schedule(context.get_scheduler());
+        CHECK_EQ(std::this_thread::get_id(), owner);
+    }
+}
+
+TEST_CASE("socket: uring_context buffered receive leases buffers from the provided-buffer ring") {
+    std::optional<coio::uring_context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+
+    tcp_acceptor_t<coio::uring_context::scheduler> acceptor{scheduler, coio::endpoint{coio::ipv4_address::loopback(), 0}};
+
+    // without a registered ring the operation is reported as unsupported
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, unregistered_buffered_receive(scheduler)),
+        drive(*context)
+    ));
+
+    try {
+        context->register_buffer_ring(64, 2);
+    }
+    catch (const std::system_error& e) {
+        MESSAGE("skipping: cannot register a provided-buffer ring: " << e.what());
+        return;
+    }
+    CHECK_THROWS_AS(context->register_buffer_ring(64, 2), std::system_error);
+
+    static const std::string payload(1000, 'z');
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, buffered_receive_server(acceptor, payload)),
+        coio::starts_on(scheduler, buffered_send_client(scheduler, acceptor.local_endpoint(), payload)),
+        drive(*context)
+    ));
+}
+
+TEST_CASE("socket: uring_context receive stream keeps one multishot receive armed") {
+    std::optional<coio::uring_context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+
+    tcp_acceptor_t<coio::uring_context::scheduler> acceptor{scheduler, coio::endpoint{coio::ipv4_address::loopback(), 0}};
+    try {
+        context->register_buffer_ring(64, 4);
+    }
+    catch (const std::system_error& e) {
+        MESSAGE("skipping: cannot register a provided-buffer ring: " << e.what());
+        return;
+    }
+
+    static const std::string payload(1000, 'q');
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, stream_receive_server(acceptor, payload)),
+        coio::starts_on(scheduler, buffered_send_client(scheduler, acceptor.local_endpoint(), payload)),
+        drive(*context)
+    ));
+}
+
+TEST_CASE("socket: uring_context receive stream outlives an exhausted buffer ring") {
+    std::optional<coio::uring_context> context;
+    if (not try_make_context(context)) return;
+    auto scheduler = context->get_scheduler();
+
+    tcp_acceptor_t<coio::uring_context::scheduler> acceptor{scheduler, coio::endpoint{coio::ipv4_address::loopback(), 0}};
+    try {
+        context->register_buffer_ring(64, 2);
+    }
+    catch (const std::system_error& e) {
+        MESSAGE("skipping: cannot register a provided-buffer ring: " << e.what());
+        return;
+    }
+
+    static const std::string payload(1000, 'n');
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, starving_stream_receive_server(acceptor, payload, 2)),
+        coio::starts_on(scheduler, buffered_send_client(scheduler, acceptor.local_endpoint(), payload)),
+        drive(*context)
+    ));
+}
+
+TEST_CASE("socket: uring_context single-issuer ring serves I/O and foreign wakeups") {
+    std::optional<coio::uring_context> context;
+    try {
+        context.emplace(coio::uring_context::options{.entries = 64, .single_issuer = true});
+    }
+    catch (const std::system_error& e) {
+        MESSAGE("skipping: cannot construct a single-issuer ring (Linux 6.0 or newer): " << e.what());
+        return;
+    }
+    auto scheduler = context->get_scheduler();
+
+    coio::execution::run_loop loop;
+    std::jthread foreign{[&] {
+        loop.run();
+    }};
+
+    tcp_acceptor_t<coio::uring_context::scheduler> acceptor{scheduler, coio::endpoint{coio::ipv4_address::loopback(), 0}};
+    static const std::string payload(1000, 's');
+    coio::this_thread::sync_wait(coio::when_all(
+        coio::starts_on(scheduler, read_all_server(acceptor, payload)),
+        coio::starts_on(scheduler, buffered_send_client(scheduler, acceptor.local_endpoint(), payload)),
+        coio::starts_on(scheduler, foreign_thread_round_trip(*context, loop)),
+        drive(*context)
+    ));
+    loop.finish();
+}
+#endif
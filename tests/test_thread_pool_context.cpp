@@ -0,0 +1,96 @@
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <doctest/doctest.h>
+#include <coio/core.h>
+#include <coio/thread_pool_context.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+    using pool_scheduler = coio::thread_pool_context::scheduler;
+
+    struct thread_log {
+        auto record() -> void {
+            std::scoped_lock _{mtx};
+            ids.insert(std::this_thread::get_id());
+            ++count;
+        }
+
+        std::mutex mtx;
+        std::set<std::thread::id> ids;
+        std::size_t count = 0;
+    };
+
+    auto busy_child(thread_log& log) -> coio::thread_pool_context::task<> {
+        std::this_thread::sleep_for(2ms);
+        log.record();
+        co_return;
+    }
+
+    // every child is scheduled from the parent's worker and lands in its deque:
+    // the other workers only get to run them by stealing
+    auto fan_out(pool_scheduler scheduler, thread_log& log, std::size_t n) -> coio::thread_pool_context::task<> {
+        coio::async_scope scope;
+        for (std::size_t i = 0; i < n; ++i) {
+            scope.spawn(coio::starts_on(scheduler, busy_child(log)));
+        }
+        co_await scope.join();
+    }
+
+    auto hop_through(coio::time_loop::scheduler io_scheduler, std::thread::id& before, std::thread::id& after) -> coio::thread_pool_context::task<> {
+        before = std::this_thread::get_id();
+        co_await io_scheduler.schedule_after(1ms); // completes on the loop's thread, resumes on the pool
+        after = std::this_thread::get_id();
+    }
+}
+
+TEST_CASE("thread_pool_context: idle workers steal from a busy worker's deque") {
+    coio::thread_pool_context pool{4};
+    REQUIRE_EQ(pool.thread_count(), 4);
+    auto scheduler = pool.get_scheduler();
+
+    thread_log log;
+    constexpr std::size_t n = 32;
+    coio::this_thread::sync_wait(coio::starts_on(scheduler, fan_out(scheduler, log, n)));
+
+    CHECK_EQ(log.count, n);
+    CHECK_FALSE(log.ids.contains(std::this_thread::get_id()));
+    CHECK_GT(log.ids.size(), 1);
+}
+
+TEST_CASE("thread_pool_context: schedule_after completes on a worker after the deadline") {
+    coio::thread_pool_context pool{2};
+    auto scheduler = pool.get_scheduler();
+
+    std::thread::id completed_on;
+    const auto start = std::chrono::steady_clock::now();
+    coio::this_thread::sync_wait(scheduler.schedule_after(20ms) | coio::then([&] { completed_on = std::this_thread::get_id(); }));
+
+    CHECK_GE(std::chrono::steady_clock::now() - start, 20ms);
+    CHECK_NE(completed_on, std::thread::id{});
+    CHECK_NE(completed_on, std::this_thread::get_id());
+}
+
+TEST_CASE("thread_pool_context: a task hands off to another context and comes back") {
+    coio::thread_pool_context pool{2};
+    coio::time_loop loop;
+    std::optional<coio::work_guard<coio::time_loop>> guard{std::in_place, loop};
+    std::thread::id loop_id;
+    std::jthread loop_thread{[&] {
+        loop_id = std::this_thread::get_id();
+        loop.run();
+    }};
+
+    std::thread::id before, after;
+    coio::this_thread::sync_wait(coio::starts_on(pool.get_scheduler(), hop_through(loop.get_scheduler(), before, after)));
+    guard.reset();
+    loop_thread.join();
+
+    CHECK_NE(before, std::this_thread::get_id());
+    CHECK_NE(after, std::this_thread::get_id());
+    CHECK_NE(after, loop_id);
+}
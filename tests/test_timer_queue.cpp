@@ -18,11 +18,21 @@ namespace {
     struct test_timer {
         time_point deadline;
         coio::detail::timer_heap_links<test_timer> links;
+        coio::detail::timer_wheel_links<test_timer> wheel_links;
+        time_point not_before{}; // for the slack-aware queue
         test_timer* next = nullptr; // for coio::detail::intrusive_list
     };
 
     using test_queue = coio::detail::timer_queue<test_timer, &test_timer::deadline, &test_timer::links>;
 
+    using test_wheel_queue = coio::detail::timer_queue<
+        test_timer, &test_timer::deadline, &test_timer::links, &test_timer::wheel_links
+    >;
+
+    using test_slack_queue = coio::detail::timer_queue<
+        test_timer, &test_timer::deadline, &test_timer::links, nullptr, &test_timer::not_before
+    >;
+
     auto make_ready_list() -> coio::detail::intrusive_list<test_timer> {
         return coio::detail::intrusive_list<test_timer>{&test_timer::next};
     }
@@ -332,3 +342,127 @@ TEST_CASE("timer_queue concurrent add and remove of future timers leaves the que
     CHECK_EQ(successful_removes.load(), total);
     CHECK_FALSE(queue.earliest().has_value());
 }
+
+TEST_CASE("timer_queue with a timing wheel keeps far timers out of the heap and fires them in order") {
+    const auto base = std::chrono::steady_clock::now();
+    test_wheel_queue queue;
+    queue.set_tick(1ms);
+
+    test_timer expired{.deadline = base - 1s};
+    test_timer soon{.deadline = base + 30ms};
+    test_timer later{.deadline = base + 80ms};
+    test_timer far{.deadline = base + 2h};   // beyond the first level
+    test_timer cancelled{.deadline = base + 50ms};
+
+    CHECK(queue.add(expired)); // due within the current tick: goes to the heap
+    CHECK_FALSE(queue.add(soon));
+    CHECK_FALSE(queue.add(later));
+    CHECK_FALSE(queue.add(far));
+    CHECK_FALSE(queue.add(cancelled));
+    CHECK(queue.remove(cancelled));
+    CHECK_FALSE(queue.remove(cancelled));
+
+    auto ready = make_ready_list();
+    queue.take_ready_timers(ready);
+    CHECK(pop_all(ready) == std::vector<test_timer*>{&expired});
+
+    // the wheel only knows ticks: the reported wakeup may be early, never late
+    const auto earliest = queue.earliest();
+    REQUIRE(earliest.has_value());
+    CHECK_LE(*earliest, soon.deadline);
+
+    std::vector<test_timer*> fired;
+    while (std::chrono::steady_clock::now() < later.deadline + 5ms) {
+        queue.take_ready_timers(ready);
+        for (test_timer* node : pop_all(ready)) {
+            CHECK_GE(std::chrono::steady_clock::now(), node->deadline); // never before the exact deadline
+            fired.push_back(node);
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    CHECK(fired == std::vector<test_timer*>{&soon, &later});
+
+    CHECK(queue.remove(far));
+    CHECK_FALSE(queue.earliest().has_value());
+}
+
+TEST_CASE("timer_queue set_tick moves pending timers between the heap and the wheel") {
+    const auto base = std::chrono::steady_clock::now();
+    test_wheel_queue queue;
+
+    std::vector<test_timer> nodes(64);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].deadline = base + 1min + std::chrono::seconds{i * 37 % 64};
+        queue.add(nodes[i]);
+    }
+    const auto minimum = queue.earliest();
+
+    queue.set_tick(10ms);
+    REQUIRE(queue.earliest().has_value());
+    CHECK_LE(*queue.earliest(), *minimum);
+    for (std::size_t i = 0; i < nodes.size(); i += 2) CHECK(queue.remove(nodes[i]));
+
+    queue.set_tick({}); // back to the heap only: `earliest` is exact again
+    time_point expected = time_point::max();
+    for (std::size_t i = 1; i < nodes.size(); i += 2) expected = std::min(expected, nodes[i].deadline);
+    CHECK_EQ(queue.earliest(), expected);
+    for (std::size_t i = 1; i < nodes.size(); i += 2) CHECK(queue.remove(nodes[i]));
+    CHECK_FALSE(queue.earliest().has_value());
+}
+
+TEST_CASE("timer_queue with a timing wheel fires every expired timer exactly once") {
+    constexpr std::size_t node_count = 512;
+    std::mt19937 rng{20261016u};
+
+    const auto base = std::chrono::steady_clock::now();
+    test_wheel_queue queue;
+    queue.set_tick(100us);
+
+    std::vector<test_timer> nodes(node_count);
+    std::uniform_int_distribution<int> deadline_dist{0, 40'000}; // up to 40ms: spans two wheel levels
+    for (test_timer& node : nodes) {
+        node.deadline = base + std::chrono::microseconds{deadline_dist(rng)};
+        queue.add(node);
+    }
+
+    std::vector<int> pop_counts(node_count, 0);
+    std::size_t collected = 0;
+    auto ready = make_ready_list();
+    while (collected < node_count) {
+        queue.take_ready_timers(ready);
+        while (test_timer* node = ready.pop_front()) {
+            CHECK_GE(std::chrono::steady_clock::now(), node->deadline);
+            ++pop_counts[static_cast<std::size_t>(node - nodes.data())];
+            ++collected;
+        }
+        std::this_thread::sleep_for(200us);
+        REQUIRE_LT(std::chrono::steady_clock::now(), base + 10s);
+    }
+    CHECK(std::all_of(pop_counts.begin(), pop_counts.end(), [](int count) { return count == 1; }));
+    CHECK_FALSE(queue.earliest().has_value());
+}
+
+TEST_CASE("timer_queue with slack wakes for the tightest timer and takes every timer already due") {
+    const auto base = std::chrono::steady_clock::now();
+    test_slack_queue queue;
+
+    // `deadline` is the latest each may fire, `not_before` the earliest
+    test_timer relaxed{.deadline = base + 1h, .not_before = base - 1s};     // due, but may wait
+    test_timer tight{.deadline = base - 2s, .not_before = base - 2s};       // no slack, overdue
+    test_timer pending{.deadline = base + 2h, .not_before = base + 30min};  // not due yet
+    test_timer blocked{.deadline = base + 3h, .not_before = base - 1s};     // due, behind `pending`
+
+    for (test_timer* timer : {&relaxed, &pending, &tight, &blocked}) queue.add(*timer);
+    CHECK_EQ(queue.earliest(), tight.deadline); // the wakeup is the first timer out of slack
+
+    auto ready = make_ready_list();
+    queue.take_ready_timers(ready);
+    // taken in order of their latest time, up to the first one that isn't due yet
+    CHECK(pop_all(ready) == std::vector<test_timer*>{&tight, &relaxed});
+    CHECK_EQ(queue.earliest(), pending.deadline);
+
+    CHECK(queue.remove(pending));
+    queue.take_ready_timers(ready);
+    CHECK(pop_all(ready) == std::vector<test_timer*>{&blocked});
+    CHECK_FALSE(queue.earliest().has_value());
+}